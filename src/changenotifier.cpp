@@ -0,0 +1,160 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "changenotifier.h"
+#include "observer.h"
+#include "borrower.h"
+
+using Tellico::ChangeNotifier;
+
+ChangeNotifier* ChangeNotifier::s_self = nullptr;
+
+ChangeNotifier::ChangeNotifier() {
+  if(!s_self) {
+    s_self = this;
+  }
+}
+
+ChangeNotifier::~ChangeNotifier() {
+  if(s_self == this) {
+    s_self = nullptr;
+  }
+}
+
+void ChangeNotifier::addObserver(Tellico::Observer* obs) {
+  m_observers.append(obs);
+}
+
+void ChangeNotifier::removeObserver(Tellico::Observer* obs) {
+  m_observers.removeAll(obs);
+}
+
+void ChangeNotifier::addedField(Tellico::Data::CollPtr coll_, Tellico::Data::FieldPtr field_) {
+  foreach(Observer* obs, m_observers) {
+    obs->addField(coll_, field_);
+  }
+}
+
+void ChangeNotifier::modifiedField(Tellico::Data::CollPtr coll_, Tellico::Data::FieldPtr oldField_, Tellico::Data::FieldPtr newField_) {
+  foreach(Observer* obs, m_observers) {
+    obs->modifyField(coll_, oldField_, newField_);
+  }
+}
+
+void ChangeNotifier::removedField(Tellico::Data::CollPtr coll_, Tellico::Data::FieldPtr field_) {
+  foreach(Observer* obs, m_observers) {
+    obs->removeField(coll_, field_);
+  }
+}
+
+void ChangeNotifier::reorderedFields(Tellico::Data::CollPtr coll_) {
+  foreach(Observer* obs, m_observers) {
+    obs->reorderFields(coll_);
+  }
+}
+
+void ChangeNotifier::addedEntries(Tellico::Data::EntryList entries_) {
+  if(m_transaction.isOpen()) {
+    m_transaction.addEntries(entries_);
+    return;
+  }
+  foreach(Observer* obs, m_observers) {
+    obs->addEntries(entries_);
+  }
+}
+
+void ChangeNotifier::modifiedEntries(Tellico::Data::EntryList entries_) {
+  if(m_transaction.isOpen()) {
+    m_transaction.modifyEntries(entries_);
+    return;
+  }
+  foreach(Observer* obs, m_observers) {
+    obs->modifyEntries(entries_);
+  }
+}
+
+void ChangeNotifier::removedEntries(Tellico::Data::EntryList entries_) {
+  if(m_transaction.isOpen()) {
+    m_transaction.removeEntries(entries_);
+    return;
+  }
+  foreach(Observer* obs, m_observers) {
+    obs->removeEntries(entries_);
+  }
+}
+
+void ChangeNotifier::beginTransaction(Tellico::Data::CollPtr coll_) {
+  m_transaction.begin(coll_);
+}
+
+void ChangeNotifier::commitTransaction() {
+  if(!m_transaction.commit()) {
+    return;
+  }
+  const Data::EntryList removed = m_transaction.takeRemoved();
+  const Data::EntryList added = m_transaction.takeAdded();
+  const Data::EntryList modified = m_transaction.takeModified();
+
+  if(!removed.isEmpty()) {
+    removedEntries(removed);
+  }
+  if(!added.isEmpty()) {
+    addedEntries(added);
+  }
+  if(!modified.isEmpty()) {
+    modifiedEntries(modified);
+  }
+}
+
+void ChangeNotifier::addedBorrower(Tellico::Data::BorrowerPtr borrower_) {
+  foreach(Observer* obs, m_observers) {
+    obs->addBorrower(borrower_);
+  }
+}
+
+void ChangeNotifier::modifiedBorrower(Tellico::Data::BorrowerPtr borrower_) {
+  foreach(Observer* obs, m_observers) {
+    if(borrower_->isEmpty()) {
+      obs->removeBorrower(borrower_);
+    } else {
+      obs->modifyBorrower(borrower_);
+    }
+  }
+}
+
+void ChangeNotifier::addedFilter(Tellico::FilterPtr filter_) {
+  foreach(Observer* obs, m_observers) {
+    obs->addFilter(filter_);
+  }
+}
+
+void ChangeNotifier::removedFilter(Tellico::FilterPtr filter_) {
+  foreach(Observer* obs, m_observers) {
+    obs->removeFilter(filter_);
+  }
+}
+
+void ChangeNotifier::checkIn(const Tellico::Data::EntryList& entries_) {
+  Q_UNUSED(entries_);
+}
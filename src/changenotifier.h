@@ -0,0 +1,95 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TELLICO_CHANGENOTIFIER_H
+#define TELLICO_CHANGENOTIFIER_H
+
+#include "datavectors.h"
+#include "entrytransaction.h"
+
+#include <QList>
+
+namespace Tellico {
+  class Observer;
+
+/**
+ * The ChangeNotifier tells the observers about every change the undo commands make. While a
+ * transaction is open, the entry changes are held back and sent once it is committed.
+ *
+ * The Controller is the notifier in the application, and it updates the rest of the main
+ * window along with the observers. Anything else only gets the observers notified.
+ *
+ * @author Robby Stephenson
+ */
+class ChangeNotifier {
+public:
+  ChangeNotifier();
+  virtual ~ChangeNotifier();
+
+  static ChangeNotifier* self() { return s_self; }
+
+  void    addObserver(Observer* obs);
+  void removeObserver(Observer* obs);
+
+  virtual void addedField(Data::CollPtr coll, Data::FieldPtr field);
+  virtual void modifiedField(Data::CollPtr coll, Data::FieldPtr oldField, Data::FieldPtr newField);
+  virtual void removedField(Data::CollPtr coll, Data::FieldPtr field);
+  virtual void reorderedFields(Data::CollPtr coll);
+
+  virtual void addedEntries(Data::EntryList entries);
+  virtual void modifiedEntries(Data::EntryList entries);
+  virtual void removedEntries(Data::EntryList entries);
+  /**
+   * Entry notifications are held back until the outermost transaction is committed.
+   * Then each entry is reported only once, as added, modified, or removed. Any open
+   * transaction is dropped when the collection is added or deleted.
+   */
+  void beginTransaction(Data::CollPtr coll);
+  void commitTransaction();
+
+  virtual void addedBorrower(Data::BorrowerPtr borrower);
+  virtual void modifiedBorrower(Data::BorrowerPtr borrower);
+
+  virtual void addedFilter(FilterPtr filter);
+  virtual void removedFilter(FilterPtr filter);
+
+  /**
+   * Checks in the loans for entries whose loaned field was cleared. Only the Controller
+   * is able to do that.
+   */
+  virtual void checkIn(const Data::EntryList& entries);
+
+protected:
+  typedef QList<Tellico::Observer*> ObserverList;
+  ObserverList m_observers;
+  EntryTransaction m_transaction;
+
+private:
+  static ChangeNotifier* s_self;
+
+  Q_DISABLE_COPY(ChangeNotifier)
+};
+
+} // end namespace
+#endif
@@ -27,6 +27,7 @@
 #include "entry.h"
 #include "entrygroup.h"
 #include "derivedvalue.h"
+#include "readonlycollection.h"
 #include "fieldformat.h"
 #include "utils/string_utils.h"
 #include "utils/stringset.h"
@@ -36,19 +37,104 @@
 #include <KLocalizedString>
 
 #include <QDate>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QTimer>
+#include <QtConcurrent>
 
 using namespace Tellico;
 using Tellico::Data::Collection;
 
+namespace {
+  // smaller collections are grouped right away
+  static const int GROUP_BUILD_MIN_ENTRIES = 1000;
+  static const int GROUP_BUILD_CHUNK_SIZE = 500;
+
+  // the group names for a consecutive run of entries in the snapshot
+  struct GroupChunk {
+    int begin;
+    QList<QStringList> groupNames;
+  };
+
+  // the empty group is only returned if the entry has an empty list for every people field
+  QStringList peopleGroupNames(const QList<QStringList>& fieldGroups_) {
+    bool allEmpty = true;
+    Tellico::StringSet values;
+    foreach(const QStringList& groups, fieldGroups_) {
+      if(allEmpty && (groups.count() != 1 || !groups.at(0).isEmpty())) {
+        allEmpty = false;
+      }
+      values.add(groups);
+    }
+    if(!allEmpty) {
+      // we don't want the empty string
+      values.remove(QString());
+    }
+    return values.values();
+  }
+
+  // runs on a worker thread, so only the read-only snapshot is used
+  void buildGroupChunks(QPromise<GroupChunk>& promise_, const Tellico::Data::ReadOnlyCollection& snapshot_,
+                        const QStringList& fieldNames_, bool isPeople_) {
+    Tellico::Data::FieldList fields;
+    foreach(const QString& fieldName, fieldNames_) {
+      fields << snapshot_.fieldByName(fieldName);
+    }
+    GroupChunk chunk;
+    chunk.begin = 0;
+    const QList<Tellico::Data::ReadOnlyEntry>& entries = snapshot_.entries();
+    for(int i = 0; i < entries.count(); ++i) {
+      if(promise_.isCanceled()) {
+        return;
+      }
+      const Tellico::Data::ReadOnlyEntry& entry = entries.at(i);
+      QList<QStringList> fieldGroups;
+      foreach(Tellico::Data::FieldPtr field, fields) {
+        // tables use the raw value, the same as Entry::groupNamesByFieldName()
+        if(field->type() == Tellico::Data::Field::Table) {
+          fieldGroups << Tellico::Data::Entry::groupNames(field, snapshot_.field(entry, field), QString());
+        } else {
+          fieldGroups << Tellico::Data::Entry::groupNames(field, QString(), snapshot_.formattedField(entry, field));
+        }
+      }
+      chunk.groupNames << (isPeople_ ? peopleGroupNames(fieldGroups) : fieldGroups.first());
+      if(chunk.groupNames.count() == GROUP_BUILD_CHUNK_SIZE) {
+        promise_.addResult(chunk);
+        chunk.begin = i + 1;
+        chunk.groupNames.clear();
+      }
+    }
+    if(!chunk.groupNames.isEmpty()) {
+      promise_.addResult(chunk);
+    }
+  }
+}
+
+// a group dict being built in the background from a read-only snapshot. Only raw entry pointers
+// are kept, along with their ids, so removed entries can be recognized when the results come back
+class Collection::GroupDictBuild {
+public:
+  QList<QPair<Entry*, Data::ID>> entries;
+  // entries whose groups were updated directly since the snapshot was taken
+  QSet<Entry*> skipped;
+  QFutureWatcher<GroupChunk> watcher;
+  QElapsedTimer timer;
+};
+
 const QString Collection::s_peopleGroupName = QStringLiteral("_people");
 
 Collection::Collection(const QString& title_)
-    : QObject(), QSharedData(), m_nextEntryId(1), m_title(title_), m_trackGroups(false) {
+    : QObject(), QSharedData(), m_nextEntryId(1), m_title(title_), m_fieldValuesGeneration(0),
+      m_transactionDepth(0), m_allFieldsDirty(false), m_trackGroups(false),
+      m_generation(nextGeneration()), m_allFieldsGeneration(0), m_snapshotGeneration(0) {
   m_id = getID();
 }
 
 Collection::Collection(bool addDefaultFields_, const QString& title_)
-    : QObject(), QSharedData(), m_nextEntryId(1), m_title(title_), m_trackGroups(false) {
+    : QObject(), QSharedData(), m_nextEntryId(1), m_title(title_), m_fieldValuesGeneration(0),
+      m_transactionDepth(0), m_allFieldsDirty(false), m_trackGroups(false),
+      m_generation(nextGeneration()), m_allFieldsGeneration(0), m_snapshotGeneration(0) {
   if(m_title.isEmpty()) {
     m_title = i18n("My Collection");
   }
@@ -62,6 +148,7 @@ Collection::Collection(bool addDefaultFields_, const QString& title_)
 }
 
 Collection::~Collection() {
+  cancelGroupDictBuilds();
   // maybe we should just call clear() ?
   foreach(EntryGroupDict* dict, m_entryGroupDicts) {
     qDeleteAll(*dict);
@@ -138,6 +225,8 @@ bool Collection::addField(Tellico::Data::FieldPtr field_) {
     }
   }
 
+  markModified(field_->name());
+
   // refresh all dependent fields, in case one references this new one
   foreach(FieldPtr existingField, m_fields) {
     if(existingField->hasFlag(Field::Derived)) {
@@ -259,6 +348,8 @@ bool Collection::modifyField(Tellico::Data::FieldPtr newField_) {
 
   // update name dict
   m_fieldByName.insert(fieldName, newField_.data());
+  // the flags may have changed, the value dict gets rebuilt if needed
+  m_fieldValueDicts.remove(fieldName);
 
   // update titles
   const QString oldTitle = oldField->title();
@@ -297,6 +388,9 @@ bool Collection::modifyField(Tellico::Data::FieldPtr newField_) {
     }
   }
 
+  // the values in any group snapshot may no longer match the field
+  cancelGroupDictBuilds();
+
   // keep track of if the entry groups will need to be reset
   bool resetGroups = false;
 
@@ -365,6 +459,7 @@ bool Collection::modifyField(Tellico::Data::FieldPtr newField_) {
 //    myLog() << "invalidating groups";
     invalidateGroups();
   }
+  markModified(fieldName);
 
   // now to update all entries if the field is a derived value and the template changed
   if(newField_->hasFlag(Field::Derived) &&
@@ -394,6 +489,7 @@ bool Collection::removeField(Tellico::Data::FieldPtr field_, bool force_/*=false
     return false;
   }
 
+  m_fieldValueDicts.remove(field_->name());
   foreach(EntryPtr entry, m_entries) {
     // setting the fields to an empty string removes the value from the entry's list
     entry->setField(field_, QString());
@@ -415,6 +511,7 @@ bool Collection::removeField(Tellico::Data::FieldPtr field_, bool force_/*=false
   }
 
   if(field_->hasFlag(Field::AllowGrouped)) {
+    cancelGroupDictBuilds();
     EntryGroupDict* dict = m_entryGroupDicts.take(field_->name());
     qDeleteAll(*dict);
     m_entryGroups.removeAll(field_->name());
@@ -424,6 +521,7 @@ bool Collection::removeField(Tellico::Data::FieldPtr field_, bool force_/*=false
   }
 
   m_fields.removeAll(field_);
+  markModified(field_->name());
 
   // refresh all dependent fields, rather lazy, but there's
   // likely to be weird effects when checking dependent fields
@@ -440,6 +538,7 @@ bool Collection::removeField(Tellico::Data::FieldPtr field_, bool force_/*=false
 void Collection::reorderFields(const Tellico::Data::FieldList& list_) {
 // assume the lists have the same pointers!
   m_fields = list_;
+  m_generation = nextGeneration();
 
   // also reset category list, since the order may have changed
   m_fieldCategories.clear();
@@ -455,8 +554,22 @@ void Collection::addEntries(const Tellico::Data::EntryList& entries_) {
     return;
   }
 
-  const QString cdateName(QStringLiteral("cdate"));
-  const QString mdateName(QStringLiteral("mdate"));
+  // importers add many thousands of entries at once, so anything which is the same
+  // for every entry gets looked up just once
+  const FieldPtr cdateField = fieldByName(QStringLiteral("cdate"));
+  const FieldPtr mdateField = fieldByName(QStringLiteral("mdate"));
+  const QString today = (cdateField || mdateField) ? QDate::currentDate().toString(Qt::ISODate) : QString();
+  const bool trackValues = hasFieldValueDicts();
+
+  // reserving exactly would reallocate on every add, so grow geometrically when short
+  const qsizetype newCount = m_entries.count() + entries_.count();
+  if(newCount > m_entries.capacity()) {
+    m_entries.reserve(qMax(newCount, 2 * m_entries.capacity()));
+  }
+  if(newCount > m_entryById.capacity()) {
+    m_entryById.reserve(qMax(newCount, 2 * m_entryById.capacity()));
+  }
+
   foreach(EntryPtr entry, entries_) {
     if(!entry) {
       Q_ASSERT(entry);
@@ -483,26 +596,39 @@ void Collection::addEntries(const Tellico::Data::EntryList& entries_) {
       entry->setId(m_nextEntryId);
       ++m_nextEntryId;
     }
-    m_entryById.insert(entry->id(), entry.data());
 
-    if(hasField(cdateName) && entry->field(cdateName).isEmpty()) {
+    // dates are always allowed, and the entry isn't in any value dict yet
+    if(cdateField && entry->field(cdateField).isEmpty()) {
       // use mdate if it exists
-      QString cdate = entry->field(mdateName);
+      QString cdate = mdateField ? entry->field(mdateField) : QString();
       if(cdate.isEmpty()) {
-        cdate = QDate::currentDate().toString(Qt::ISODate);
+        cdate = today;
       }
-      entry->setField(cdateName, cdate, false);
+      entry->setCheckedField(cdateField, cdate);
+    }
+    if(mdateField && entry->field(mdateField).isEmpty()) {
+      entry->setCheckedField(mdateField, today);
     }
-    if(hasField(mdateName) && entry->field(mdateName).isEmpty()) {
-      entry->setField(mdateName, QDate::currentDate().toString(Qt::ISODate), false);
+    // insert after setting the dates, so the entry only gets counted once in the value dicts
+    m_entryById.insert(entry->id(), entry.data());
+    if(trackValues) {
+      addToValueDicts(entry.data(), 1);
     }
   }
+  markModified();
+  // the groups are populated in one pass over all the new entries
   if(m_trackGroups) {
     populateCurrentDicts(entries_, fieldNames());
   }
 }
 
 void Collection::removeEntriesFromDicts(const Tellico::Data::EntryList& entries_, const QStringList& fields_) {
+  // the groups from a background snapshot would be out of date for these entries
+  foreach(GroupDictBuild* build, m_groupDictBuilds) {
+    foreach(EntryPtr entry, entries_) {
+      build->skipped.insert(entry.data());
+    }
+  }
   QSet<EntryGroup*> modifiedGroups;
   foreach(EntryPtr entry, entries_) {
     // need a copy of the vector since it gets changed
@@ -533,6 +659,20 @@ void Collection::updateDicts(const Tellico::Data::EntryList& entries_, const QSt
   if(entries_.isEmpty() || !m_trackGroups) {
     return;
   }
+  if(m_transactionDepth > 0) {
+    foreach(EntryPtr entry, entries_) {
+      if(!m_dirtyEntrySet.contains(entry.data())) {
+        m_dirtyEntrySet.insert(entry.data());
+        m_dirtyEntries.append(entry);
+      }
+    }
+    if(fields_.isEmpty()) {
+      m_allFieldsDirty = true;
+    } else {
+      m_dirtyFields.unite(QSet<QString>(fields_.begin(), fields_.end()));
+    }
+    return;
+  }
   QStringList modifiedFields = fields_;
   if(modifiedFields.isEmpty()) {
 //    myDebug() << "updating all fields";
@@ -543,6 +683,25 @@ void Collection::updateDicts(const Tellico::Data::EntryList& entries_, const QSt
   cleanGroups();
 }
 
+void Collection::beginTransaction() {
+  ++m_transactionDepth;
+}
+
+void Collection::commitTransaction() {
+  Q_ASSERT(m_transactionDepth > 0);
+  if(m_transactionDepth < 1 || --m_transactionDepth > 0) {
+    return;
+  }
+  const EntryList entries = m_dirtyEntries;
+  // an empty list means all fields
+  const QStringList fields = m_allFieldsDirty ? QStringList() : m_dirtyFields.values();
+  m_dirtyEntries.clear();
+  m_dirtyEntrySet.clear();
+  m_dirtyFields.clear();
+  m_allFieldsDirty = false;
+  updateDicts(entries, fields);
+}
+
 bool Collection::removeEntries(const Tellico::Data::EntryList& vec_) {
   if(vec_.isEmpty()) {
     return false;
@@ -551,9 +710,21 @@ bool Collection::removeEntries(const Tellico::Data::EntryList& vec_) {
   removeEntriesFromDicts(vec_, fieldNames());
   bool success = true;
   foreach(EntryPtr entry, vec_) {
+    if(hasFieldValueDicts() && m_entryById.value(entry->id()) == entry.data()) {
+      addToValueDicts(entry.data(), -1);
+    }
+    // a removed entry must not be added back to the groups when a transaction is committed
+    if(m_dirtyEntrySet.remove(entry.data())) {
+      m_dirtyEntries.removeOne(entry);
+    }
     m_entryById.remove(entry->id());
     m_entries.removeAll(entry);
   }
+  markModified();
+  if(m_entries.isEmpty()) {
+    // nothing left to group, and the background builds must not outlive the entries
+    cancelGroupDictBuilds();
+  }
   cleanGroups();
   return success;
 }
@@ -586,12 +757,94 @@ QStringList Collection::valuesByFieldName(const QString& name_) const {
     return QStringList();
   }
 
-  StringSet values;
-  foreach(EntryPtr entry, m_entries) {
-    values.add(FieldFormat::splitValue(entry->field(name_)));
-  } // end entry loop
+  auto dictIt = m_fieldValueDicts.constFind(name_);
+  if(dictIt == m_fieldValueDicts.constEnd()) {
+    FieldPtr field = fieldByName(name_);
+    // derived values can't be tracked as entries change
+    if(!field || !field->hasFlag(Field::AllowCompletion) || field->hasFlag(Field::Derived)) {
+      StringSet values;
+      foreach(EntryPtr entry, m_entries) {
+        values.add(FieldFormat::splitValue(entry->field(name_)));
+      } // end entry loop
+      return values.values();
+    }
+
+    FieldValueDict dict;
+    dict.generation = ++m_fieldValuesGeneration;
+    foreach(EntryPtr entry, m_entries) {
+      addToValueDict(dict, entry->field(field), 1);
+    }
+    dictIt = m_fieldValueDicts.insert(name_, dict);
+  }
+  return dictIt->counts.keys();
+}
+
+uint Collection::fieldValuesGeneration(const QString& name_) const {
+  auto dictIt = m_fieldValueDicts.constFind(name_);
+  return dictIt == m_fieldValueDicts.constEnd() ? 0 : dictIt->generation;
+}
+
+Tellico::Data::Generation Collection::fieldGeneration(const QString& name_) const {
+  return qMax(m_fieldGenerations.value(name_), m_allFieldsGeneration);
+}
+
+void Collection::markModified(const QString& fieldName_) {
+  m_generation = nextGeneration();
+  if(fieldName_.isEmpty()) {
+    m_allFieldsGeneration = m_generation;
+  } else {
+    m_fieldGenerations.insert(fieldName_, m_generation);
+  }
+}
+
+void Collection::fieldValueChanged(const QString& fieldName_, const QString& oldValue_, const QString& newValue_) {
+  if(oldValue_ == newValue_) {
+    return;
+  }
+  auto dictIt = m_fieldValueDicts.find(fieldName_);
+  if(dictIt != m_fieldValueDicts.end()) {
+    addToValueDict(*dictIt, oldValue_, -1);
+    addToValueDict(*dictIt, newValue_, 1);
+  }
+}
 
-  return values.values();
+void Collection::addEntryValues(const Tellico::Data::Entry* entry_) {
+  addToValueDicts(entry_, 1);
+}
+
+void Collection::removeEntryValues(const Tellico::Data::Entry* entry_) {
+  addToValueDicts(entry_, -1);
+}
+
+void Collection::addToValueDicts(const Tellico::Data::Entry* entry_, int count_) {
+  for(auto dictIt = m_fieldValueDicts.begin(); dictIt != m_fieldValueDicts.end(); ++dictIt) {
+    addToValueDict(*dictIt, entry_->field(dictIt.key()), count_);
+  }
+}
+
+void Collection::addToValueDict(Tellico::Data::FieldValueDict& dict_, const QString& value_, int count_) const {
+  if(value_.isEmpty()) {
+    return;
+  }
+  const QStringList values = FieldFormat::splitValue(value_);
+  for(const auto& value : values) {
+    if(value.isEmpty()) {
+      continue;
+    }
+    auto it = dict_.counts.find(value);
+    if(it == dict_.counts.end()) {
+      if(count_ > 0) {
+        dict_.counts.insert(value, count_);
+        dict_.generation = ++m_fieldValuesGeneration;
+      }
+    } else {
+      *it += count_;
+      if(*it < 1) {
+        dict_.counts.erase(it);
+        dict_.generation = ++m_fieldValuesGeneration;
+      }
+    }
+  }
 }
 
 Tellico::Data::FieldPtr Collection::fieldByName(const QString& name_) const {
@@ -635,7 +888,12 @@ Tellico::Data::EntryGroupDict* Collection::entryGroupDictByName(const QString& n
     return nullptr;
   }
   EntryGroupDict* dict = m_entryGroupDicts.value(name_);
-  if(dict && dict->isEmpty()) {
+  // a dict still being built is only partially populated, so finish it here
+  const bool wasBuilding = m_groupDictBuilds.contains(name_);
+  if(wasBuilding) {
+    cancelGroupDictBuild(name_);
+  }
+  if(dict && (dict->isEmpty() || wasBuilding)) {
     const bool b = signalsBlocked();
     // block signals so all the group created/modified signals don't fire
     blockSignals(true);
@@ -645,42 +903,162 @@ Tellico::Data::EntryGroupDict* Collection::entryGroupDictByName(const QString& n
   return dict;
 }
 
+Tellico::Data::EntryGroupDict* Collection::entryGroupDictInBackground(const QString& name_) {
+  if(name_.isEmpty() || !m_entryGroupDicts.contains(name_) || m_entries.isEmpty()) {
+    m_lastGroupField = name_;
+    return nullptr;
+  }
+  EntryGroupDict* dict = m_entryGroupDicts.value(name_);
+  if(!m_groupDictBuilds.contains(name_) &&
+     (!dict->isEmpty() || m_entries.count() < GROUP_BUILD_MIN_ENTRIES || !startGroupDictBuild(name_))) {
+    return entryGroupDictByName(name_);
+  }
+  m_lastGroupField = name_;
+  return dict;
+}
+
+void Collection::prepareEntryGroupDicts(const QStringList& names_) {
+  if(m_entries.count() < GROUP_BUILD_MIN_ENTRIES) {
+    return;
+  }
+  foreach(const QString& name, names_) {
+    EntryGroupDict* dict = m_entryGroupDicts.value(name);
+    if(dict && dict->isEmpty() && !m_groupDictBuilds.contains(name)) {
+      startGroupDictBuild(name);
+    }
+  }
+}
+
+bool Collection::isBuildingEntryGroupDict(const QString& name_) const {
+  return m_groupDictBuilds.contains(name_);
+}
+
+bool Collection::startGroupDictBuild(const QString& fieldName_) {
+  const bool isPeople = fieldName_ == s_peopleGroupName;
+  const FieldList fields = isPeople ? m_peopleFields : FieldList() << fieldByName(fieldName_);
+  if(fields.isEmpty()) {
+    return false;
+  }
+  QStringList fieldNames;
+  foreach(FieldPtr field, fields) {
+    if(!field) {
+      return false;
+    }
+    fieldNames << field->name();
+  }
+
+  // the worker only reads the snapshot, so changes in the gui thread don't interfere
+  // and no formatted values get cached in the entries from another thread
+  const ReadOnlyCollection snapshot = this->snapshot();
+  // the results are matched to the entries by their position
+  if(snapshot.entryCount() != m_entries.count()) {
+    return false;
+  }
+  GroupDictBuild* build = new GroupDictBuild();
+  build->timer.start();
+  build->entries.reserve(m_entries.count());
+  foreach(EntryPtr entry, m_entries) {
+    build->entries << qMakePair(entry.data(), entry->id());
+  }
+  m_groupDictBuilds.insert(fieldName_, build);
+
+  connect(&build->watcher, &QFutureWatcherBase::resultReadyAt, this, [this, fieldName_](int index_) {
+    mergeGroupDictResult(fieldName_, index_);
+  });
+  connect(&build->watcher, &QFutureWatcherBase::finished, this, [this, fieldName_]() {
+    finishGroupDictBuild(fieldName_);
+  });
+  build->watcher.setFuture(QtConcurrent::run(buildGroupChunks, snapshot, fieldNames, isPeople));
+  return true;
+}
+
+void Collection::mergeGroupDictResult(const QString& fieldName_, int index_) {
+  GroupDictBuild* build = m_groupDictBuilds.value(fieldName_);
+  EntryGroupDict* dict = m_entryGroupDicts.value(fieldName_);
+  if(!build || !dict) {
+    return;
+  }
+  const GroupChunk chunk = build->watcher.resultAt(index_);
+  QSet<EntryGroup*> modifiedGroups;
+  for(int i = 0; i < chunk.groupNames.count(); ++i) {
+    const auto& entryRef = build->entries.at(chunk.begin + i);
+    Entry* entry = entryRef.first;
+    // skip entries which were removed or regrouped since the snapshot
+    if(m_entryById.value(entryRef.second) != entry || build->skipped.contains(entry)) {
+      continue;
+    }
+    addToDictGroups(dict, fieldName_, EntryPtr(entry), chunk.groupNames.at(i), modifiedGroups);
+  }
+  if(!modifiedGroups.isEmpty()) {
+    Q_EMIT signalGroupsModified(CollPtr(this), modifiedGroups.values());
+  }
+}
+
+void Collection::finishGroupDictBuild(const QString& fieldName_) {
+  GroupDictBuild* build = m_groupDictBuilds.take(fieldName_);
+  if(build) {
+    myLog() << "Grouped" << build->entries.count() << "entries by" << fieldName_ << "in" << build->timer.elapsed() << "ms";
+    // the watcher is sending the signal, so delete it later
+    build->watcher.disconnect(this);
+    QTimer::singleShot(0, [build]() { delete build; });
+  }
+}
+
+void Collection::cancelGroupDictBuild(const QString& fieldName_) {
+  GroupDictBuild* build = m_groupDictBuilds.take(fieldName_);
+  if(build) {
+    build->watcher.disconnect(this);
+    build->watcher.cancel();
+    build->watcher.waitForFinished();
+    delete build;
+  }
+}
+
+void Collection::cancelGroupDictBuilds() {
+  foreach(const QString& fieldName, m_groupDictBuilds.keys()) {
+    cancelGroupDictBuild(fieldName);
+  }
+}
+
 void Collection::populateDict(Tellico::Data::EntryGroupDict* dict_, const QString& fieldName_, const Tellico::Data::EntryList& entries_) {
 //  myDebug() << fieldName_;
   Q_ASSERT(dict_);
-  auto f = fieldByName(fieldName_);
-  const bool isBool = f && f->type() == Field::Bool;
-
   QSet<EntryGroup*> modifiedGroups;
   foreach(EntryPtr entry, entries_) {
-    const QStringList groups = entryGroupNamesByField(entry, fieldName_);
-    foreach(QString groupTitle, groups) { // krazy:exclude=foreach
-      // find the group for this group name
-      // bool fields use the field title
-      if(isBool && !groupTitle.isEmpty()) {
-        // the f value is valid since isBool is true
-        groupTitle = f->title();
-      }
-      EntryGroup* group = dict_->value(groupTitle);
-      // if the group doesn't exist, create it
-      if(!group) {
-        group = new EntryGroup(groupTitle, fieldName_);
-        dict_->insert(groupTitle, group);
-      } else if(group->isEmpty()) {
-        // if it's empty, then it was previously added to the vector of groups to delete
-        // remove it from that vector now that we're adding to it
-        m_groupsToDelete.removeOne(group);
-      }
-      if(entry->addToGroup(group)) {
-        modifiedGroups.insert(group);
-      }
-    } // end group loop
+    addToDictGroups(dict_, fieldName_, entry, entryGroupNamesByField(entry, fieldName_), modifiedGroups);
   } // end entry loop
   if(!modifiedGroups.isEmpty()) {
     Q_EMIT signalGroupsModified(CollPtr(this), modifiedGroups.values());
   }
 }
 
+void Collection::addToDictGroups(Tellico::Data::EntryGroupDict* dict_, const QString& fieldName_, Tellico::Data::EntryPtr entry_,
+                                 const QStringList& groupNames_, QSet<EntryGroup*>& modifiedGroups_) {
+  auto f = fieldByName(fieldName_);
+  const bool isBool = f && f->type() == Field::Bool;
+  foreach(QString groupTitle, groupNames_) { // krazy:exclude=foreach
+    // find the group for this group name
+    // bool fields use the field title
+    if(isBool && !groupTitle.isEmpty()) {
+      // the f value is valid since isBool is true
+      groupTitle = f->title();
+    }
+    EntryGroup* group = dict_->value(groupTitle);
+    // if the group doesn't exist, create it
+    if(!group) {
+      group = new EntryGroup(groupTitle, fieldName_);
+      dict_->insert(groupTitle, group);
+    } else if(group->isEmpty()) {
+      // if it's empty, then it was previously added to the vector of groups to delete
+      // remove it from that vector now that we're adding to it
+      m_groupsToDelete.removeOne(group);
+    }
+    if(entry_->addToGroup(group)) {
+      modifiedGroups_.insert(group);
+    }
+  } // end group loop
+}
+
 void Collection::populateCurrentDicts(const Tellico::Data::EntryList& entries_, const QStringList& fields_) {
   if(m_entryGroupDicts.isEmpty()) {
     return;
@@ -702,7 +1080,14 @@ void Collection::populateCurrentDicts(const Tellico::Data::EntryList& entries_,
     }
     // only populate if it's not empty, since they are
     // populated on demand
-    if(!dictIt.value()->isEmpty()) {
+    GroupDictBuild* build = m_groupDictBuilds.value(dictIt.key());
+    if(build) {
+      // the snapshot doesn't have the current values of these entries
+      foreach(EntryPtr entry, entries_) {
+        build->skipped.insert(entry.data());
+      }
+    }
+    if(build || !dictIt.value()->isEmpty()) {
       populateDict(dictIt.value(), dictIt.key(), entries_);
       allEmpty = false;
     }
@@ -727,24 +1112,15 @@ QStringList Collection::entryGroupNamesByField(Tellico::Data::EntryPtr entry_, c
     return entry_->groupNamesByFieldName(fieldName_);
   }
 
-  // the empty group is only returned if the entry has an empty list for every people field
-  bool allEmpty = true;
-  StringSet values;
+  QList<QStringList> fieldGroups;
   foreach(FieldPtr field, m_peopleFields) {
-    const QStringList groups = entry_->groupNamesByFieldName(field->name());
-    if(allEmpty && (groups.count() != 1 || !groups.at(0).isEmpty())) {
-      allEmpty = false;
-    }
-    values.add(groups);
-  }
-  if(!allEmpty) {
-    // we don't want the empty string
-    values.remove(QString());
+    fieldGroups << entry_->groupNamesByFieldName(field->name());
   }
-  return values.values();
+  return peopleGroupNames(fieldGroups);
 }
 
 void Collection::invalidateGroups() {
+  cancelGroupDictBuilds();
   foreach(EntryGroupDict* dict, m_entryGroupDicts) {
     qDeleteAll(*dict);
     dict->clear();
@@ -760,6 +1136,35 @@ void Collection::invalidateGroups() {
   blockSignals(false);
 }
 
+void Collection::reformatEntries() {
+  // only the title and name formatting depend on the preferences, and derived values are never cached
+  FieldList fields;
+  foreach(FieldPtr field, m_fields) {
+    if(!field->hasFlag(Field::Derived) &&
+       (field->formatType() == FieldFormat::FormatTitle || field->formatType() == FieldFormat::FormatName)) {
+      fields << field;
+    }
+  }
+  if(fields.isEmpty()) {
+    return;
+  }
+  auto reformat = [fields](const EntryPtr& entry) {
+    entry->invalidateFormattedFieldValue();
+    foreach(FieldPtr field, fields) {
+      // the formatted value gets cached in the entry
+      entry->formattedField(field);
+    }
+  };
+  if(m_entries.count() < GROUP_BUILD_MIN_ENTRIES) {
+    foreach(EntryPtr entry, m_entries) {
+      reformat(entry);
+    }
+    return;
+  }
+  // each entry is only touched by a single worker, and this thread waits until all are done
+  QtConcurrent::blockingMap(m_entries, reformat);
+}
+
 Tellico::Data::EntryPtr Collection::entryById(Data::ID id_) {
   return EntryPtr(m_entryById.value(id_));
 }
@@ -821,8 +1226,10 @@ void Collection::clear() {
   m_fieldByTitle.clear();
   m_defaultGroupField.clear();
 
+  cancelGroupDictBuilds();
   m_entries.clear();
   m_entryById.clear();
+  m_fieldValueDicts.clear();
   foreach(EntryGroupDict* dict, m_entryGroupDicts) {
     qDeleteAll(*dict);
   }
@@ -830,14 +1237,20 @@ void Collection::clear() {
   m_entryGroupDicts.clear();
   m_entryGroups.clear();
   m_groupsToDelete.clear();
+  m_dirtyEntries.clear();
+  m_dirtyEntrySet.clear();
   m_imagesToRemove.clear();
   m_filters.clear();
   m_borrowers.clear();
+  m_fieldGenerations.clear();
+  m_snapshot.reset();
+  markModified();
 }
 
 void Collection::cleanGroups() {
   foreach(EntryGroup* group, m_groupsToDelete) {
-    EntryGroupDict* dict = entryGroupDictByName(group->fieldName());
+    // the group exists, so the dict doesn't need to be populated, and one being built in the background is left alone
+    EntryGroupDict* dict = m_entryGroupDicts.value(group->fieldName());
     if(!dict) {
       continue;
     }
@@ -851,6 +1264,23 @@ QString Collection::prepareText(const QString& text_) const {
   return text_;
 }
 
+std::function<QString(const QString&)> Collection::textPreparer() const {
+  return std::function<QString(const QString&)>();
+}
+
+Tellico::Data::ReadOnlyCollection Collection::snapshot() const {
+  bool current = m_snapshot && m_snapshotGeneration >= m_generation;
+  // fields changed in place don't update the collection generation
+  for(auto it = m_fields.constBegin(); current && it != m_fields.constEnd(); ++it) {
+    current = (*it)->generation() <= m_snapshotGeneration;
+  }
+  if(!current) {
+    m_snapshotGeneration = currentGeneration();
+    m_snapshot.reset(new ReadOnlyCollection(this));
+  }
+  return *m_snapshot;
+}
+
 int Collection::sameEntry(Tellico::Data::EntryPtr entry1_, Tellico::Data::EntryPtr entry2_) const {
   if(!entry1_ || !entry2_) {
     return 0;
@@ -890,8 +1320,9 @@ QStringList Collection::imagesToRemove() const {
 }
 
 Tellico::Data::ID Collection::getID() {
-  static ID id = 0;
-  return ++id;
+  // collections may be created by importers on worker threads
+  static QAtomicInt id;
+  return id.fetchAndAddRelaxed(1) + 1;
 }
 
 Data::FieldPtr Collection::primaryImageField() const {
@@ -33,13 +33,27 @@
 
 #include <QStringList>
 #include <QHash>
+#include <QSet>
 #include <QObject>
 
+#include <functional>
+#include <memory>
+
 namespace Tellico {
   namespace Data {
     class EntryGroup;
+    class ReadOnlyCollection;
     typedef QHash<QString, EntryGroup*> EntryGroupDict;
 
+    /**
+     * Counts the number of entries which use each distinct value of a field
+     */
+    struct FieldValueDict {
+      QHash<QString, int> counts;
+      // changes whenever a value is added to or removed from the dict
+      uint generation = 0;
+    };
+
 /**
  * The Collection class is the primary data object, holding a
  * list of fields and entries.
@@ -109,7 +123,7 @@ public:
    *
    * @param title The new collection title
    */
-  void setTitle(const QString& title) { m_title = title; }
+  void setTitle(const QString& title) { m_title = title; m_generation = nextGeneration(); }
   /**
    * Returns a reference to the list of all the entries in the collection.
    *
@@ -181,6 +195,12 @@ public:
    * @param entry A pointer to the entry
    */
   void updateDicts(const EntryList& entries, const QStringList& fields);
+  /**
+   * Within a transaction, the dict updates are collected and only done once
+   * the outermost transaction is committed.
+   */
+  void beginTransaction();
+  void commitTransaction();
   /**
    * Deletes a entry from the collection.
    *
@@ -246,13 +266,62 @@ public:
   /**
    * Returns a list of the values of a given field for every entry
    * in the collection. The values in the list are not repeated. Attribute
-   * values which contain ";" are split into separate values. Since this method
-   * iterates over all the entries, for large collections, it is expensive.
+   * values which contain ";" are split into separate values. For fields which allow
+   * completion, the values are kept in a dictionary which is built on the first call
+   * and updated as entries change. Otherwise, this method iterates over all the entries,
+   * and for large collections, it is expensive.
    *
    * @param name The name of the field
    * @return The list of values
    */
   QStringList valuesByFieldName(const QString& name) const;
+  /**
+   * Returns a number which changes whenever the list of values returned by
+   * @ref valuesByFieldName changes. Zero is returned if the values are not tracked.
+   *
+   * @param name The name of the field
+   */
+  uint fieldValuesGeneration(const QString& name) const;
+  /**
+   * Returns the generation of the last change to the collection's title, its list of fields
+   * or entries, or any of the entry values. Fields modified in place, without going through
+   * @ref modifyField, only update their own @ref Field::generation.
+   *
+   * @return The generation
+   */
+  Generation generation() const { return m_generation; }
+  /**
+   * Returns the generation of the last change to a field, or to the values any entry has
+   * for it, including the addition or removal of entries. A cache of something computed from
+   * a single field is current as long as this is no later than when the cache was built.
+   *
+   * @param name The name of the field
+   * @return The generation
+   */
+  Generation fieldGeneration(const QString& name) const;
+  /**
+   * Records a change in the values of a field, or of all fields if the name is empty.
+   * Entries call this themselves whenever one of their values changes.
+   *
+   * @param fieldName The name of the field
+   */
+  void markModified(const QString& fieldName = QString());
+  /**
+   * Returns true if any value dictionary exists for the field.
+   */
+  bool hasFieldValueDict(const QString& name) const
+    { return !m_fieldValueDicts.isEmpty() && m_fieldValueDicts.contains(name); }
+  bool hasFieldValueDicts() const { return !m_fieldValueDicts.isEmpty(); }
+  /**
+   * Updates the value dictionary for a value change in an entry owned by the collection.
+   */
+  void fieldValueChanged(const QString& fieldName, const QString& oldValue, const QString& newValue);
+  /**
+   * Adds or removes all the tracked values of an entry owned by the collection
+   * to or from the value dictionaries.
+   */
+  void addEntryValues(const Entry* entry);
+  void removeEntryValues(const Entry* entry);
   /**
    * Returns a list of all the fields in a given category.
    *
@@ -295,10 +364,37 @@ public:
    * @return The list of group names
    */
   EntryGroupDict* entryGroupDictByName(const QString& name);
+  /**
+   * Returns a pointer to a dict of all the entries grouped by a certain field, like
+   * @ref entryGroupDictByName. For a large collection, a dict which is not yet populated
+   * is built on a worker thread from a snapshot of the entry values instead, and the dict
+   * is filled in as the group names come back. The new groups are reported by
+   * @ref signalGroupsModified, so the returned dict may be empty or incomplete.
+   *
+   * @param name The name of the field by which the entries are grouped
+   * @return The dict of groups
+   */
+  EntryGroupDict* entryGroupDictInBackground(const QString& name);
+  /**
+   * Starts building the dicts for several fields in the background, so they are ready
+   * by the time they are needed.
+   *
+   * @param names The names of the fields by which the entries are grouped
+   */
+  void prepareEntryGroupDicts(const QStringList& names);
+  /**
+   * Returns true if the dict for a group field is still being built in the background.
+   */
+  bool isBuildingEntryGroupDict(const QString& name) const;
   /**
    * Invalidates all group names in the collection.
    */
   void invalidateGroups();
+  /**
+   * Formats the title and name values of every entry again, after a change in the formatting
+   * preferences. Large collections are formatted in parallel.
+   */
+  void reformatEntries();
   /**
    * Returns true if the collection contains at least one Image field.
    *
@@ -325,6 +421,21 @@ public:
    * Useful only for BibtexCollection to strip bibtex strings
    */
   virtual QString prepareText(const QString& text) const;
+  /**
+   * Returns a function which prepares text the same as @ref prepareText, but without
+   * any reference to the collection, so it may be used from other threads.
+   *
+   * @return The function, or an empty one if text needs no preparation
+   */
+  virtual std::function<QString(const QString&)> textPreparer() const;
+  /**
+   * Returns a read-only snapshot of the fields and entries, which any thread may read
+   * while the collection itself keeps changing. The entry values are shared with the
+   * collection, rather than copied, until either one changes.
+   *
+   * @return The snapshot
+   */
+  ReadOnlyCollection snapshot() const;
 
   /**
    * Tracks images for possible removal when saving
@@ -346,11 +457,22 @@ protected:
   Collection(const QString& title);
 
 private:
+  class GroupDictBuild;
+
   QStringList entryGroupNamesByField(EntryPtr entry, const QString& fieldName);
   void removeEntriesFromDicts(const EntryList& entries, const QStringList& fields);
   void populateDict(EntryGroupDict* dict, const QString& fieldName, const EntryList& entries);
+  void addToDictGroups(EntryGroupDict* dict, const QString& fieldName, EntryPtr entry,
+                       const QStringList& groupNames, QSet<EntryGroup*>& modifiedGroups);
+  bool startGroupDictBuild(const QString& fieldName);
+  void mergeGroupDictResult(const QString& fieldName, int index);
+  void finishGroupDictBuild(const QString& fieldName);
+  void cancelGroupDictBuild(const QString& fieldName);
+  void cancelGroupDictBuilds();
   void populateCurrentDicts(const EntryList& entries, const QStringList& fields);
   void cleanGroups();
+  void addToValueDicts(const Entry* entry, int count);
+  void addToValueDict(FieldValueDict& dict, const QString& value, int count) const;
 
   /*
    * Gets the preferred ID of the collection. Currently, it just gets incremented as
@@ -378,14 +500,32 @@ private:
   QHash<int, Entry*> m_entryById;
 
   QHash<QString, EntryGroupDict*> m_entryGroupDicts;
+  QHash<QString, GroupDictBuild*> m_groupDictBuilds;
+  // value dicts are populated on demand, so they may be built from a const method
+  mutable QHash<QString, FieldValueDict> m_fieldValueDicts;
+  mutable uint m_fieldValuesGeneration;
   QStringList m_entryGroups;
   QList<EntryGroup*> m_groupsToDelete;
+
+  int m_transactionDepth;
+  EntryList m_dirtyEntries;
+  QSet<Entry*> m_dirtyEntrySet;
+  QSet<QString> m_dirtyFields;
+  bool m_allFieldsDirty;
   QSet<QString> m_imagesToRemove;
 
   FilterList m_filters;
   BorrowerList m_borrowers;
 
   bool m_trackGroups;
+
+  Generation m_generation;
+  // the last change which affected every field, such as adding entries
+  Generation m_allFieldsGeneration;
+  QHash<QString, Generation> m_fieldGenerations;
+  // the last snapshot is shared until something changes
+  mutable std::unique_ptr<ReadOnlyCollection> m_snapshot;
+  mutable Generation m_snapshotGeneration;
 };
 
   } // end namespace
@@ -343,6 +343,14 @@ QString BibtexCollection::prepareText(const QString& text_) const {
   return text;
 }
 
+std::function<QString(const QString&)> BibtexCollection::textPreparer() const {
+  return [](const QString& text_) {
+    QString text = text_;
+    BibtexHandler::cleanText(text);
+    return text;
+  };
+}
+
 int BibtexCollection::sameEntry(Tellico::Data::EntryPtr entry1_, Tellico::Data::EntryPtr entry2_) const {
   if(!entry1_ || !entry2_) {
     return 0;
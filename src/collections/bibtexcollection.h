@@ -67,6 +67,7 @@ public:
   void removeMacro(const QString& key) { m_macros.remove(key); }
 
   virtual QString prepareText(const QString& text) const override;
+  virtual std::function<QString(const QString&)> textPreparer() const override;
   virtual int sameEntry(Data::EntryPtr entry1, Data::EntryPtr entry2) const override;
 
   EntryList duplicateBibtexKeys() const;
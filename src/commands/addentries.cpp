@@ -24,7 +24,7 @@
 
 #include "addentries.h"
 #include "../collection.h"
-#include "../controller.h"
+#include "../changenotifier.h"
 #include "../datavectors.h"
 #include "../tellico_debug.h"
 
@@ -60,7 +60,7 @@ void AddEntries::redo() {
       }
     }
   }
-  Controller::self()->addedEntries(m_entries);
+  ChangeNotifier::self()->addedEntries(m_entries);
 }
 
 void AddEntries::undo() {
@@ -69,5 +69,9 @@ void AddEntries::undo() {
   }
 
   m_coll->removeEntries(m_entries);
-  Controller::self()->removedEntries(m_entries);
+  ChangeNotifier::self()->removedEntries(m_entries);
+}
+
+qsizetype AddEntries::sizeInBytes() const {
+  return sizeof(AddEntries) + entrySize(m_entries);
 }
@@ -25,7 +25,7 @@
 #ifndef TELLICO_ADDENTRIES_H
 #define TELLICO_ADDENTRIES_H
 
-#include "../datavectors.h"
+#include "sizedcommand.h"
 
 #include <QUndoCommand>
 
@@ -35,7 +35,7 @@ namespace Tellico {
 /**
  * @author Robby Stephenson
  */
-class AddEntries : public QUndoCommand  {
+class AddEntries : public QUndoCommand, public SizedCommand {
 
 public:
   AddEntries(Data::CollPtr coll, const Data::EntryList& entries);
@@ -43,6 +43,8 @@ public:
   virtual void redo() override;
   virtual void undo() override;
 
+  virtual qsizetype sizeInBytes() const override;
+
 private:
   Data::CollPtr m_coll;
   Data::EntryList m_entries;
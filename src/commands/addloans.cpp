@@ -27,7 +27,7 @@
 #include "../document.h"
 #include "../entry.h"
 #include "../collection.h"
-#include "../controller.h"
+#include "../changenotifier.h"
 #include "../tellico_debug.h"
 
 #include <KLocalizedString>
@@ -66,14 +66,14 @@ void AddLoans::redo() {
   foreach(Data::LoanPtr loan, m_loans) {
     m_borrower->addLoan(loan);
     Data::Document::self()->checkOutEntry(loan->entry());
-    Controller::self()->modifiedEntries(Data::EntryList() << loan->entry());
+    ChangeNotifier::self()->modifiedEntries(Data::EntryList() << loan->entry());
   }
   if(!loanExisted) {
     Data::CollPtr c = m_loans[0]->entry()->collection();
     Data::FieldPtr f = c->fieldByName(QStringLiteral("loaned"));
     if(f) {
       // notify everything that a new field was added
-      Controller::self()->addedField(c, f);
+      ChangeNotifier::self()->addedField(c, f);
       m_addedLoanField = true;
     }
   }
@@ -82,10 +82,10 @@ void AddLoans::redo() {
   }
   if(wasEmpty) {
     m_loans[0]->entry()->collection()->addBorrower(m_borrower);
-    Controller::self()->addedBorrower(m_borrower);
+    ChangeNotifier::self()->addedBorrower(m_borrower);
   } else {
     // don't have to do anything to the document, it just holds a pointer
-    Controller::self()->modifiedBorrower(m_borrower);
+    ChangeNotifier::self()->modifiedBorrower(m_borrower);
   }
 }
 
@@ -98,14 +98,14 @@ void AddLoans::undo() {
   foreach(Data::LoanPtr loan, m_loans) {
     m_borrower->removeLoan(loan);
     Data::Document::self()->checkInEntry(loan->entry());
-    Controller::self()->modifiedEntries(Data::EntryList() << loan->entry());
+    ChangeNotifier::self()->modifiedEntries(Data::EntryList() << loan->entry());
   }
   if(m_addedLoanField) {
     Data::CollPtr c = m_loans[0]->entry()->collection();
     Data::FieldPtr f = c->fieldByName(QStringLiteral("loaned"));
     if(f) {
       c->removeField(f);
-      Controller::self()->removedField(c, f);
+      ChangeNotifier::self()->removedField(c, f);
     }
   }
   if(m_addToCalendar) {
@@ -114,5 +114,5 @@ void AddLoans::undo() {
   // the borrower object is kept in the document, it's just empty
   // it won't get saved in the document file
   // here, just notify everybody that it changed
-  Controller::self()->modifiedBorrower(m_borrower);
+  ChangeNotifier::self()->modifiedBorrower(m_borrower);
 }
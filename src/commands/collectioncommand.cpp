@@ -139,6 +139,29 @@ void CollectionCommand::undo() {
   }
 }
 
+qsizetype CollectionCommand::sizeInBytes() const {
+  qsizetype size = sizeof(CollectionCommand);
+  switch(m_mode) {
+    case Append:
+    case Merge:
+      // the new collection is held for redo
+      if(m_newColl) {
+        size += entrySize(m_newColl->entries());
+      }
+      break;
+
+    case Replace:
+      // only the collection which is not in the document counts
+      if(m_cleanup == ClearOriginal && m_origColl) {
+        size += entrySize(m_origColl->entries());
+      } else if(m_cleanup == ClearNew && m_newColl) {
+        size += entrySize(m_newColl->entries());
+      }
+      break;
+  }
+  return size;
+}
+
 void CollectionCommand::copyFields() {
   m_origFields.clear();
   foreach(Data::FieldPtr field, m_origColl->fields()) {
@@ -25,7 +25,7 @@
 #ifndef TELLICO_COLLECTIONCOMMAND_H
 #define TELLICO_COLLECTIONCOMMAND_H
 
-#include "../datavectors.h"
+#include "sizedcommand.h"
 
 #include <QUndoCommand>
 #include <QUrl>
@@ -36,7 +36,7 @@ namespace Tellico {
 /**
  * @author Robby Stephenson
  */
-class CollectionCommand : public QUndoCommand {
+class CollectionCommand : public QUndoCommand, public SizedCommand {
 public:
   enum Mode {
     Append,
@@ -50,6 +50,8 @@ public:
   virtual void redo() override;
   virtual void undo() override;
 
+  virtual qsizetype sizeInBytes() const override;
+
 private:
   void copyFields();
   void copyMacros();
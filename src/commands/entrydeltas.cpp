@@ -0,0 +1,91 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "entrydeltas.h"
+#include "../collection.h"
+#include "../entry.h"
+#include "../field.h"
+#include "../tellico_debug.h"
+
+using Tellico::Command::EntryDeltas;
+
+EntryDeltas::EntryDeltas() {
+}
+
+void EntryDeltas::compute(Tellico::Data::CollPtr coll_, const Tellico::Data::EntryList& oldEntries_,
+                          const Tellico::Data::EntryList& newEntries_) {
+  m_deltas.clear();
+  if(!coll_) {
+    return;
+  }
+  const int count = qMin(newEntries_.count(), oldEntries_.count());
+  static const QString cdate(QStringLiteral("cdate"));
+  static const QString mdate(QStringLiteral("mdate"));
+  const Data::FieldList fields = coll_->fields();
+  for(int i = 0; i < count; ++i) {
+    const Data::EntryPtr oldEntry = oldEntries_.at(i);
+    const Data::EntryPtr newEntry = newEntries_.at(i);
+    foreach(Data::FieldPtr field, fields) {
+      // derived values follow the other fields
+      if(field->hasFlag(Data::Field::Derived)) {
+        continue;
+      }
+      const QString oldValue = oldEntry->field(field);
+      // a plain copy of an entry drops the dates, so an empty old date is unknown rather than cleared
+      if(oldValue.isEmpty() && (field->name() == cdate || field->name() == mdate)) {
+        continue;
+      }
+      const QString newValue = newEntry->field(field);
+      if(oldValue != newValue) {
+        m_deltas.append(FieldDelta{i, field->name(), oldValue, newValue});
+      }
+    }
+  }
+}
+
+void EntryDeltas::apply(Tellico::Data::CollPtr coll_, const Tellico::Data::EntryList& entries_, bool useOldValues_) const {
+  if(!coll_) {
+    return;
+  }
+  foreach(const FieldDelta& delta, m_deltas) {
+    Data::FieldPtr field = coll_->fieldByName(delta.fieldName);
+    if(!field) {
+      myDebug() << "no field named" << delta.fieldName;
+      continue;
+    }
+    if(delta.entryIndex >= entries_.count()) {
+      continue;
+    }
+    entries_.at(delta.entryIndex)->setField(field, useOldValues_ ? delta.oldValue : delta.newValue, false);
+  }
+}
+
+qsizetype EntryDeltas::sizeInBytes() const {
+  qsizetype size = sizeof(EntryDeltas);
+  foreach(const FieldDelta& delta, m_deltas) {
+    // the strings are implicitly shared with the entries and field names, so this overestimates
+    size += sizeof(FieldDelta) + sizeof(QChar) * (delta.oldValue.size() + delta.newValue.size());
+  }
+  return size;
+}
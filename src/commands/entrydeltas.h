@@ -0,0 +1,82 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TELLICO_ENTRYDELTAS_H
+#define TELLICO_ENTRYDELTAS_H
+
+#include "../datavectors.h"
+
+#include <QStringList>
+
+namespace Tellico {
+  namespace Command {
+
+/**
+ * EntryDeltas records only the field values which differ between the old and the new
+ * versions of some entries, so a modification can be undone and redone in place
+ * without keeping a full copy of each entry.
+ *
+ * @author Robby Stephenson
+ */
+class EntryDeltas {
+
+public:
+  EntryDeltas();
+
+  /**
+   * Compares the entries, replacing any earlier deltas.
+   *
+   * @param coll The collection whose fields are compared
+   * @param oldEntries Copies of the entries with the old values
+   * @param newEntries The entries with the new values, in the same order
+   */
+  void compute(Data::CollPtr coll, const Data::EntryList& oldEntries, const Data::EntryList& newEntries);
+  /**
+   * Sets either the old or the new values in the entries. Since things like the detailed list view
+   * and the icon view hold pointers to the entries, the values have to be changed in place.
+   */
+  void apply(Data::CollPtr coll, const Data::EntryList& entries, bool useOldValues) const;
+
+  bool isEmpty() const { return m_deltas.isEmpty(); }
+  int count() const { return m_deltas.count(); }
+  /**
+   * Returns an estimate of the memory used by the deltas, in bytes.
+   */
+  qsizetype sizeInBytes() const;
+
+private:
+  struct FieldDelta {
+    int entryIndex;
+    QString fieldName;
+    QString oldValue;
+    QString newValue;
+  };
+
+  QList<FieldDelta> m_deltas;
+};
+
+  } // end namespace
+}
+
+#endif
@@ -24,7 +24,7 @@
 
 #include "fieldcommand.h"
 #include "../collection.h"
-#include "../controller.h"
+#include "../changenotifier.h"
 #include "../tellico_debug.h"
 
 #include <KLocalizedString>
@@ -94,17 +94,17 @@ void FieldCommand::redo() {
       // so save a pointer to it here, the collection should not delete it
       m_oldField = m_coll->fieldByName(m_activeField->name());
       m_coll->addField(m_activeField);
-      Controller::self()->addedField(m_coll, m_activeField);
+      ChangeNotifier::self()->addedField(m_coll, m_activeField);
       break;
 
     case FieldModify:
       m_coll->modifyField(m_activeField);
-      Controller::self()->modifiedField(m_coll, m_oldField, m_activeField);
+      ChangeNotifier::self()->modifiedField(m_coll, m_oldField, m_activeField);
       break;
 
     case FieldRemove:
       m_coll->removeField(m_activeField);
-      Controller::self()->removedField(m_coll, m_activeField);
+      ChangeNotifier::self()->removedField(m_coll, m_activeField);
       break;
   }
 }
@@ -117,21 +117,21 @@ void FieldCommand::undo() {
   switch(m_mode) {
     case FieldAdd:
       m_coll->removeField(m_activeField);
-      Controller::self()->removedField(m_coll, m_activeField);
+      ChangeNotifier::self()->removedField(m_coll, m_activeField);
       if(m_oldField) {
         m_coll->addField(m_oldField);
-        Controller::self()->addedField(m_coll, m_oldField);
+        ChangeNotifier::self()->addedField(m_coll, m_oldField);
       }
       break;
 
     case FieldModify:
       m_coll->modifyField(m_oldField);
-      Controller::self()->modifiedField(m_coll, m_activeField, m_oldField);
+      ChangeNotifier::self()->modifiedField(m_coll, m_activeField, m_oldField);
       break;
 
     case FieldRemove:
       m_coll->addField(m_activeField);
-      Controller::self()->addedField(m_coll, m_activeField);
+      ChangeNotifier::self()->addedField(m_coll, m_activeField);
       break;
   }
 }
@@ -25,7 +25,7 @@
 #include "filtercommand.h"
 #include "../document.h"
 #include "../collection.h"
-#include "../controller.h"
+#include "../changenotifier.h"
 #include "../tellico_debug.h"
 
 #include <KLocalizedString>
@@ -72,19 +72,19 @@ void FilterCommand::redo() {
   switch(m_mode) {
     case FilterAdd:
       Data::Document::self()->collection()->addFilter(m_activeFilter);
-      Controller::self()->addedFilter(m_activeFilter);
+      ChangeNotifier::self()->addedFilter(m_activeFilter);
       break;
 
     case FilterModify:
       Data::Document::self()->collection()->addFilter(m_activeFilter);
-      Controller::self()->addedFilter(m_activeFilter);
+      ChangeNotifier::self()->addedFilter(m_activeFilter);
       Data::Document::self()->collection()->removeFilter(m_oldFilter);
-      Controller::self()->removedFilter(m_oldFilter);
+      ChangeNotifier::self()->removedFilter(m_oldFilter);
       break;
 
     case FilterRemove:
       Data::Document::self()->collection()->removeFilter(m_activeFilter);
-      Controller::self()->removedFilter(m_activeFilter);
+      ChangeNotifier::self()->removedFilter(m_activeFilter);
       break;
   }
 }
@@ -97,19 +97,19 @@ void FilterCommand::undo() {
   switch(m_mode) {
     case FilterAdd:
       Data::Document::self()->collection()->removeFilter(m_activeFilter);
-      Controller::self()->removedFilter(m_activeFilter);
+      ChangeNotifier::self()->removedFilter(m_activeFilter);
       break;
 
     case FilterModify:
       Data::Document::self()->collection()->removeFilter(m_activeFilter);
-      Controller::self()->removedFilter(m_activeFilter);
+      ChangeNotifier::self()->removedFilter(m_activeFilter);
       Data::Document::self()->collection()->addFilter(m_oldFilter);
-      Controller::self()->addedFilter(m_oldFilter);
+      ChangeNotifier::self()->addedFilter(m_oldFilter);
       break;
 
     case FilterRemove:
       Data::Document::self()->collection()->addFilter(m_activeFilter);
-      Controller::self()->addedFilter(m_activeFilter);
+      ChangeNotifier::self()->addedFilter(m_activeFilter);
       break;
   }
 }
@@ -25,7 +25,7 @@
 
 #include "modifyentries.h"
 #include "../collection.h"
-#include "../controller.h"
+#include "../changenotifier.h"
 #include "../tellico_debug.h"
 
 #include <KLocalizedString>
@@ -39,7 +39,7 @@ ModifyEntries::ModifyEntries(Tellico::Data::CollPtr coll_, const Tellico::Data::
     , m_oldEntries(oldEntries_)
     , m_entries(newEntries_)
     , m_modifiedFields(modifiedFields_)
-    , m_needToSwap(false)
+    , m_needToApply(false)
 {
 #ifndef NDEBUG
   if(m_oldEntries.count() != m_entries.count()) {
@@ -59,7 +59,7 @@ ModifyEntries::ModifyEntries(QUndoCommand* parent, Tellico::Data::CollPtr coll_,
     , m_oldEntries(oldEntries_)
     , m_entries(newEntries_)
     , m_modifiedFields(modifiedFields_)
-    , m_needToSwap(false)
+    , m_needToApply(false)
 {
 #ifndef NDEBUG
   if(m_oldEntries.count() != m_entries.count()) {
@@ -76,9 +76,13 @@ void ModifyEntries::redo() {
   if(!m_coll || m_entries.isEmpty()) {
     return;
   }
-  if(m_needToSwap) {
-    swapValues();
-    m_needToSwap = false;
+  if(!m_oldEntries.isEmpty()) {
+    // the first time through, the entries already have the new values
+    m_deltas.compute(m_coll, m_oldEntries, m_entries);
+    m_oldEntries.clear();
+  } else if(m_needToApply) {
+    m_deltas.apply(m_coll, m_entries, false /* new values */);
+    m_needToApply = false;
   }
   // loans expose a field named "loaned", and the user might modify that without
   // checking in the loan, so verify that. Heavy-handed, yes...
@@ -92,34 +96,25 @@ void ModifyEntries::redo() {
       }
     }
     if(!notLoaned.isEmpty()) {
-      Controller::self()->slotCheckIn(notLoaned);
+      ChangeNotifier::self()->checkIn(notLoaned);
     }
   }
   m_coll->updateDicts(m_entries, m_modifiedFields);
-  Controller::self()->modifiedEntries(m_entries);
+  ChangeNotifier::self()->modifiedEntries(m_entries);
 }
 
 void ModifyEntries::undo() {
   if(!m_coll || m_entries.isEmpty()) {
     return;
   }
-  swapValues();
-  m_needToSwap = true;
+  m_deltas.apply(m_coll, m_entries, true /* old values */);
+  m_needToApply = true;
   m_coll->updateDicts(m_entries, m_modifiedFields);
-  Controller::self()->modifiedEntries(m_entries);
+  ChangeNotifier::self()->modifiedEntries(m_entries);
   //TODO: need to tell edit dialog that it's not modified
 }
 
-void ModifyEntries::swapValues() {
-  // since things like the detailedlistview and the entryiconview hold pointers to the entries
-  // can't just call Controller::modifiedEntry() on the old pointers
-  for(int i = 0; i < m_entries.count(); ++i) {
-    // need to swap entry values, not just pointers
-    // the id gets reset when copying, so need to keep it
-    const Data::ID id = m_entries[i]->id();
-    Data::Entry tmp(*m_entries[i]); // tmp id becomes -1
-    *m_entries[i] = *m_oldEntries[i]; // id becomes -1
-    m_entries[i]->setId(id); // id becomes what was originally
-    *m_oldEntries[i] = tmp; // id becomes -1
-  }
+qsizetype ModifyEntries::sizeInBytes() const {
+  return sizeof(ModifyEntries) + m_entries.count() * sizeof(Data::EntryPtr) + entrySize(m_oldEntries)
+       + m_deltas.sizeInBytes();
 }
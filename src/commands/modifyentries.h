@@ -25,7 +25,8 @@
 #ifndef TELLICO_MODIFYENTRIES_H
 #define TELLICO_MODIFYENTRIES_H
 
-#include "../datavectors.h"
+#include "entrydeltas.h"
+#include "sizedcommand.h"
 
 #include <QUndoCommand>
 
@@ -35,7 +36,7 @@ namespace Tellico {
 /**
  * @author Robby Stephenson
  */
-class ModifyEntries : public QUndoCommand {
+class ModifyEntries : public QUndoCommand, public SizedCommand {
 
 public:
   ModifyEntries(Data::CollPtr coll, const Data::EntryList& oldEntries,
@@ -46,14 +47,17 @@ public:
   virtual void redo() override;
   virtual void undo() override;
 
-private:
-  void swapValues();
+  virtual qsizetype sizeInBytes() const override;
 
+private:
   Data::CollPtr m_coll;
+  // the old entries are only held until the first redo(), when the deltas are computed
   Data::EntryList m_oldEntries;
   Data::EntryList m_entries;
   QStringList m_modifiedFields;
-  bool m_needToSwap : 1;
+  // only the changed field values are kept for undo, rather than a full copy of each entry
+  EntryDeltas m_deltas;
+  bool m_needToApply : 1;
 };
 
   } // end namespace
@@ -25,7 +25,7 @@
 #include "modifyloans.h"
 #include "../document.h"
 #include "../entry.h"
-#include "../controller.h"
+#include "../changenotifier.h"
 #include "../tellico_debug.h"
 
 #include <KLocalizedString>
@@ -48,7 +48,7 @@ void ModifyLoans::redo() {
   Data::BorrowerPtr b = m_oldLoan->borrower();
   b->removeLoan(m_oldLoan);
   b->addLoan(m_newLoan);
-  Controller::self()->modifiedBorrower(b);
+  ChangeNotifier::self()->modifiedBorrower(b);
 
   if(m_addToCalendar && !m_oldLoan->inCalendar()) {
     myWarning() << "Add to calendar not implemented";
@@ -65,7 +65,7 @@ void ModifyLoans::undo() {
   Data::BorrowerPtr b = m_oldLoan->borrower();
   b->removeLoan(m_newLoan);
   b->addLoan(m_oldLoan);
-  Controller::self()->modifiedBorrower(b);
+  ChangeNotifier::self()->modifiedBorrower(b);
 
   if(m_addToCalendar && !m_oldLoan->inCalendar()) {
     myWarning() << "Add to calendar not implemented";
@@ -25,7 +25,7 @@
 #include "removeentries.h"
 #include "removeloans.h"
 #include "../collection.h"
-#include "../controller.h"
+#include "../changenotifier.h"
 #include "../tellico_debug.h"
 
 #include <KLocalizedString>
@@ -63,7 +63,7 @@ void RemoveEntries::redo() {
   }
 
   m_coll->removeEntries(m_entries);
-  Controller::self()->removedEntries(m_entries);
+  ChangeNotifier::self()->removedEntries(m_entries);
 
   QUndoCommand::redo();
 }
@@ -74,7 +74,11 @@ void RemoveEntries::undo() {
   }
 
   m_coll->addEntries(m_entries);
-  Controller::self()->addedEntries(m_entries);
+  ChangeNotifier::self()->addedEntries(m_entries);
 
   QUndoCommand::undo();
 }
+
+qsizetype RemoveEntries::sizeInBytes() const {
+  return sizeof(RemoveEntries) + entrySize(m_entries);
+}
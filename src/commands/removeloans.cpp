@@ -25,7 +25,7 @@
 #include "removeloans.h"
 #include "../document.h"
 #include "../entry.h"
-#include "../controller.h"
+#include "../changenotifier.h"
 #include "../tellico_debug.h"
 
 #include <KLocalizedString>
@@ -58,10 +58,10 @@ void RemoveLoans::redo() {
     loan->borrower()->removeLoan(loan);
     Data::Document::self()->checkInEntry(loan->entry());
     modifiedEntries.append(loan->entry());
-    Controller::self()->modifiedBorrower(loan->borrower());
+    ChangeNotifier::self()->modifiedBorrower(loan->borrower());
   }
   if(!modifiedEntries.isEmpty()) {
-    Controller::self()->modifiedEntries(modifiedEntries);
+    ChangeNotifier::self()->modifiedEntries(modifiedEntries);
   }
   if(!calLoans.isEmpty()) {
     myWarning() << "Add to calendar not implemented";
@@ -87,13 +87,13 @@ void RemoveLoans::undo() {
     Data::Document::self()->checkOutEntry(loan->entry());
     modifiedEntries.append(loan->entry());
     if(emptyBorrower) {
-      Controller::self()->addedBorrower(loan->borrower());
+      ChangeNotifier::self()->addedBorrower(loan->borrower());
     } else {
-      Controller::self()->modifiedBorrower(loan->borrower());
+      ChangeNotifier::self()->modifiedBorrower(loan->borrower());
     }
   }
   if(!modifiedEntries.isEmpty()) {
-    Controller::self()->modifiedEntries(modifiedEntries);
+    ChangeNotifier::self()->modifiedEntries(modifiedEntries);
   }
   if(!calLoans.isEmpty()) {
     myWarning() << "Add to calendar not implemented";
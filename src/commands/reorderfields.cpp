@@ -24,7 +24,7 @@
 
 #include "reorderfields.h"
 #include "../collection.h"
-#include "../controller.h"
+#include "../changenotifier.h"
 #include "../tellico_debug.h"
 
 #include <KLocalizedString>
@@ -50,7 +50,7 @@ void ReorderFields::redo() {
     return;
   }
   m_coll->reorderFields(m_newFields);
-  Controller::self()->reorderedFields(m_coll);
+  ChangeNotifier::self()->reorderedFields(m_coll);
 }
 
 void ReorderFields::undo() {
@@ -58,5 +58,5 @@ void ReorderFields::undo() {
     return;
   }
   m_coll->reorderFields(m_oldFields);
-  Controller::self()->reorderedFields(m_coll);
+  ChangeNotifier::self()->reorderedFields(m_coll);
 }
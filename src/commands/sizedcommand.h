@@ -0,0 +1,74 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TELLICO_SIZEDCOMMAND_H
+#define TELLICO_SIZEDCOMMAND_H
+
+#include "../entry.h"
+
+namespace Tellico {
+  namespace Command {
+
+/**
+ * Commands which hold on to entries or values report how much memory they use,
+ * so the undo history can stay within its memory limit.
+ *
+ * @author Robby Stephenson
+ */
+class SizedCommand {
+
+public:
+  SizedCommand() {}
+  virtual ~SizedCommand() {}
+
+  /**
+   * Returns an estimate of the memory used by the undo record, in bytes. Child commands
+   * are counted separately.
+   */
+  virtual qsizetype sizeInBytes() const = 0;
+
+protected:
+  /**
+   * Returns an estimate of the memory used by the values of the entries. The strings may be
+   * implicitly shared with other entries, so this overestimates.
+   */
+  static qsizetype entrySize(const Data::EntryList& entries) {
+    qsizetype size = 0;
+    foreach(Data::EntryPtr entry, entries) {
+      size += sizeof(Data::Entry);
+      foreach(const QString& value, entry->fieldValues()) {
+        size += sizeof(QString) + sizeof(QChar) * value.size();
+      }
+    }
+    return size;
+  }
+
+private:
+  Q_DISABLE_COPY(SizedCommand)
+};
+
+  } // end namespace
+}
+
+#endif
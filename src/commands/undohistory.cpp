@@ -0,0 +1,234 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "undohistory.h"
+#include "sizedcommand.h"
+#include "../tellico_debug.h"
+
+#include <QUndoStack>
+#include <QUndoCommand>
+
+#include <memory>
+
+namespace Tellico {
+  namespace Command {
+
+/**
+ * The commands in a group are run as they are pushed, and undone in reverse order.
+ */
+class CommandGroup : public QUndoCommand {
+public:
+  explicit CommandGroup(const QString& text_) : QUndoCommand(text_) {}
+  ~CommandGroup() { qDeleteAll(m_commands); }
+
+  virtual void redo() override {
+    foreach(QUndoCommand* command, m_commands) {
+      command->redo();
+    }
+  }
+  virtual void undo() override {
+    for(int i = m_commands.count()-1; i >= 0; --i) {
+      m_commands.at(i)->undo();
+    }
+  }
+
+  void append(QUndoCommand* command_) { m_commands.append(command_); }
+  bool isEmpty() const { return m_commands.isEmpty(); }
+  const QList<QUndoCommand*>& commands() const { return m_commands; }
+
+private:
+  QList<QUndoCommand*> m_commands;
+};
+
+/**
+ * Every command on the stack is wrapped, so the command can outlive the stack entry
+ * when the stack is rebuilt. A command which already ran isn't run again when pushed.
+ */
+class HistoryCommand : public QUndoCommand {
+public:
+  HistoryCommand(std::shared_ptr<QUndoCommand> command_, bool done_)
+      : QUndoCommand(command_->text()), m_command(command_), m_done(done_), m_size(0) {}
+
+  virtual void redo() override {
+    if(m_done) {
+      m_done = false;
+      return;
+    }
+    m_command->redo();
+  }
+  virtual void undo() override {
+    m_command->undo();
+  }
+
+  std::shared_ptr<QUndoCommand> command() const { return m_command; }
+  // the size is only known once the command has run, and it doesn't change much after that
+  qulonglong size() const {
+    if(m_size == 0) {
+      m_size = UndoHistory::commandSize(m_command.get());
+    }
+    return m_size;
+  }
+
+private:
+  std::shared_ptr<QUndoCommand> m_command;
+  bool m_done;
+  mutable qulonglong m_size;
+};
+
+  }
+}
+
+using Tellico::Command::UndoHistory;
+using Tellico::Command::CommandGroup;
+using Tellico::Command::HistoryCommand;
+
+UndoHistory::UndoHistory(QObject* parent_) : QObject(parent_)
+    , m_stack(new QUndoStack(this)), m_memoryLimit(0), m_group(nullptr), m_groupDepth(0) {
+}
+
+UndoHistory::~UndoHistory() {
+  delete m_group;
+}
+
+void UndoHistory::setMemoryLimit(qulonglong bytes_) {
+  m_memoryLimit = bytes_;
+}
+
+qulonglong UndoHistory::memoryUsed() const {
+  qulonglong size = 0;
+  // any commands above the current index can only be redone, and get deleted by the next push
+  for(int i = 0; i < m_stack->index(); ++i) {
+    size += static_cast<const HistoryCommand*>(m_stack->command(i))->size();
+  }
+  return size;
+}
+
+void UndoHistory::push(QUndoCommand* command_) {
+  if(!command_) {
+    return;
+  }
+  if(m_group) {
+    command_->redo();
+    m_group->append(command_);
+    return;
+  }
+  m_stack->push(new HistoryCommand(std::shared_ptr<QUndoCommand>(command_), false /* not run yet */));
+  trim();
+}
+
+void UndoHistory::beginGroup(const QString& text_) {
+  if(m_groupDepth++ == 0) {
+    m_group = new CommandGroup(text_);
+  }
+}
+
+void UndoHistory::endGroup() {
+  if(m_groupDepth < 1 || --m_groupDepth > 0) {
+    return;
+  }
+  CommandGroup* group = m_group;
+  m_group = nullptr;
+  if(group->isEmpty()) {
+    delete group;
+    return;
+  }
+  m_stack->push(new HistoryCommand(std::shared_ptr<QUndoCommand>(group), true /* already run */));
+  trim();
+}
+
+void UndoHistory::clear() {
+  m_stack->clear();
+  m_stack->setClean();
+}
+
+qulonglong UndoHistory::commandSize(const QUndoCommand* command_) {
+  if(!command_) {
+    return 0;
+  }
+  qulonglong size = 0;
+  if(const HistoryCommand* historyCmd = dynamic_cast<const HistoryCommand*>(command_)) {
+    return historyCmd->size();
+  } else if(const CommandGroup* group = dynamic_cast<const CommandGroup*>(command_)) {
+    size = sizeof(CommandGroup);
+    foreach(const QUndoCommand* command, group->commands()) {
+      size += commandSize(command);
+    }
+  } else if(const SizedCommand* sizedCmd = dynamic_cast<const SizedCommand*>(command_)) {
+    size = sizedCmd->sizeInBytes();
+  } else {
+    // the other commands only hold a few pointers and strings
+    size = sizeof(QUndoCommand) + sizeof(QChar) * command_->text().size();
+  }
+  for(int i = 0; i < command_->childCount(); ++i) {
+    size += commandSize(command_->child(i));
+  }
+  return size;
+}
+
+void UndoHistory::trim() {
+  if(m_memoryLimit == 0) {
+    return;
+  }
+  // trim() is only called after a push, so every command on the stack can be undone
+  const int count = m_stack->count();
+  QList<qulonglong> sizes;
+  sizes.reserve(count);
+  qulonglong total = 0;
+  for(int i = 0; i < count; ++i) {
+    sizes << static_cast<const HistoryCommand*>(m_stack->command(i))->size();
+    total += sizes.last();
+  }
+  int first = 0;
+  while(total > m_memoryLimit && first < count-1) {
+    total -= sizes.at(first);
+    ++first;
+  }
+  if(first == 0) {
+    return;
+  }
+  myLog() << "Dropping" << first << "commands from the undo history";
+
+  QList<std::shared_ptr<QUndoCommand>> commands;
+  for(int i = first; i < count; ++i) {
+    commands << static_cast<const HistoryCommand*>(m_stack->command(i))->command();
+  }
+  // the saved state may still be on the stack after rebuilding it
+  const int cleanIndex = m_stack->cleanIndex() - first;
+  // the newest command is kept and the clean state stays the same, so nothing needs to know
+  const bool block = m_stack->blockSignals(true);
+  // deleting the wrappers for the oldest commands deletes the commands themselves
+  m_stack->clear();
+  for(int i = 0; i < commands.count(); ++i) {
+    if(i == cleanIndex) {
+      m_stack->setClean();
+    }
+    m_stack->push(new HistoryCommand(commands.at(i), true /* already run */));
+  }
+  if(cleanIndex == commands.count()) {
+    m_stack->setClean();
+  } else if(cleanIndex < 0 || cleanIndex > commands.count()) {
+    m_stack->resetClean();
+  }
+  m_stack->blockSignals(block);
+}
@@ -0,0 +1,102 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TELLICO_UNDOHISTORY_H
+#define TELLICO_UNDOHISTORY_H
+
+#include <QObject>
+
+class QUndoCommand;
+class QUndoStack;
+
+namespace Tellico {
+  namespace Command {
+    class CommandGroup;
+
+/**
+ * The UndoHistory runs the commands and keeps them on an undo stack, dropping the
+ * oldest ones once the commands which can be undone use more memory than allowed.
+ *
+ * QUndoStack only drops old commands to stay under a count limit, which can't be
+ * changed once anything was pushed. So every command is pushed in a thin wrapper,
+ * and when the history grows too large, the stack is rebuilt from the newer ones.
+ *
+ * @author Robby Stephenson
+ */
+class UndoHistory : public QObject {
+Q_OBJECT
+
+public:
+  explicit UndoHistory(QObject* parent = nullptr);
+  ~UndoHistory();
+
+  QUndoStack* stack() const { return m_stack; }
+
+  /**
+   * Sets the most memory the commands which can be undone may use, in bytes.
+   * The most recent command is always kept. Zero means no limit.
+   */
+  void setMemoryLimit(qulonglong bytes);
+  qulonglong memoryLimit() const { return m_memoryLimit; }
+  /**
+   * Returns an estimate of the memory used by the commands which can be undone, in bytes.
+   */
+  qulonglong memoryUsed() const;
+
+  /**
+   * Runs the command and takes ownership of it. Within a group, the command
+   * becomes part of the group.
+   */
+  void push(QUndoCommand* command);
+  /**
+   * The commands pushed until the matching endGroup() are undone as a single step.
+   * Groups may be nested, in which case only the outermost one counts.
+   */
+  void beginGroup(const QString& text);
+  void endGroup();
+  /**
+   * Removes every command, and marks the current state as clean.
+   */
+  void clear();
+
+  /**
+   * Returns an estimate of the memory used by a command and its children, in bytes.
+   */
+  static qulonglong commandSize(const QUndoCommand* command);
+
+private:
+  Q_DISABLE_COPY(UndoHistory)
+
+  void trim();
+
+  QUndoStack* m_stack;
+  qulonglong m_memoryLimit;
+  CommandGroup* m_group;
+  int m_groupDepth;
+};
+
+  } // end namespace
+}
+
+#endif
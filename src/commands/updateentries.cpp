@@ -63,7 +63,7 @@ public:
     : QUndoCommand(updater)
     , m_currEntry(currEntry_)
     , m_newEntry(newEntry_)
-    , m_orphanEntry(new Data::Entry(*currEntry_))
+    , m_orphanEntry(currEntry_->copyWithDates())
     , m_overWrite(overWrite_) {
     // we merge the entries here instead of in redo() because this
     // command is never called without also calling ModifyEntries()
@@ -137,3 +137,8 @@ void UpdateEntries::redo() {
   // calls redo() on all child commands
   QUndoCommand::redo();
 }
+
+qsizetype UpdateEntries::sizeInBytes() const {
+  // the entry being updated is in the collection, and the child commands count themselves
+  return sizeof(UpdateEntries) + entrySize(Data::EntryList() << m_newEntry);
+}
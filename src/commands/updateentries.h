@@ -25,7 +25,7 @@
 #ifndef TELLICO_UPDATEENTRIES_H
 #define TELLICO_UPDATEENTRIES_H
 
-#include "../datavectors.h"
+#include "sizedcommand.h"
 
 #include <QUndoCommand>
 
@@ -35,13 +35,15 @@ namespace Tellico {
 /**
  * @author Robby Stephenson
  */
-class UpdateEntries : public QUndoCommand {
+class UpdateEntries : public QUndoCommand, public SizedCommand {
 
 public:
   UpdateEntries(Data::CollPtr coll, Data::EntryPtr oldEntry, Data::EntryPtr newEntry, bool overWrite);
 
   virtual void redo() override;
 
+  virtual qsizetype sizeInBytes() const override;
+
 private:
   Data::CollPtr m_coll;
   Data::EntryPtr m_oldEntry;
@@ -63,14 +63,6 @@ Controller::Controller(Tellico::MainWindow* parent_)
 Controller::~Controller() {
 }
 
-void Controller::addObserver(Tellico::Observer* obs) {
-  m_observers.append(obs);
-}
-
-void Controller::removeObserver(Tellico::Observer* obs) {
-  m_observers.removeAll(obs);
-}
-
 QString Controller::groupBy() const {
   return m_mainWindow->m_groupView->groupBy();
 }
@@ -111,6 +103,8 @@ Tellico::Data::EntryList Controller::visibleEntries() {
 
 void Controller::slotCollectionAdded(Tellico::Data::CollPtr coll_) {
   MARK;
+  // a transaction left open for the previous collection must not hold back the new one
+  m_transaction.reset();
   // at start-up, this might get called too early, so check and bail
   if(!coll_ || !m_mainWindow->m_groupView) {
     return;
@@ -124,6 +118,8 @@ void Controller::slotCollectionAdded(Tellico::Data::CollPtr coll_) {
 
   m_mainWindow->m_detailedView->addCollection(coll_);
   m_mainWindow->m_groupView->addCollection(coll_);
+  // start grouping by the default field in the background, too, since it's likely to be used
+  coll_->prepareEntryGroupDicts(QStringList() << coll_->defaultGroupField());
   m_mainWindow->m_editDialog->resetLayout(coll_);
   if(!coll_->filters().isEmpty()) {
     m_mainWindow->addFilterView();
@@ -177,6 +173,8 @@ void Controller::slotCollectionModified(Tellico::Data::CollPtr coll_, bool struc
   m_mainWindow->m_editDialog->setContents(m_selectedEntries);
   m_mainWindow->m_detailedView->addCollection(coll_);
   m_mainWindow->m_groupView->addCollection(coll_);
+  // start grouping by the default field in the background, too, since it's likely to be used
+  coll_->prepareEntryGroupDicts(QStringList() << coll_->defaultGroupField());
   if(!coll_->filters().isEmpty()) {
     m_mainWindow->addFilterView();
     m_mainWindow->m_filterView->addCollection(coll_);
@@ -196,6 +194,8 @@ void Controller::slotCollectionModified(Tellico::Data::CollPtr coll_, bool struc
 }
 
 void Controller::slotCollectionDeleted(Tellico::Data::CollPtr coll_) {
+  // the pending changes refer to entries the views are about to drop
+  m_transaction.reset();
   blockAllSignals(true);
   m_mainWindow->saveCollectionOptions(coll_);
   m_mainWindow->m_groupView->removeCollection(coll_);
@@ -221,10 +221,12 @@ void Controller::slotFieldAdded(Tellico::Data::CollPtr coll_, Tellico::Data::Fie
 
 // TODO: should be adding entries to models rather than to widget observers
 void Controller::addedEntries(Tellico::Data::EntryList entries_) {
-  blockAllSignals(true);
-  foreach(Observer* obs, m_observers) {
-    obs->addEntries(entries_);
+  if(m_transaction.isOpen()) {
+    m_transaction.addEntries(entries_);
+    return;
   }
+  blockAllSignals(true);
+  ChangeNotifier::addedEntries(entries_);
   m_mainWindow->slotQueueFilter();
   blockAllSignals(false);
 }
@@ -236,10 +238,12 @@ void Controller::modifiedEntries(Tellico::Data::EntryList entries_) {
   if(!m_mainWindow->m_initialized) {
     return;
   }
-  blockAllSignals(true);
-  foreach(Observer* obs, m_observers) {
-    obs->modifyEntries(entries_);
+  if(m_transaction.isOpen()) {
+    m_transaction.modifyEntries(entries_);
+    return;
   }
+  blockAllSignals(true);
+  ChangeNotifier::modifiedEntries(entries_);
   m_mainWindow->m_entryView->slotRefresh(); // special case
   blockAllSignals(false);
 
@@ -247,10 +251,12 @@ void Controller::modifiedEntries(Tellico::Data::EntryList entries_) {
 }
 
 void Controller::removedEntries(Tellico::Data::EntryList entries_) {
-  blockAllSignals(true);
-  foreach(Observer* obs, m_observers) {
-    obs->removeEntries(entries_);
+  if(m_transaction.isOpen()) {
+    m_transaction.removeEntries(entries_);
+    return;
   }
+  blockAllSignals(true);
+  ChangeNotifier::removedEntries(entries_);
   foreach(Data::EntryPtr entry, entries_) {
     m_selectedEntries.removeAll(entry);
   }
@@ -260,33 +266,28 @@ void Controller::removedEntries(Tellico::Data::EntryList entries_) {
 }
 
 void Controller::addedField(Tellico::Data::CollPtr coll_, Tellico::Data::FieldPtr field_) {
-  foreach(Observer* obs, m_observers) {
-    obs->addField(coll_, field_);
-  }
+  ChangeNotifier::addedField(coll_, field_);
   m_mainWindow->m_entryView->slotRefresh();
   m_mainWindow->slotUpdateCollectionToolBar(coll_);
   m_mainWindow->slotQueueFilter();
 }
 
 void Controller::removedField(Tellico::Data::CollPtr coll_, Tellico::Data::FieldPtr field_) {
-  foreach(Observer* obs, m_observers) {
-    obs->removeField(coll_, field_);
-  }
+  ChangeNotifier::removedField(coll_, field_);
   m_mainWindow->m_entryView->slotRefresh();
   m_mainWindow->slotUpdateCollectionToolBar(coll_);
   m_mainWindow->slotQueueFilter();
 }
 
 void Controller::modifiedField(Tellico::Data::CollPtr coll_, Tellico::Data::FieldPtr oldField_, Tellico::Data::FieldPtr newField_) {
-  foreach(Observer* obs, m_observers) {
-    obs->modifyField(coll_, oldField_, newField_);
-  }
+  ChangeNotifier::modifiedField(coll_, oldField_, newField_);
   m_mainWindow->m_entryView->slotRefresh();
   m_mainWindow->slotUpdateCollectionToolBar(coll_);
   m_mainWindow->slotQueueFilter();
 }
 
 void Controller::reorderedFields(Tellico::Data::CollPtr coll_) {
+  ChangeNotifier::reorderedFields(coll_);
   m_mainWindow->m_editDialog->resetLayout(coll_);
   m_mainWindow->m_detailedView->reorderFields(coll_->fields());
   m_mainWindow->slotUpdateCollectionToolBar(coll_);
@@ -600,35 +601,23 @@ void Controller::updateActions() const {
 
 void Controller::addedBorrower(Tellico::Data::BorrowerPtr borrower_) {
   m_mainWindow->addLoanView(); // just in case
-  foreach(Observer* obs, m_observers) {
-    obs->addBorrower(borrower_);
-  }
+  ChangeNotifier::addedBorrower(borrower_);
   m_mainWindow->m_entryView->slotRefresh(); // special case if the new borrower should be shown in view
 }
 
 void Controller::modifiedBorrower(Tellico::Data::BorrowerPtr borrower_) {
-  foreach(Observer* obs, m_observers) {
-    if(borrower_->isEmpty()) {
-      obs->removeBorrower(borrower_);
-    } else {
-      obs->modifyBorrower(borrower_);
-    }
-  }
+  ChangeNotifier::modifiedBorrower(borrower_);
   m_mainWindow->m_entryView->slotRefresh(); // special case if the borrower goes away
   hideTabs();
 }
 
 void Controller::addedFilter(Tellico::FilterPtr filter_) {
   m_mainWindow->addFilterView(); // just in case
-  foreach(Observer* obs, m_observers) {
-    obs->addFilter(filter_);
-  }
+  ChangeNotifier::addedFilter(filter_);
 }
 
 void Controller::removedFilter(Tellico::FilterPtr filter_) {
-  foreach(Observer* obs, m_observers) {
-    obs->removeFilter(filter_);
-  }
+  ChangeNotifier::removedFilter(filter_);
   hideTabs();
 }
 
@@ -696,6 +685,10 @@ void Controller::slotCheckIn(const Tellico::Data::EntryList& entries_) {
   hideTabs(); // maybe hide loaned tab
 }
 
+void Controller::checkIn(const Tellico::Data::EntryList& entries_) {
+  slotCheckIn(entries_);
+}
+
 void Controller::hideTabs() const {
   bool hasFilterView = m_mainWindow->m_filterView;
   if(hasFilterView && m_mainWindow->m_filterView->isEmpty()) {
@@ -26,6 +26,7 @@
 #define TELLICO_CONTROLLER_H
 
 #include "entry.h"
+#include "changenotifier.h"
 
 #include <QObject>
 #include <QList>
@@ -37,12 +38,11 @@ namespace Tellico {
   namespace Data {
     class Collection;
   }
-  class Observer;
 
 /**
  * @author Robby Stephenson
  */
-class Controller : public QObject {
+class Controller : public QObject, public ChangeNotifier {
 Q_OBJECT
 
 public:
@@ -91,24 +91,23 @@ public:
    */
   QStringList visibleColumns() const;
 
-  void    addObserver(Observer* obs);
-  void removeObserver(Observer* obs);
+  void addedField(Data::CollPtr coll, Data::FieldPtr field) override;
+  void modifiedField(Data::CollPtr coll, Data::FieldPtr oldField, Data::FieldPtr newField) override;
+  void removedField(Data::CollPtr coll, Data::FieldPtr field) override;
+  void reorderedFields(Data::CollPtr coll) override;
 
-  void addedField(Data::CollPtr coll, Data::FieldPtr field);
-  void modifiedField(Data::CollPtr coll, Data::FieldPtr oldField, Data::FieldPtr newField);
-  void removedField(Data::CollPtr coll, Data::FieldPtr field);
+  void addedEntries(Data::EntryList entries) override;
+  void modifiedEntries(Data::EntryList entries) override;
+  void removedEntries(Data::EntryList entries) override;
 
-  void addedEntries(Data::EntryList entries);
-  void modifiedEntries(Data::EntryList entries);
-  void removedEntries(Data::EntryList entries);
+  void addedBorrower(Data::BorrowerPtr borrower) override;
+  void modifiedBorrower(Data::BorrowerPtr borrower) override;
 
-  void addedBorrower(Data::BorrowerPtr borrower);
-  void modifiedBorrower(Data::BorrowerPtr borrower);
+  void addedFilter(FilterPtr filter) override;
+  void removedFilter(FilterPtr filter) override;
 
-  void addedFilter(FilterPtr filter);
-  void removedFilter(FilterPtr filter);
+  void checkIn(const Data::EntryList& entries) override;
 
-  void reorderedFields(Data::CollPtr coll);
   void updatedFetchers();
 
   void clearFilter();
@@ -164,9 +163,6 @@ private:
 
   bool m_working;
 
-  typedef QList<Tellico::Observer*> ObserverList;
-  ObserverList m_observers;
-
   /**
    * Keep track of the selected entries so that a top-level delete has something for reference
    */
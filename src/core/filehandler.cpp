@@ -221,7 +221,23 @@ bool FileHandler::writeBackupFile(const QUrl& url_) {
 }
 
 bool FileHandler::writeTextURL(const QUrl& url_, const QString& text_, bool encodeUTF8_, bool force_, bool quiet_) {
-  if((!force_ && !queryExists(url_)) || text_.isNull()) {
+  if(text_.isNull()) {
+    return false;
+  }
+  bool written = false;
+  auto nextText = [&text_, &written]() -> QString {
+    if(written) {
+      return QString();
+    }
+    written = true;
+    return text_;
+  };
+  return writeTextURL(url_, nextText, encodeUTF8_, force_, quiet_);
+}
+
+bool FileHandler::writeTextURL(const QUrl& url_, const std::function<QString()>& nextText_, bool encodeUTF8_,
+                               bool force_, bool quiet_) {
+  if(!force_ && !queryExists(url_)) {
     return false;
   }
 
@@ -231,7 +247,7 @@ bool FileHandler::writeTextURL(const QUrl& url_, const QString& text_, bool enco
     if(url_.fileName() == QLatin1String("--") &&
        url_.adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash).path() == QDir::currentPath()) {
       QTextStream ts(stdout);
-      writeTextStream(ts, text_, encodeUTF8_);
+      writeTextStream(ts, nextText_, encodeUTF8_);
       return true;
     }
     QSaveFile f(url_.toLocalFile());
@@ -241,7 +257,7 @@ bool FileHandler::writeTextURL(const QUrl& url_, const QString& text_, bool enco
       }
       return false;
     }
-    return FileHandler::writeTextFile(f, text_, encodeUTF8_);
+    return FileHandler::writeTextFile(f, nextText_, encodeUTF8_);
   }
 
   // save to remote file
@@ -259,7 +275,7 @@ bool FileHandler::writeTextURL(const QUrl& url_, const QString& text_, bool enco
     return false;
   }
 
-  bool success = FileHandler::writeTextFile(f, text_, encodeUTF8_);
+  bool success = FileHandler::writeTextFile(f, nextText_, encodeUTF8_);
   if(success) {
     KIO::Job* job = KIO::file_copy(QUrl::fromLocalFile(tempfile.fileName()), url_, -1, KIO::Overwrite);
     KJobWidgets::setWindow(job, GUI::Proxy::widget());
@@ -273,9 +289,10 @@ bool FileHandler::writeTextURL(const QUrl& url_, const QString& text_, bool enco
   return success;
 }
 
-bool FileHandler::writeTextFile(QSaveFile& file_, const QString& text_, bool encodeUTF8_) {
+bool FileHandler::writeTextFile(QSaveFile& file_, const std::function<QString()>& nextText_, bool encodeUTF8_) {
   QTextStream ts(&file_);
-  writeTextStream(ts, text_, encodeUTF8_);
+  writeTextStream(ts, nextText_, encodeUTF8_);
+  ts.flush();
   file_.flush();
   const bool success = file_.commit();
   if(!success) {
@@ -284,13 +301,17 @@ bool FileHandler::writeTextFile(QSaveFile& file_, const QString& text_, bool enc
   return success;
 }
 
-void FileHandler::writeTextStream(QTextStream& ts_, const QString& text_, bool encodeUTF8_) {
+void FileHandler::writeTextStream(QTextStream& ts_, const std::function<QString()>& nextText_, bool encodeUTF8_) {
   if(encodeUTF8_) {
     ts_.setEncoding(QStringConverter::Utf8);
   }
-  // KDE Bug 380832. If string is longer than MAX_TEXT_CHUNK_WRITE_SIZE characters, split into chunks.
-  for(int i = 0; i < text_.length(); i += MAX_TEXT_CHUNK_WRITE_SIZE) {
-    ts_ << text_.mid(i, MAX_TEXT_CHUNK_WRITE_SIZE);
+  for(QString text = nextText_(); !text.isNull(); text = nextText_()) {
+    // KDE Bug 380832. If string is longer than MAX_TEXT_CHUNK_WRITE_SIZE characters, split into chunks.
+    for(qsizetype i = 0; i < text.length(); i += MAX_TEXT_CHUNK_WRITE_SIZE) {
+      ts_ << QStringView(text).mid(i, MAX_TEXT_CHUNK_WRITE_SIZE);
+    }
+    // hand each piece to the device as it comes, rather than buffering the whole text
+    ts_.flush();
   }
 }
 
@@ -28,6 +28,8 @@
 #include <QString>
 #include <QByteArray>
 
+#include <functional>
+
 class QUrl;
 
 namespace KIO {
@@ -133,6 +135,19 @@ public:
    * @return A boolean indicating success
    */
   static bool writeTextURL(const QUrl& url, const QString& text, bool encodeUTF8, bool force=false, bool quiet=false);
+  /**
+   * Writes text to a url as it is generated, so the complete text never has to be held in
+   * memory. The @p nextText function is called repeatedly until it returns a null string, and
+   * each piece is encoded and written out before the next one is requested.
+   *
+   * @param url The url
+   * @param nextText The function returning the next piece of text
+   * @param encodeUTF8 Whether to use UTF-8 encoding, or Locale
+   * @param force Whether to force the write
+   * @return A boolean indicating success
+   */
+  static bool writeTextURL(const QUrl& url, const std::function<QString()>& nextText, bool encodeUTF8,
+                           bool force=false, bool quiet=false);
   /**
    * Writes data to a url. If the file already exists, a "~" is appended
    * and the existing file is moved. If the file is remote, a temporary file is written and
@@ -160,15 +175,15 @@ public:
 
 private:
   /**
-   * Writes the contents of a string to a file.
+   * Writes text to a file, piece by piece, until @p nextText returns a null string.
    *
    * @param file The file object
-   * @param text The string
+   * @param nextText The function returning the next piece of text
    * @param encodeUTF8 Whether to use UTF-8 encoding, or Locale
    * @return A boolean indicating success
    */
-  static bool writeTextFile(QSaveFile& file, const QString& text, bool encodeUTF8);
-  static void writeTextStream(QTextStream& ts, const QString& text, bool encodeUTF8);
+  static bool writeTextFile(QSaveFile& file, const std::function<QString()>& nextText, bool encodeUTF8);
+  static void writeTextStream(QTextStream& ts, const std::function<QString()>& nextText, bool encodeUTF8);
   /**
    * Writes data to a file.
    *
@@ -38,6 +38,11 @@
 using Tellico::ApplicationInterface;
 using Tellico::CollectionInterface;
 
+namespace {
+  // an open transaction is committed after this long without another collection call
+  static const int DBUS_TRANSACTION_TIMEOUT = 60000;
+}
+
 ApplicationInterface::ApplicationInterface(Tellico::MainWindow* parent_) : QObject(parent_), m_mainWindow(parent_) {
   QDBusConnection::sessionBus().registerObject(QStringLiteral("/Tellico"), this, QDBusConnection::ExportScriptableSlots);
 }
@@ -96,11 +101,16 @@ bool ApplicationInterface::exportCollection(Tellico::Export::Format format, cons
   return m_mainWindow->exportCollection(format, url, filtered);
 }
 
-CollectionInterface::CollectionInterface(QObject* parent_) : QObject(parent_) {
+CollectionInterface::CollectionInterface(QObject* parent_) : QObject(parent_)
+    , m_transactionDepth(0), m_transactionTimer(this) {
+  m_transactionTimer.setSingleShot(true);
+  m_transactionTimer.setInterval(DBUS_TRANSACTION_TIMEOUT);
+  connect(&m_transactionTimer, &QTimer::timeout, this, &CollectionInterface::slotTransactionTimeout);
   QDBusConnection::sessionBus().registerObject(QStringLiteral("/Collections"), this, QDBusConnection::ExportScriptableSlots);
 }
 
 int CollectionInterface::addEntry() {
+  extendTransaction();
   Data::CollPtr coll = Data::Document::self()->collection();
   if(!coll) {
     return -1;
@@ -111,6 +121,7 @@ int CollectionInterface::addEntry() {
 }
 
 bool CollectionInterface::removeEntry(int id_) {
+  extendTransaction();
   Data::CollPtr coll = Data::Document::self()->collection();
   if(!coll) {
     return false;
@@ -193,6 +204,7 @@ QString CollectionInterface::entryBibtexKey(int id_) {
 }
 
 bool CollectionInterface::setEntryValue(int id_, const QString& fieldName_, const QString& value_) {
+  extendTransaction();
   Data::CollPtr coll = Data::Document::self()->collection();
   if(!coll) {
     return false;
@@ -201,7 +213,7 @@ bool CollectionInterface::setEntryValue(int id_, const QString& fieldName_, cons
   if(!entry) {
     return false;
   }
-  Data::EntryPtr oldEntry(new Data::Entry(*entry));
+  Data::EntryPtr oldEntry = entry->copyWithDates();
   if(!entry->setField(fieldName_, value_)) {
     return false;
   }
@@ -211,6 +223,7 @@ bool CollectionInterface::setEntryValue(int id_, const QString& fieldName_, cons
 }
 
 bool CollectionInterface::addEntryValue(int id_, const QString& fieldName_, const QString& value_) {
+  extendTransaction();
   Data::CollPtr coll = Data::Document::self()->collection();
   if(!coll) {
     return false;
@@ -224,7 +237,7 @@ bool CollectionInterface::addEntryValue(int id_, const QString& fieldName_, cons
     return false;
   }
 
-  Data::EntryPtr oldEntry(new Data::Entry(*entry));
+  Data::EntryPtr oldEntry = entry->copyWithDates();
   QStringList values;
   if(field->type() == Data::Field::Table) {
     values = FieldFormat::splitTable(entry->field(fieldName_));
@@ -240,3 +253,36 @@ bool CollectionInterface::addEntryValue(int id_, const QString& fieldName_, cons
   Kernel::self()->modifyEntries(Data::EntryList() << oldEntry, Data::EntryList() << entry, QStringList() << field->name());
   return true;
 }
+
+void CollectionInterface::beginTransaction() {
+  ++m_transactionDepth;
+  m_transactionTimer.start();
+  Kernel::self()->beginTransaction();
+}
+
+void CollectionInterface::commitTransaction() {
+  // a client can't commit more than it began, or commit a transaction that timed out
+  if(m_transactionDepth < 1) {
+    return;
+  }
+  if(--m_transactionDepth == 0) {
+    m_transactionTimer.stop();
+  } else {
+    m_transactionTimer.start();
+  }
+  Kernel::self()->commitTransaction();
+}
+
+void CollectionInterface::slotTransactionTimeout() {
+  myLog() << "Committing" << m_transactionDepth << "D-Bus transactions after timeout";
+  while(m_transactionDepth > 0) {
+    --m_transactionDepth;
+    Kernel::self()->commitTransaction();
+  }
+}
+
+void CollectionInterface::extendTransaction() {
+  if(m_transactionDepth > 0) {
+    m_transactionTimer.start();
+  }
+}
@@ -28,6 +28,7 @@
 #include "../translators/translators.h"
 
 #include <QObject>
+#include <QTimer>
 #include <QUrl>
 #include <QStringList>
 
@@ -101,6 +102,23 @@ public Q_SLOTS:
 
   Q_SCRIPTABLE bool setEntryValue(int entryID, const QString& fieldName, const QString& value);
   Q_SCRIPTABLE bool addEntryValue(int entryID, const QString& fieldName, const QString& value);
+
+  /**
+   * Each client call is a separate message, and command-line tools use a new connection
+   * each time, so a transaction can't be tied to the caller. Instead, the open transactions
+   * are committed if no more collection calls arrive within the timeout.
+   */
+  Q_SCRIPTABLE void beginTransaction();
+  Q_SCRIPTABLE void commitTransaction();
+
+private Q_SLOTS:
+  void slotTransactionTimeout();
+
+private:
+  void extendTransaction();
+
+  int m_transactionDepth;
+  QTimer m_transactionTimer;
 };
 
 } // end namespace
@@ -24,6 +24,7 @@
 
 #include "derivedvalue.h"
 #include "collection.h"
+#include "readonlycollection.h"
 #include "fieldformat.h"
 #include "utils/stringset.h"
 #include "tellico_debug.h"
@@ -92,6 +93,30 @@ QString DerivedValue::value(EntryPtr entry_, bool formatted_) const {
     return m_valueTemplate;
   }
 
+  CollPtr coll = entry_->collection();
+  auto fieldLookup = [coll](const QString& name_) {
+    FieldPtr field = coll->fieldByName(name_);
+    // allow the user to also use field titles
+    return field ? field : coll->fieldByTitle(name_);
+  };
+  auto valueLookup = [entry_](FieldPtr field_, bool format_) {
+    return format_ ? entry_->formattedField(field_) : entry_->field(field_);
+  };
+  return value(entry_->id(), fieldLookup, valueLookup, formatted_);
+}
+
+QString DerivedValue::value(const ReadOnlyCollection& coll_, const ReadOnlyEntry& entry_, bool formatted_) const {
+  auto fieldLookup = [&coll_](const QString& name_) {
+    FieldPtr field = coll_.fieldByName(name_);
+    return field ? field : coll_.fieldByTitle(name_);
+  };
+  auto valueLookup = [&coll_, &entry_](FieldPtr field_, bool format_) {
+    return format_ ? coll_.formattedField(entry_, field_) : coll_.field(entry_, field_);
+  };
+  return value(entry_.id(), fieldLookup, valueLookup, formatted_);
+}
+
+QString DerivedValue::value(ID id_, const FieldLookup& fieldLookup_, const ValueLookup& valueLookup_, bool formatted_) const {
   QString result;
   result.reserve(64); // just a magic number as a guess
   QStringView templateView(m_valueTemplate);
@@ -104,7 +129,8 @@ QString DerivedValue::value(EntryPtr entry_, bool formatted_) const {
       endPos = m_valueTemplate.indexOf(QLatin1Char('}'), pctPos+2);
       if(endPos > -1) {
         result += templateView.sliced(curPos, pctPos-curPos)
-                + templateKeyValue(entry_, templateView.sliced(pctPos+2, endPos-pctPos-2), formatted_);
+                + templateKeyValue(id_, fieldLookup_, valueLookup_,
+                                   templateView.sliced(pctPos+2, endPos-pctPos-2), formatted_);
         curPos = endPos+1;
       } else {
         break;
@@ -138,10 +164,11 @@ QStringList DerivedValue::templateFields() const {
   return list;
 }
 
-QString DerivedValue::templateKeyValue(EntryPtr entry_, QStringView key_, bool formatted_) const {
+QString DerivedValue::templateKeyValue(ID id_, const FieldLookup& fieldLookup_, const ValueLookup& valueLookup_,
+                                       QStringView key_, bool formatted_) const {
   // @id is used often, so avoid regex if possible
   if(key_ == QLatin1StringView("@id")) {
-    return QString::number(entry_->id());
+    return QString::number(id_);
   }
 
   if(m_keyRx.pattern().isEmpty()) {
@@ -154,15 +181,11 @@ QString DerivedValue::templateKeyValue(EntryPtr entry_, QStringView key_, bool f
   }
 
   const QString fieldName = match.captured(1);
-  FieldPtr field = entry_->collection()->fieldByName(fieldName);
-  if(!field) {
-    // allow the user to also use field titles
-    field = entry_->collection()->fieldByTitle(fieldName);
-  }
+  FieldPtr field = fieldLookup_(fieldName);
   if(!field) {
     if(fieldName == QLatin1String("id")) {
       // '@id' is the best way to use it, but formerly, we allowed just 'id'
-      return QString::number(entry_->id());
+      return QString::number(id_);
     } else {
       return QLatin1String("%{") + key_ + QLatin1Char('}');
     }
@@ -172,12 +195,12 @@ QString DerivedValue::templateKeyValue(EntryPtr entry_, QStringView key_, bool f
   QString result;
   if(pos == 0) {
     // insert field value
-    result = formatted_ ? entry_->formattedField(field) : entry_->field(field);
+    result = valueLookup_(field, formatted_);
   } else {
     QStringList values;
     if(field->type() ==  Field::Table) {
       // for tables, only take first column
-      QStringList rows = FieldFormat::splitTable(formatted_ ? entry_->formattedField(field) : entry_->field(field));
+      QStringList rows = FieldFormat::splitTable(valueLookup_(field, formatted_));
       foreach(const QString& row, rows) {
         const QStringList rowValues = FieldFormat::splitRow(row);
         if(!rowValues.isEmpty()) {
@@ -185,7 +208,7 @@ QString DerivedValue::templateKeyValue(EntryPtr entry_, QStringView key_, bool f
         }
       }
     } else {
-      values = FieldFormat::splitValue(formatted_ ? entry_->formattedField(field) : entry_->field(field));
+      values = FieldFormat::splitValue(valueLookup_(field, formatted_));
     }
     if(pos < 0) {
       pos += values.count();
@@ -30,8 +30,12 @@
 
 #include <QRegularExpression>
 
+#include <functional>
+
 namespace Tellico {
   namespace Data {
+    class ReadOnlyCollection;
+    class ReadOnlyEntry;
 
 class DerivedValue {
 public:
@@ -44,11 +48,23 @@ public:
   bool isRecursive(Collection* coll) const;
 
   QString value(EntryPtr entry, bool formatted) const;
+  /**
+   * Returns the value for an entry in a read-only collection, which is safe to call
+   * from any thread.
+   */
+  QString value(const ReadOnlyCollection& coll, const ReadOnlyEntry& entry, bool formatted) const;
 
 private:
+  // returns the field for a name or title in the template
+  typedef std::function<FieldPtr(const QString&)> FieldLookup;
+  // returns the value of a field, formatted or not
+  typedef std::function<QString(FieldPtr, bool)> ValueLookup;
+
+  QString value(ID id, const FieldLookup& fieldLookup, const ValueLookup& valueLookup, bool formatted) const;
   void initRegularExpression() const;
   QStringList templateFields() const;
-  QString templateKeyValue(EntryPtr entry, QStringView key, bool formatted) const;
+  QString templateKeyValue(ID id, const FieldLookup& fieldLookup, const ValueLookup& valueLookup,
+                           QStringView key, bool formatted) const;
 
   QString m_fieldName;
   QString m_valueTemplate;
@@ -46,12 +46,21 @@
 #include <QMouseEvent>
 #include <QHeaderView>
 #include <QContextMenuEvent>
+#include <QElapsedTimer>
+#include <QTimer>
+
+namespace {
+  // the first entries of a collection are shown right away and the rest are added in batches
+  // so the window can be used while the remaining entries get sorted into the view
+  static const int ENTRY_LOAD_FIRST_BATCH = 1000;
+  static const int ENTRY_LOAD_BATCH_SIZE = 5000;
+}
 
 using namespace Tellico;
 using Tellico::DetailedListView;
 
 DetailedListView::DetailedListView(QWidget* parent_) : GUI::TreeView(parent_)
-    , m_loadingCollection(false), m_currentContextColumn(-1) {
+    , m_loadingCollection(false), m_currentContextColumn(-1), m_pendingPos(0) {
   setHeaderHidden(false);
   setSelectionMode(QAbstractItemView::ExtendedSelection);
   setAlternatingRowColors(true);
@@ -173,16 +182,60 @@ void DetailedListView::addCollection(Tellico::Data::CollPtr coll_) {
   const int order = config.readEntry(QLatin1String("SortOrder") + configN, static_cast<int>(Qt::AscendingOrder));
   sortModel()->setSortOrder(static_cast<Qt::SortOrder>(order));
 
+  QElapsedTimer timer;
+  timer.start();
+  const Data::EntryList entries = coll_->entries();
+  m_pendingEntries = entries.mid(ENTRY_LOAD_FIRST_BATCH);
+  m_pendingPos = 0;
   setUpdatesEnabled(false);
   m_loadingCollection = true;
-  addEntries(coll_->entries());
+  addEntries(entries.mid(0, ENTRY_LOAD_FIRST_BATCH));
   m_loadingCollection = false;
   setUpdatesEnabled(true);
+  myLog() << "Added first" << qMin(entries.count(), ENTRY_LOAD_FIRST_BATCH) << "entries in" << timer.elapsed() << "ms";
 
   header()->setSortIndicator(sortModel()->sortColumn(), sortModel()->sortOrder());
+  if(m_pendingEntries.isEmpty()) {
+    Q_EMIT signalEntriesLoaded();
+  } else {
+    QTimer::singleShot(0, this, &DetailedListView::slotAddPendingEntries);
+  }
+}
+
+void DetailedListView::slotAddPendingEntries() {
+  if(m_pendingEntries.isEmpty()) {
+    return;
+  }
+  const Data::EntryList batch = m_pendingEntries.mid(m_pendingPos, ENTRY_LOAD_BATCH_SIZE);
+  m_pendingPos += batch.count();
+  sourceModel()->addEntries(batch);
+  if(m_pendingPos < m_pendingEntries.count()) {
+    QTimer::singleShot(0, this, &DetailedListView::slotAddPendingEntries);
+    return;
+  }
+  myLog() << "Finished adding" << m_pendingEntries.count() << "remaining entries";
+  m_pendingEntries.clear();
+  m_pendingPos = 0;
+  Q_EMIT signalEntriesLoaded();
+}
+
+void DetailedListView::finishLoadingEntries() {
+  if(m_pendingEntries.isEmpty()) {
+    return;
+  }
+  sourceModel()->addEntries(m_pendingEntries.mid(m_pendingPos));
+  m_pendingEntries.clear();
+  m_pendingPos = 0;
+  Q_EMIT signalEntriesLoaded();
+}
+
+bool DetailedListView::isLoadingEntries() const {
+  return !m_pendingEntries.isEmpty();
 }
 
 void DetailedListView::slotReset() {
+  m_pendingEntries.clear();
+  m_pendingPos = 0;
   // clear() does not remove columns
   sourceModel()->clear();
 }
@@ -191,6 +244,9 @@ void DetailedListView::addEntries(Tellico::Data::EntryList entries_) {
   if(entries_.isEmpty()) {
     return;
   }
+  if(!m_loadingCollection) {
+    finishLoadingEntries();
+  }
   sourceModel()->addEntries(entries_);
   if(!m_loadingCollection) {
     setState(entries_, NewState);
@@ -204,6 +260,7 @@ void DetailedListView::modifyEntries(Tellico::Data::EntryList entries_) {
   if(entries_.isEmpty()) {
     return;
   }
+  finishLoadingEntries();
   sourceModel()->modifyEntries(entries_);
   setState(entries_, ModifiedState);
 }
@@ -212,6 +269,7 @@ void DetailedListView::removeEntries(Tellico::Data::EntryList entries_) {
   if(entries_.isEmpty()) {
     return;
   }
+  finishLoadingEntries();
   sourceModel()->removeEntries(entries_);
 }
 
@@ -232,6 +290,8 @@ void DetailedListView::removeCollection(Tellico::Data::CollPtr coll_) {
     return;
   }
 
+  m_pendingEntries.clear();
+  m_pendingPos = 0;
   sourceModel()->clear();
 }
 
@@ -254,6 +314,7 @@ void DetailedListView::setEntriesSelected(Data::EntryList entries_) {
     return;
   }
 
+  finishLoadingEntries();
   clearSelection();
   EntrySortModel* proxyModel = static_cast<EntrySortModel*>(model());
   foreach(Data::EntryPtr entry, entries_) {
@@ -488,6 +549,7 @@ QStringList DetailedListView::visibleColumns() const {
 Tellico::Data::EntryList DetailedListView::visibleEntries() {
   // We could just return the full collection entry list if the filter is 0
   // but printing depends on the sorted order
+  finishLoadingEntries();
   Data::EntryList entries;
   for(int i = 0; i < model()->rowCount(); ++i) {
     Data::EntryPtr tmp = model()->data(model()->index(i, 0), EntryPtrRole).value<Data::EntryPtr>();
@@ -499,6 +561,7 @@ Tellico::Data::EntryList DetailedListView::visibleEntries() {
 }
 
 void DetailedListView::selectAllVisible() {
+  finishLoadingEntries();
   QModelIndex topLeft = model()->index(0, 0);
   QModelIndex bottomRight = model()->index(model()->rowCount()-1, model()->columnCount()-1);
   QItemSelection selection(topLeft, bottomRight);
@@ -506,6 +569,10 @@ void DetailedListView::selectAllVisible() {
 }
 
 int DetailedListView::visibleItems() const {
+  // until all the entries are added, only an unfiltered count is known
+  if(isLoadingEntries() && !filter()) {
+    return model()->rowCount() + m_pendingEntries.count() - m_pendingPos;
+  }
   return model()->rowCount();
 }
 
@@ -122,6 +122,16 @@ public:
    */
   void selectAllVisible();
   int visibleItems() const;
+  /**
+   * Returns true while the entries of a newly added collection are still being added.
+   */
+  bool isLoadingEntries() const;
+
+Q_SIGNALS:
+  /**
+   * Signals that all the entries of a newly added collection have been added.
+   */
+  void signalEntriesLoaded();
 
 public Q_SLOTS:
   /**
@@ -145,6 +155,7 @@ private Q_SLOTS:
   void hideNewColumn(const QModelIndex& index, int start, int end);
 //  void slotCacheColumnWidth(int section, int oldSize, int newSize);
   void updateColumnDelegates();
+  void slotAddPendingEntries();
 
 private:
   void contextMenuEvent(QContextMenuEvent* event) override;
@@ -152,6 +163,10 @@ private:
   void adjustColumnWidths();
   void checkHeader();
   QString columnFieldName(int ncol) const;
+  /**
+   * Adds all the entries still waiting to be shown.
+   */
+  void finishLoadingEntries();
 
   struct ConfigInfo {
     QStringList cols;
@@ -166,6 +181,9 @@ private:
   QMenu* m_columnMenu;
   bool m_loadingCollection;
   int m_currentContextColumn;
+  // the entries of a new collection which still need to be added to the model
+  Data::EntryList m_pendingEntries;
+  int m_pendingPos;
 };
 
 } // end namespace;
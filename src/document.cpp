@@ -23,6 +23,7 @@
  ***************************************************************************/
 
 #include "document.h"
+#include "documentjournal.h"
 #include "collectionfactory.h"
 #include "translators/tellicoimporter.h"
 #include "translators/tellicozipexporter.h"
@@ -48,6 +49,7 @@
 #include <KLocalizedString>
 
 #include <QApplication>
+#include <QElapsedTimer>
 
 using namespace Tellico;
 using Tellico::Data::Document;
@@ -55,10 +57,13 @@ Document* Document::s_self = nullptr;
 
 Document::Document() : QObject(), m_coll(nullptr), m_isModified(false),
     m_loadAllImages(false), m_validFile(false), m_importer(nullptr), m_cancelImageWriting(true),
-    m_fileFormat(Import::TellicoImporter::Unknown), m_loadImagesTimer(this) {
+    m_fileFormat(Import::TellicoImporter::Unknown), m_loadImagesTimer(this),
+    m_journal(new DocumentJournal(this)) {
   m_loadImagesTimer.setSingleShot(true);
   m_loadImagesTimer.setInterval(500);
   connect(&m_loadImagesTimer, &QTimer::timeout, this, &Document::slotLoadAllImages);
+  // appending or merging another collection gets compacted into a checkpoint right away
+  connect(this, &Document::signalCollectionModified, m_journal, &DocumentJournal::collectionModified);
   newDocument(Collection::Book);
 }
 
@@ -76,12 +81,14 @@ void Document::setURL(const QUrl& url_) {
   if(m_url.fileName() != TC_I18N1(Tellico::untitledFilename)) {
     ImageFactory::setLocalDirectory(m_url);
     EntryComparison::setDocumentUrl(m_url);
+    m_journal->setUrl(m_url);
   } else {
     // important to set the local directory so new temporary images are not saved incorrectly
     // rather than passing the untitle file name, we want an empty url
     // per ImageFactory::cacheDir() logic
     QUrl u;
     ImageFactory::setLocalDirectory(u);
+    m_journal->setUrl(u);
   }
 }
 
@@ -151,6 +158,8 @@ bool Document::openDocument(const QUrl& url_) {
   connect(&item, &ProgressItem::signalCancelled, m_importer, &Import::Importer::slotCancel);
   ProgressItem::Done done(m_importer);
 
+  QElapsedTimer timer;
+  timer.start();
   CollPtr coll = m_importer->collection();
   if(!m_importer) {
     myDebug() << "The importer was deleted out from under the document";
@@ -171,14 +180,23 @@ bool Document::openDocument(const QUrl& url_) {
   }
   deleteContents();
   m_coll = coll;
-  m_coll->setTrackGroups(true);
   setURL(url_);
+  // changes from an earlier session that didn't end with the file being saved
+  const bool recovered = m_journal->recover(m_coll);
+  m_coll->setTrackGroups(true);
   m_validFile = true;
+  myLog() << "Read" << m_coll->entryCount() << "entries in" << timer.restart() << "ms";
 
+  // the views show the first entries and build the groups in the background,
+  // and the images are only loaded after the collection is showing
   Q_EMIT signalCollectionAdded(m_coll);
+  myLog() << "Added the collection to the views in" << timer.elapsed() << "ms";
 
   // m_importer might have been deleted?
-  setModified(m_importer && m_importer->modifiedOriginal());
+  setModified(recovered || (m_importer && m_importer->modifiedOriginal()));
+  if(recovered) {
+    Q_EMIT signalStatusMsg(i18n("Recovered the unsaved changes from the last session."));
+  }
 //  if(pruneImages()) {
 //    slotSetModified(true);
 //  }
@@ -253,6 +271,8 @@ bool Document::saveDocument(const QUrl& url_, bool force_) {
   item.setProgress(int(0.9*totalSteps));
 
   if(success) {
+    // everything in the journal is in the file now
+    m_journal->discard();
     setURL(url_);
     // if successful, doc is no longer modified
     setModified(false);
@@ -541,6 +561,7 @@ void Document::checkInEntry(Tellico::Data::EntryPtr entry_) {
 
 void Document::renameCollection(const QString& newTitle_) {
   m_coll->setTitle(newTitle_);
+  m_journal->renameCollection(newTitle_);
 }
 
 // this only gets called when a file with images include (either zip or xml) is opened
@@ -548,53 +569,60 @@ void Document::renameCollection(const QString& newTitle_) {
 // copied to disk. Then the file can be closed and not retained in memory
 void Document::slotLoadAllImages() {
   myLog() << "Loading all images into cache...";
+  QElapsedTimer timer;
+  timer.start();
   QString id;
   StringSet images;
+  QStringList imageIds;
   foreach(EntryPtr entry, m_coll->entries()) {
     foreach(FieldPtr field, m_coll->imageFields()) {
       id = entry->field(field);
       if(id.isEmpty() || images.contains(id)) {
         continue;
       }
-      // this is the early loading, so just by calling imageById()
-      // the image gets sucked from the file and written to disk
-      // by ImageFactory::imageById()
-      // TODO:: does this need to check against images with link only?
-      if(ImageFactory::imageById(id).isNull()) {
-        myLog() << "Null image for entry:" << entry->title() << id;
-      }
       images.add(id);
-      if(m_cancelImageWriting) {
-        break;
+      // only the images still in the zip file need to be written to disk, and never the link-only ones
+      if(!ImageFactory::hasImageInZipArchive(id) || ImageFactory::imageInfo(id).linkOnly) {
+        continue;
       }
+      imageIds << id;
     }
-    if(m_cancelImageWriting) {
-      break;
-    }
-    // stay responsive, do this in the background
-    qApp->processEvents();
   }
 
-  if(m_cancelImageWriting) {
-    myLog() << "slotLoadAllImages() - cancel image writing";
-  } else {
-    Q_EMIT signalCollectionImagesLoaded(m_coll);
-  }
+  // this is the early loading, so the images get sucked from the file and written to disk
+  // by worker threads, in the background
+  Data::CollPtr coll = m_coll;
+  ImageFactory::requestWriteCachedImages(imageIds, ImageFactory::TempDir, [this, coll](int) {
+    return !m_cancelImageWriting && m_coll == coll;
+  }, [this, coll, timer, imageIds](const QStringList& failed) {
+    foreach(const QString& failedId, failed) {
+      myLog() << "Null image:" << failedId;
+    }
+    // a different document might have been opened in the meantime
+    if(m_coll != coll) {
+      myLog() << "slotLoadAllImages() - collection was closed";
+      return;
+    }
 
-  m_cancelImageWriting = false;
-  if(m_importer) {
-    m_importer->deleteLater();
-    m_importer = nullptr;
-  }
+    if(m_cancelImageWriting) {
+      myLog() << "slotLoadAllImages() - cancel image writing";
+    } else {
+      myLog() << "Loaded" << imageIds.count() << "images in" << timer.elapsed() << "ms";
+      Q_EMIT signalCollectionImagesLoaded(m_coll);
+    }
+
+    m_cancelImageWriting = false;
+    if(m_importer) {
+      m_importer->deleteLater();
+      m_importer = nullptr;
+    }
+  });
 }
 
 // cacheDir_ is the location dir to write the images
 // localDir_ provide the new file location which is only needed if cacheDir == LocalDir
 void Document::writeAllImages(int cacheDir_, const QUrl& localDir_) {
   // images get 80 steps in saveDocument()
-  const uint stepSize = 1 + qMax(1, m_coll->entryCount()/80); // add 1 since it could round off
-  uint j = 1;
-
   ImageFactory::CacheDir cacheDir = static_cast<ImageFactory::CacheDir>(cacheDir_);
   QScopedPointer<ImageDirectory> imgDir;
   if(cacheDir == ImageFactory::LocalDir) {
@@ -603,6 +631,7 @@ void Document::writeAllImages(int cacheDir_, const QUrl& localDir_) {
 
   QString id;
   StringSet images;
+  QStringList imageIds;
   EntryList entries = m_coll->entries();
   FieldList imageFields = m_coll->imageFields();
   foreach(EntryPtr entry, entries) {
@@ -615,27 +644,23 @@ void Document::writeAllImages(int cacheDir_, const QUrl& localDir_) {
       if(ImageFactory::imageInfo(id).linkOnly) {
         continue;
       }
-      // careful here, if we're writing to LocalDir, need to read from the old LocalDir and write to new
-      bool success;
-      if(imgDir) {
-        success = ImageFactory::writeCachedImage(id, imgDir.data());
-      } else {
-        success = ImageFactory::writeCachedImage(id, cacheDir);
-      }
-      if(!success) {
-        myLog() << "Failed to write image for entry title:" << entry->title();
-      }
-      if(m_cancelImageWriting) {
-        break;
-      }
+      imageIds << id;
     }
-    if(j%stepSize == 0) {
-      ProgressManager::self()->setProgress(this, j/stepSize);
-    }
-    ++j;
-    if(m_cancelImageWriting) {
-      break;
+  }
+
+  // the progress steps are counted by images rather than entries
+  const int stepSize = 1 + qMax(1, imageIds.count()/80); // add 1 since it could round off
+  auto progress = [this, stepSize](int count) {
+    if(count%stepSize == 0) {
+      ProgressManager::self()->setProgress(this, count/stepSize);
     }
+    return !m_cancelImageWriting;
+  };
+  // careful here, if we're writing to LocalDir, need to read from the old LocalDir and write to new
+  const QStringList failed = imgDir ? ImageFactory::writeCachedImages(imageIds, imgDir.data(), progress)
+                                    : ImageFactory::writeCachedImages(imageIds, cacheDir, progress);
+  foreach(const QString& failedId, failed) {
+    myLog() << "Failed to write image:" << failedId;
   }
 
   // for saving to local directory, might need to remove images who are no longer in collection
@@ -40,6 +40,7 @@ namespace Tellico {
   }
 
   namespace Data {
+    class DocumentJournal;
 
 /**
  * The Document contains everything needed to deal with the contents, thus separated from
@@ -171,6 +172,10 @@ public:
    */
   void removeImagesNotInCollection(EntryList entries, EntryList entriesToKeep);
   void cancelImageWriting() { m_cancelImageWriting = true; }
+  /**
+   * The journal of changes made since the document was saved
+   */
+  DocumentJournal* journal() const { return m_journal; }
 
 public Q_SLOTS:
   /**
@@ -232,6 +237,7 @@ private:
   bool m_cancelImageWriting;
   int m_fileFormat;
   QTimer m_loadImagesTimer;
+  DocumentJournal* m_journal;
 };
 
   } // end namespace
@@ -0,0 +1,804 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "documentjournal.h"
+#include "document.h"
+#include "collection.h"
+#include "readonlycollection.h"
+#include "entry.h"
+#include "field.h"
+#include "borrower.h"
+#include "filter.h"
+#include "config/tellico_config.h"
+#include "tellico_debug.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QCryptographicHash>
+#include <QStandardPaths>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QSet>
+#include <QUrl>
+#include <QtConcurrentRun>
+
+#include <limits>
+
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#elif defined(Q_OS_WIN)
+#include <io.h>
+#endif
+
+namespace {
+  static const quint32 JOURNAL_MAGIC = 0x54434a4c; // "TCJL"
+  // increment whenever the layout changes, older journals just get discarded
+  static const qint32 JOURNAL_VERSION = 2;
+  static const QDataStream::Version JOURNAL_STREAM_VERSION = QDataStream::Qt_6_0;
+  // a journal larger than this gets compacted into a checkpoint of the collection
+  static const qint64 JOURNAL_COMPACT_SIZE = 8*1024*1024;
+  // wait for a pause in the changes before compacting a large journal
+  static const int JOURNAL_COMPACT_DELAY = 5000;
+
+  // a record is only useful once it's actually on the disk
+  void syncHandle(int handle_) {
+#ifdef Q_OS_UNIX
+    ::fsync(handle_);
+#elif defined(Q_OS_WIN)
+    ::_commit(handle_);
+#endif
+  }
+
+  struct JournalHeader {
+    quint32 magic = 0;
+    qint32 version = 0;
+    qint32 seq = -1;
+    qint64 sourceSize = -1;
+    qint64 sourceTime = -1;
+  };
+
+  QDataStream& operator<<(QDataStream& out_, const JournalHeader& header_) {
+    return out_ << header_.magic << header_.version << header_.seq << header_.sourceSize << header_.sourceTime;
+  }
+
+  QDataStream& operator>>(QDataStream& in_, JournalHeader& header_) {
+    return in_ >> header_.magic >> header_.version >> header_.seq >> header_.sourceSize >> header_.sourceTime;
+  }
+
+  // each record is preceded by its size and checksum, so an incomplete record at the end
+  // of the journal can be recognized and dropped
+  void writeRecord(QDataStream& out_, const QByteArray& record_) {
+    out_ << quint32(record_.size()) << quint16(qChecksum(record_));
+    out_.writeRawData(record_.constData(), record_.size());
+  }
+
+  // the whole definition is written, so replaying a field keeps its type, flags, and allowed values
+  void writeField(QDataStream& out_, Tellico::Data::FieldPtr field_) {
+    out_ << field_->name() << field_->title() << field_->category() << field_->description()
+         << qint32(field_->type()) << qint32(field_->flags()) << qint32(field_->formatType())
+         << field_->allowed() << field_->propertyList();
+  }
+
+  Tellico::Data::FieldPtr readField(QDataStream& in_) {
+    QString name, title, category, desc;
+    qint32 type, flags, formatType;
+    QStringList allowed;
+    Tellico::StringMap properties;
+    in_ >> name >> title >> category >> desc >> type >> flags >> formatType >> allowed >> properties;
+    if(in_.status() != QDataStream::Ok || name.isEmpty()) {
+      return Tellico::Data::FieldPtr();
+    }
+    Tellico::Data::FieldPtr field;
+    if(type == Tellico::Data::Field::Choice) {
+      field = new Tellico::Data::Field(name, title, allowed);
+    } else {
+      field = new Tellico::Data::Field(name, title, static_cast<Tellico::Data::Field::Type>(type));
+    }
+    field->setCategory(category);
+    field->setDescription(desc);
+    field->setFlags(flags);
+    field->setFormatType(static_cast<Tellico::FieldFormat::Type>(formatType));
+    field->setPropertyList(properties);
+    return field;
+  }
+
+  QByteArray fieldData(Tellico::Data::FieldPtr field_) {
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(JOURNAL_STREAM_VERSION);
+    writeField(out, field_);
+    return data;
+  }
+}
+
+using Tellico::Data::DocumentJournal;
+
+DocumentJournal::DocumentJournal(QObject* parent_) : QObject(parent_), Observer()
+    , m_generation(0), m_seq(0), m_sourceSize(-1), m_sourceTime(-1), m_journalSize(0), m_syncPending(false)
+    , m_compactTimer(this), m_compactSeq(0), m_compactGeneration(-1) {
+  m_compactTimer.setSingleShot(true);
+  m_compactTimer.setInterval(JOURNAL_COMPACT_DELAY);
+  connect(&m_compactTimer, &QTimer::timeout, this, &DocumentJournal::slotCompact);
+  connect(&m_compactWatcher, &QFutureWatcherBase::finished, this, &DocumentJournal::slotCompactFinished);
+  connect(&m_syncWatcher, &QFutureWatcherBase::finished, this, &DocumentJournal::slotSyncFinished);
+}
+
+DocumentJournal::~DocumentJournal() {
+  closeJournal();
+  // let the last checkpoint finish writing
+  m_compactWatcher.waitForFinished();
+}
+
+QString DocumentJournal::journalDirectory() {
+  return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QLatin1String("/journal/");
+}
+
+void DocumentJournal::setUrl(const QUrl& url_) {
+  closeJournal();
+  ++m_generation;
+  m_compactTimer.stop();
+  m_fileName.clear();
+  m_key.clear();
+  m_seq = 0;
+  m_sourceSize = -1;
+  m_sourceTime = -1;
+  m_fieldsRecord.clear();
+
+  if(!url_.isLocalFile() || !Config::changeJournal()) {
+    return;
+  }
+  const QFileInfo info(url_.toLocalFile());
+  if(!info.exists()) {
+    return;
+  }
+  m_fileName = info.absoluteFilePath();
+  m_key = QString::fromLatin1(QCryptographicHash::hash(m_fileName.toUtf8(), QCryptographicHash::Sha1).toHex());
+}
+
+QString DocumentJournal::journalFileName(int seq_) const {
+  return journalDirectory() + m_key + QLatin1Char('-') + QString::number(seq_) + QLatin1String(".journal");
+}
+
+QString DocumentJournal::checkpointFileName(int seq_) const {
+  return journalDirectory() + m_key + QLatin1Char('-') + QString::number(seq_) + QLatin1String(".checkpoint");
+}
+
+bool DocumentJournal::openJournal() {
+  if(m_file) {
+    return true;
+  }
+  if(m_key.isEmpty() || !QDir().mkpath(journalDirectory())) {
+    return false;
+  }
+  // the journal only applies to the file as it is now
+  if(m_sourceSize < 0) {
+    const QFileInfo info(m_fileName);
+    m_sourceSize = info.size();
+    m_sourceTime = info.lastModified().toMSecsSinceEpoch();
+  }
+  auto file = std::make_unique<QFile>(journalFileName(m_seq));
+  if(!file->open(QIODevice::ReadWrite | QIODevice::Append)) {
+    myDebug() << "Unable to open journal:" << file->fileName();
+    return false;
+  }
+  if(file->size() == 0) {
+    QDataStream out(file.get());
+    out.setVersion(JOURNAL_STREAM_VERSION);
+    out << JournalHeader{JOURNAL_MAGIC, JOURNAL_VERSION, m_seq, m_sourceSize, m_sourceTime};
+    file->flush();
+  }
+  m_journalSize = file->size();
+  m_file = std::move(file);
+  requestSync();
+  return true;
+}
+
+void DocumentJournal::closeJournal() {
+  // the file has to stay open until the sync is done with it
+  m_syncWatcher.waitForFinished();
+  if(m_file && m_syncPending) {
+    syncHandle(m_file->handle());
+  }
+  m_syncPending = false;
+  m_file.reset();
+  m_journalSize = 0;
+}
+
+// each record is flushed as soon as it is written, so it survives Tellico crashing, but
+// the sync for surviving a system crash takes long enough to be kept off the GUI thread
+void DocumentJournal::requestSync() {
+  if(!m_file) {
+    return;
+  }
+  if(m_syncWatcher.isRunning()) {
+    // the records written in the meantime get synced together once it finishes
+    m_syncPending = true;
+    return;
+  }
+  m_syncPending = false;
+  m_syncWatcher.setFuture(QtConcurrent::run(syncHandle, m_file->handle()));
+}
+
+void DocumentJournal::slotSyncFinished() {
+  if(m_syncPending) {
+    requestSync();
+  }
+}
+
+void DocumentJournal::discard() {
+  closeJournal();
+  ++m_generation;
+  m_compactTimer.stop();
+  if(!m_key.isEmpty()) {
+    removeFiles(std::numeric_limits<int>::max());
+  }
+  m_seq = 0;
+  m_sourceSize = -1;
+  m_sourceTime = -1;
+  m_fieldsRecord.clear();
+}
+
+void DocumentJournal::removeFiles(int belowSeq_) {
+  const QDir dir(journalDirectory());
+  foreach(const QString& name, dir.entryList(QStringList() << m_key + QLatin1String("-*"), QDir::Files)) {
+    bool ok;
+    const int seq = name.mid(m_key.size() + 1).section(QLatin1Char('.'), 0, 0).toInt(&ok);
+    if(ok && seq < belowSeq_) {
+      QFile::remove(dir.filePath(name));
+    }
+  }
+}
+
+void DocumentJournal::writeEntries(const Data::EntryList& entries_) {
+  if(m_key.isEmpty() || entries_.isEmpty()) {
+    return;
+  }
+  // a value can't be replayed before its field, and a field may get added along with its values
+  writeFields(entries_.first()->collection());
+
+  QByteArray record;
+  QDataStream out(&record, QIODevice::WriteOnly);
+  out.setVersion(JOURNAL_STREAM_VERSION);
+  out << quint8(EntryValues) << quint32(entries_.size());
+  foreach(Data::EntryPtr entry, entries_) {
+    // the whole entry is written, so replaying doesn't depend on what came before
+    QStringList names, values;
+    if(entry->collection()) {
+      foreach(Data::FieldPtr field, entry->collection()->fields()) {
+        if(field->hasFlag(Data::Field::Derived)) {
+          continue;
+        }
+        const QString value = entry->field(field);
+        if(!value.isEmpty()) {
+          names << field->name();
+          values << value;
+        }
+      }
+    }
+    out << qint32(entry->id()) << names << values;
+  }
+  appendRecord(record);
+}
+
+void DocumentJournal::removeEntries(Data::EntryList entries_) {
+  if(m_key.isEmpty() || entries_.isEmpty()) {
+    return;
+  }
+  QByteArray record;
+  QDataStream out(&record, QIODevice::WriteOnly);
+  out.setVersion(JOURNAL_STREAM_VERSION);
+  out << quint8(EntriesRemoved) << quint32(entries_.size());
+  foreach(Data::EntryPtr entry, entries_) {
+    out << qint32(entry->id());
+  }
+  appendRecord(record);
+}
+
+void DocumentJournal::writeFields(CollPtr coll_) {
+  if(m_key.isEmpty() || !coll_) {
+    return;
+  }
+  // the whole list is only a few kilobytes, and it covers adding, changing, removing, and reordering
+  const QByteArray record = fieldsRecord(coll_->fields());
+  if(record == m_fieldsRecord) {
+    return;
+  }
+  m_fieldsRecord = record;
+  appendRecord(record);
+}
+
+void DocumentJournal::writeBorrowers() {
+  if(m_key.isEmpty() || !Document::self()->collection()) {
+    return;
+  }
+  appendRecord(borrowersRecord(Document::self()->collection()));
+}
+
+void DocumentJournal::writeFilters() {
+  if(m_key.isEmpty() || !Document::self()->collection()) {
+    return;
+  }
+  appendRecord(filtersRecord(Document::self()->collection()));
+}
+
+void DocumentJournal::renameCollection(const QString& title_) {
+  if(m_key.isEmpty()) {
+    return;
+  }
+  appendRecord(titleRecord(title_));
+}
+
+void DocumentJournal::appendRecord(const QByteArray& record_) {
+  if(!openJournal()) {
+    return;
+  }
+  QDataStream out(m_file.get());
+  out.setVersion(JOURNAL_STREAM_VERSION);
+  writeRecord(out, record_);
+  m_file->flush();
+  requestSync();
+  m_journalSize = m_file->size();
+  if(m_journalSize > JOURNAL_COMPACT_SIZE) {
+    // nothing is lost by waiting, so the checkpoint gets written once the changes pause
+    m_compactTimer.start();
+  }
+}
+
+QByteArray DocumentJournal::fieldsRecord(const FieldList& fields_) {
+  QByteArray record;
+  QDataStream out(&record, QIODevice::WriteOnly);
+  out.setVersion(JOURNAL_STREAM_VERSION);
+  out << quint8(Fields) << quint32(fields_.size());
+  foreach(Data::FieldPtr field, fields_) {
+    writeField(out, field);
+  }
+  return record;
+}
+
+QByteArray DocumentJournal::borrowersRecord(CollPtr coll_) {
+  Data::BorrowerList borrowers;
+  foreach(Data::BorrowerPtr borrower, coll_->borrowers()) {
+    if(!borrower->isEmpty()) {
+      borrowers << borrower;
+    }
+  }
+  QByteArray record;
+  QDataStream out(&record, QIODevice::WriteOnly);
+  out.setVersion(JOURNAL_STREAM_VERSION);
+  out << quint8(Borrowers) << quint32(borrowers.size());
+  foreach(Data::BorrowerPtr borrower, borrowers) {
+    out << borrower->name() << borrower->uid() << quint32(borrower->count());
+    foreach(Data::LoanPtr loan, borrower->loans()) {
+      out << loan->uid() << qint32(loan->entry() ? loan->entry()->id() : -1)
+          << loan->loanDate() << loan->dueDate() << loan->note() << loan->inCalendar();
+    }
+  }
+  return record;
+}
+
+QByteArray DocumentJournal::filtersRecord(CollPtr coll_) {
+  QByteArray record;
+  QDataStream out(&record, QIODevice::WriteOnly);
+  out.setVersion(JOURNAL_STREAM_VERSION);
+  out << quint8(Filters) << quint32(coll_->filters().size());
+  foreach(FilterPtr filter, coll_->filters()) {
+    out << filter->name() << qint32(filter->op()) << quint32(filter->count());
+    foreach(FilterRule* rule, *filter) {
+      out << rule->fieldName() << rule->pattern() << qint32(rule->function());
+    }
+  }
+  return record;
+}
+
+QByteArray DocumentJournal::titleRecord(const QString& title_) {
+  QByteArray record;
+  QDataStream out(&record, QIODevice::WriteOnly);
+  out.setVersion(JOURNAL_STREAM_VERSION);
+  out << quint8(Title) << title_;
+  return record;
+}
+
+void DocumentJournal::collectionModified() {
+  if(m_key.isEmpty()) {
+    return;
+  }
+  // the records after this go into the next journal, which starts from the checkpoint
+  m_compactTimer.stop();
+  slotCompact();
+}
+
+void DocumentJournal::slotCompact() {
+  if(m_key.isEmpty()) {
+    return;
+  }
+  if(m_compactWatcher.isRunning()) {
+    m_compactTimer.start();
+    return;
+  }
+  CollPtr coll = Document::self()->collection();
+  if(!coll) {
+    return;
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+  // taking the snapshot is quick, and the worker thread can read it while the collection
+  // keeps changing. The loans and filters are not in the snapshot, but there are few of them
+  const ReadOnlyCollection snapshot = coll->snapshot();
+  const QList<QByteArray> records = QList<QByteArray>() << borrowersRecord(coll) << filtersRecord(coll);
+
+  // later changes go into the next journal, which starts from this checkpoint
+  closeJournal();
+  ++m_seq;
+  if(!openJournal()) {
+    return;
+  }
+  QByteArray header;
+  QDataStream out(&header, QIODevice::WriteOnly);
+  out.setVersion(JOURNAL_STREAM_VERSION);
+  out << JournalHeader{JOURNAL_MAGIC, JOURNAL_VERSION, m_seq, m_sourceSize, m_sourceTime};
+
+  m_compactSeq = m_seq;
+  m_compactGeneration = m_generation;
+  m_compactFileName = checkpointFileName(m_seq);
+  m_compactWatcher.setFuture(QtConcurrent::run(&DocumentJournal::writeCheckpoint,
+                                               m_compactFileName, header, snapshot, records));
+  myLog() << "Started compacting the change journal in" << timer.elapsed() << "ms";
+}
+
+// a checkpoint has the same layout as a journal, with records for the whole collection
+bool DocumentJournal::writeCheckpoint(const QString& fileName_, const QByteArray& header_,
+                                      const ReadOnlyCollection& snapshot_, const QList<QByteArray>& records_) {
+  QByteArray entryRecord;
+  QDataStream entryStream(&entryRecord, QIODevice::WriteOnly);
+  entryStream.setVersion(JOURNAL_STREAM_VERSION);
+  entryStream << quint8(AllEntryValues) << quint32(snapshot_.entryCount());
+  Data::FieldList fields;
+  foreach(Data::FieldPtr field, snapshot_.fields()) {
+    if(!field->hasFlag(Data::Field::Derived)) {
+      fields << field;
+    }
+  }
+  for(const auto& entry : snapshot_.entries()) {
+    QStringList names, values;
+    foreach(Data::FieldPtr field, fields) {
+      const QString value = entry.field(field->name());
+      if(!value.isEmpty()) {
+        names << field->name();
+        values << value;
+      }
+    }
+    entryStream << qint32(entry.id()) << names << values;
+  }
+
+  QSaveFile file(fileName_);
+  if(!file.open(QIODevice::WriteOnly)) {
+    return false;
+  }
+  QDataStream out(&file);
+  out.setVersion(JOURNAL_STREAM_VERSION);
+  out.writeRawData(header_.constData(), header_.size());
+  writeRecord(out, titleRecord(snapshot_.title()));
+  writeRecord(out, fieldsRecord(snapshot_.fields()));
+  writeRecord(out, entryRecord);
+  // the loans refer to the entries, so they come after
+  foreach(const QByteArray& record, records_) {
+    writeRecord(out, record);
+  }
+  // committing the file syncs it to the disk
+  return out.status() == QDataStream::Ok && file.commit();
+}
+
+void DocumentJournal::slotCompactFinished() {
+  if(m_compactGeneration != m_generation) {
+    // the journal was discarded while the checkpoint was being written
+    QFile::remove(m_compactFileName);
+    return;
+  }
+  if(!m_compactWatcher.result()) {
+    // the older journals are still complete without the checkpoint
+    myDebug() << "Unable to write" << m_compactFileName;
+    return;
+  }
+  removeFiles(m_compactSeq);
+  myLog() << "Compacted the change journal into" << m_compactFileName;
+}
+
+bool DocumentJournal::recover(CollPtr coll_) {
+  if(m_key.isEmpty() || !coll_) {
+    return false;
+  }
+
+  QMap<int, QString> journals;
+  int checkpointSeq = 0;
+  const QDir dir(journalDirectory());
+  foreach(const QString& name, dir.entryList(QStringList() << m_key + QLatin1String("-*"), QDir::Files)) {
+    bool ok;
+    const int seq = name.mid(m_key.size() + 1).section(QLatin1Char('.'), 0, 0).toInt(&ok);
+    if(!ok) {
+      continue;
+    }
+    if(name.endsWith(QLatin1String(".journal"))) {
+      journals.insert(seq, dir.filePath(name));
+    } else if(name.endsWith(QLatin1String(".checkpoint"))) {
+      checkpointSeq = qMax(checkpointSeq, seq);
+    }
+  }
+  // replaying starts from the newest checkpoint, otherwise the file itself
+  if(!journals.contains(checkpointSeq)) {
+    discard();
+    return false;
+  }
+
+  // every journal has to belong to the file as it is now, before anything gets changed
+  const QFileInfo info(m_fileName);
+  const qint64 sourceTime = info.lastModified().toMSecsSinceEpoch();
+  QMap<int, QString> files = journals;
+  if(checkpointSeq > 0) {
+    files.insert(-1, checkpointFileName(checkpointSeq));
+  }
+  for(auto it = files.constBegin(); it != files.constEnd(); ++it) {
+    if(it.key() >= 0 && it.key() < checkpointSeq) {
+      continue;
+    }
+    QFile file(it.value());
+    JournalHeader header;
+    if(file.open(QIODevice::ReadOnly)) {
+      QDataStream in(&file);
+      in.setVersion(JOURNAL_STREAM_VERSION);
+      in >> header;
+    }
+    const int seq = it.key() < 0 ? checkpointSeq : it.key();
+    if(header.magic != JOURNAL_MAGIC || header.version != JOURNAL_VERSION || header.seq != seq ||
+       header.sourceSize != info.size() || header.sourceTime != sourceTime) {
+      myLog() << "The change journal does not match" << m_fileName;
+      discard();
+      return false;
+    }
+  }
+
+  if(checkpointSeq > 0) {
+    int checkpointRecords = 0;
+    replayJournal(checkpointFileName(checkpointSeq), coll_, &checkpointRecords);
+  }
+  int recordCount = 0;
+  for(auto it = journals.constFind(checkpointSeq); it != journals.constEnd(); ++it) {
+    replayJournal(it.value(), coll_, &recordCount);
+  }
+  if(checkpointSeq == 0 && recordCount == 0) {
+    discard();
+    return false;
+  }
+  myLog() << "Recovered" << recordCount << "changes to" << m_fileName;
+
+  // keep adding to the same journal, the recovered changes are still not saved
+  m_seq = journals.lastKey();
+  m_sourceSize = info.size();
+  m_sourceTime = sourceTime;
+  m_fieldsRecord.clear();
+  return true;
+}
+
+bool DocumentJournal::replayJournal(const QString& fileName_, CollPtr coll_, int* recordCount_) {
+  QFile file(fileName_);
+  if(!file.open(QIODevice::ReadWrite)) {
+    return false;
+  }
+  QDataStream in(&file);
+  in.setVersion(JOURNAL_STREAM_VERSION);
+  JournalHeader header;
+  in >> header;
+  qint64 validEnd = file.pos();
+  while(!in.atEnd()) {
+    quint32 size;
+    quint16 checksum;
+    in >> size >> checksum;
+    if(in.status() != QDataStream::Ok || size > file.size() - file.pos()) {
+      break;
+    }
+    const QByteArray record = file.read(size);
+    if(record.size() != qsizetype(size) || qChecksum(record) != checksum) {
+      break;
+    }
+    replayRecord(record, coll_);
+    ++*recordCount_;
+    validEnd = file.pos();
+  }
+  if(validEnd < file.size()) {
+    // the last record was not completely written
+    myLog() << "Dropping an incomplete record from" << fileName_;
+    file.resize(validEnd);
+  }
+  return true;
+}
+
+void DocumentJournal::replayRecord(const QByteArray& record_, CollPtr coll_) {
+  QDataStream in(record_);
+  in.setVersion(JOURNAL_STREAM_VERSION);
+  quint8 type;
+  in >> type;
+  if(type == Title) {
+    QString title;
+    in >> title;
+    if(in.status() == QDataStream::Ok) {
+      coll_->setTitle(title);
+    }
+    return;
+  }
+  quint32 count;
+  in >> count;
+  switch(type) {
+    case EntryValues:
+    case AllEntryValues:
+      {
+        Data::EntryList entries;
+        QSet<Data::ID> ids;
+        for(quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+          qint32 id;
+          QStringList names, values;
+          in >> id >> names >> values;
+          if(in.status() != QDataStream::Ok || names.size() != values.size()) {
+            break;
+          }
+          ids.insert(id);
+          Data::EntryPtr entry = coll_->entryById(id);
+          if(entry) {
+            // the record has every value of the entry, anything else was cleared
+            foreach(Data::FieldPtr field, coll_->fields()) {
+              if(!field->hasFlag(Data::Field::Derived) && !names.contains(field->name())) {
+                entry->setField(field, QString(), false);
+              }
+            }
+          } else {
+            entry = Data::EntryPtr(new Data::Entry(coll_, id));
+            entries << entry;
+          }
+          for(int j = 0; j < names.size(); ++j) {
+            entry->setField(names.at(j), values.at(j), false);
+          }
+        }
+        coll_->addEntries(entries);
+        if(type == AllEntryValues) {
+          // a checkpoint has every entry, so anything else was removed
+          Data::EntryList removed;
+          foreach(Data::EntryPtr entry, coll_->entries()) {
+            if(!ids.contains(entry->id())) {
+              removed << entry;
+            }
+          }
+          coll_->removeEntries(removed);
+        }
+      }
+      break;
+
+    case EntriesRemoved:
+      {
+        Data::EntryList entries;
+        for(quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+          qint32 id;
+          in >> id;
+          Data::EntryPtr entry = coll_->entryById(id);
+          if(entry) {
+            entries << entry;
+          }
+        }
+        coll_->removeEntries(entries);
+      }
+      break;
+
+    case Fields:
+      {
+        Data::FieldList fields;
+        for(quint32 i = 0; i < count; ++i) {
+          Data::FieldPtr field = readField(in);
+          if(!field) {
+            return;
+          }
+          Data::FieldPtr current = coll_->fieldByName(field->name());
+          if(!current) {
+            coll_->addField(field);
+          } else if(fieldData(current) != fieldData(field)) {
+            coll_->modifyField(field);
+          }
+          fields << coll_->fieldByName(field->name());
+        }
+        foreach(Data::FieldPtr field, coll_->fields()) {
+          if(!fields.contains(field)) {
+            coll_->removeField(field, true /* force */);
+          }
+        }
+        coll_->reorderFields(fields);
+      }
+      break;
+
+    case Borrowers:
+      {
+        // the record has every loan, so start from none
+        foreach(Data::BorrowerPtr borrower, coll_->borrowers()) {
+          foreach(Data::LoanPtr loan, borrower->loans()) {
+            borrower->removeLoan(loan);
+          }
+        }
+        for(quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+          QString name, uid;
+          quint32 loanCount;
+          in >> name >> uid >> loanCount;
+          Data::BorrowerPtr borrower(new Data::Borrower(name, uid));
+          for(quint32 j = 0; j < loanCount && in.status() == QDataStream::Ok; ++j) {
+            QString loanUid, note;
+            qint32 entryId;
+            QDate loanDate, dueDate;
+            bool inCalendar;
+            in >> loanUid >> entryId >> loanDate >> dueDate >> note >> inCalendar;
+            Data::EntryPtr entry = coll_->entryById(entryId);
+            if(!entry) {
+              continue;
+            }
+            Data::LoanPtr loan(new Data::Loan(entry, loanDate, dueDate, note));
+            loan->setUID(loanUid);
+            loan->setInCalendar(inCalendar);
+            borrower->addLoan(loan);
+          }
+          if(in.status() == QDataStream::Ok && !borrower->isEmpty()) {
+            coll_->addBorrower(borrower);
+          }
+        }
+      }
+      break;
+
+    case Filters:
+      {
+        foreach(FilterPtr filter, coll_->filters()) {
+          coll_->removeFilter(filter);
+        }
+        for(quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+          QString name;
+          qint32 op;
+          quint32 ruleCount;
+          in >> name >> op >> ruleCount;
+          FilterPtr filter(new Filter(static_cast<Filter::FilterOp>(op)));
+          filter->setName(name);
+          for(quint32 j = 0; j < ruleCount && in.status() == QDataStream::Ok; ++j) {
+            QString fieldName, pattern;
+            qint32 function;
+            in >> fieldName >> pattern >> function;
+            filter->append(new FilterRule(fieldName, pattern, static_cast<FilterRule::Function>(function)));
+          }
+          if(in.status() == QDataStream::Ok) {
+            coll_->addFilter(filter);
+          }
+        }
+      }
+      break;
+
+    default:
+      myDebug() << "Unknown record type in the change journal:" << type;
+      break;
+  }
+}
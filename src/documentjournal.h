@@ -0,0 +1,170 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef TELLICO_DOCUMENTJOURNAL_H
+#define TELLICO_DOCUMENTJOURNAL_H
+
+#include "observer.h"
+#include "datavectors.h"
+
+#include <QObject>
+#include <QTimer>
+#include <QFutureWatcher>
+
+#include <memory>
+
+class QFile;
+class QUrl;
+
+namespace Tellico {
+  namespace Data {
+    class ReadOnlyCollection;
+
+/**
+ * The DocumentJournal keeps an append-only record of the changes made to a document
+ * since it was last saved, so they can be recovered if Tellico does not exit cleanly.
+ *
+ * The journal observes the same notifications the views do, which every undo command
+ * sends for both redo and undo. The current values of every added or modified entry
+ * are appended, as are the ids of removed entries. Changes to the fields, the loans, the
+ * filters, or the title append the complete new list of them, which is small. Each record
+ * is flushed right away, and synced to disk by a worker thread along with any records
+ * written in the meantime.
+ *
+ * Journals that grow too large, or changes which can't be recorded that way, like
+ * appending or merging another collection, get compacted into a checkpoint of the whole
+ * collection. The checkpoint is written by a worker thread from a read-only snapshot of
+ * the collection. Replaying starts from the saved file, applies the newest checkpoint,
+ * and then every record written after it.
+ *
+ * Only local files are journaled, and only when the hidden "Change Journal" option
+ * is set. The journal is discarded when the document is saved or the changes are discarded.
+ *
+ * @author Robby Stephenson
+ */
+class DocumentJournal : public QObject, public Observer {
+Q_OBJECT
+
+public:
+  explicit DocumentJournal(QObject* parent);
+  ~DocumentJournal();
+
+  /**
+   * Sets the file whose changes are journaled. An empty or remote url turns the journal off.
+   */
+  void setUrl(const QUrl& url);
+  /**
+   * Replays a journal left from an earlier session over the collection just read from the
+   * file, and continues that journal.
+   *
+   * @param coll The collection read from the file
+   * @return Whether any changes were recovered
+   */
+  bool recover(CollPtr coll);
+  /**
+   * Removes the journal, once the changes have been saved or discarded.
+   */
+  void discard();
+  /**
+   * Compacts the journal into a checkpoint right away, for changes to the whole collection
+   * that are not recorded one by one.
+   */
+  void collectionModified();
+  void renameCollection(const QString& title);
+
+  virtual void    addBorrower(Data::BorrowerPtr) override { writeBorrowers(); }
+  virtual void modifyBorrower(Data::BorrowerPtr) override { writeBorrowers(); }
+  virtual void removeBorrower(Data::BorrowerPtr) override { writeBorrowers(); }
+
+  virtual void    addEntries(Data::EntryList entries) override { writeEntries(entries); }
+  virtual void modifyEntries(Data::EntryList entries) override { writeEntries(entries); }
+  virtual void removeEntries(Data::EntryList entries) override;
+
+  virtual void    addField(Data::CollPtr coll, Data::FieldPtr) override { writeFields(coll); }
+  virtual void modifyField(Data::CollPtr coll, Data::FieldPtr, Data::FieldPtr) override { writeFields(coll); }
+  virtual void removeField(Data::CollPtr coll, Data::FieldPtr) override { writeFields(coll); }
+  virtual void reorderFields(Data::CollPtr coll) override { writeFields(coll); }
+
+  virtual void    addFilter(FilterPtr) override { writeFilters(); }
+  virtual void modifyFilter(FilterPtr) override { writeFilters(); }
+  virtual void removeFilter(FilterPtr) override { writeFilters(); }
+
+  static QString journalDirectory();
+
+private Q_SLOTS:
+  void slotCompact();
+  void slotCompactFinished();
+  void slotSyncFinished();
+
+private:
+  enum RecordType { EntryValues = 1, EntriesRemoved = 2, Fields = 3, Borrowers = 4,
+                    Filters = 5, Title = 6, AllEntryValues = 7 };
+
+  QString journalFileName(int seq) const;
+  QString checkpointFileName(int seq) const;
+  bool openJournal();
+  void closeJournal();
+  void requestSync();
+  void writeEntries(const Data::EntryList& entries);
+  void writeFields(CollPtr coll);
+  void writeBorrowers();
+  void writeFilters();
+  void appendRecord(const QByteArray& record);
+  bool replayJournal(const QString& fileName, CollPtr coll, int* recordCount);
+  void removeFiles(int belowSeq);
+
+  static QByteArray fieldsRecord(const FieldList& fields);
+  static QByteArray borrowersRecord(CollPtr coll);
+  static QByteArray filtersRecord(CollPtr coll);
+  static QByteArray titleRecord(const QString& title);
+  static bool writeCheckpoint(const QString& fileName, const QByteArray& header,
+                              const ReadOnlyCollection& snapshot, const QList<QByteArray>& records);
+  static void replayRecord(const QByteArray& record, CollPtr coll);
+
+  QString m_fileName;
+  QString m_key;
+  // incremented whenever the journal is restarted, so a late compaction gets ignored
+  int m_generation;
+  // each compaction starts a new journal file with the next sequence number
+  int m_seq;
+  qint64 m_sourceSize;
+  qint64 m_sourceTime;
+  qint64 m_journalSize;
+  std::unique_ptr<QFile> m_file;
+  QFutureWatcher<void> m_syncWatcher;
+  // more records were written while the last sync was running
+  bool m_syncPending;
+  // the last list of fields written, since entry records depend on it
+  QByteArray m_fieldsRecord;
+  QTimer m_compactTimer;
+  QFutureWatcher<bool> m_compactWatcher;
+  int m_compactSeq;
+  int m_compactGeneration;
+  QString m_compactFileName;
+};
+
+  } // end namespace
+} // end namespace
+#endif
@@ -37,7 +37,7 @@ using namespace Tellico;
 using namespace Tellico::Data;
 using Tellico::Data::Entry;
 
-Entry::Entry(Tellico::Data::CollPtr coll_) : QSharedData(), m_coll(coll_), m_id(-1) {
+Entry::Entry(Tellico::Data::CollPtr coll_) : QSharedData(), m_coll(coll_), m_id(-1), m_generation(nextGeneration()) {
 #ifndef NDEBUG
   if(!coll_) {
     myWarning() << "null collection pointer!";
@@ -45,7 +45,8 @@ Entry::Entry(Tellico::Data::CollPtr coll_) : QSharedData(), m_coll(coll_), m_id(
 #endif
 }
 
-Entry::Entry(Tellico::Data::CollPtr coll_, Data::ID id_) : QSharedData(), m_coll(coll_), m_id(id_) {
+Entry::Entry(Tellico::Data::CollPtr coll_, Data::ID id_) : QSharedData(), m_coll(coll_), m_id(id_),
+    m_generation(nextGeneration()) {
 #ifndef NDEBUG
   if(!coll_) {
     myWarning() << "null collection pointer!";
@@ -58,7 +59,8 @@ Entry::Entry(const Entry& entry_) :
     m_coll(entry_.m_coll),
     m_id(-1),
     m_fieldValues(entry_.m_fieldValues),
-    m_formattedFields(entry_.m_formattedFields) {
+    m_formattedFields(entry_.m_formattedFields),
+    m_generation(nextGeneration()) {
   // special case for creation date since it gets set in Collection::addEntry IF cdate is empty
   m_fieldValues.remove(QStringLiteral("cdate"));
   m_fieldValues.remove(QStringLiteral("mdate"));
@@ -68,6 +70,12 @@ Entry& Entry::operator=(const Entry& other_) {
   if(this == &other_) return *this;
 
 //  static_cast<QSharedData&>(*this) = static_cast<const QSharedData&>(other_);
+  // the id changes, so check now if the collection's value dicts need updating
+  CollPtr dictColl;
+  if(m_coll && m_coll->hasFieldValueDicts() && isInCollection()) {
+    dictColl = m_coll;
+    dictColl->removeEntryValues(this);
+  }
   m_coll = other_.m_coll;
   m_id = other_.m_id;
   m_fieldValues = other_.m_fieldValues;
@@ -75,11 +83,29 @@ Entry& Entry::operator=(const Entry& other_) {
   m_fieldValues.remove(QStringLiteral("cdate"));
   m_fieldValues.remove(QStringLiteral("mdate"));
   m_formattedFields = other_.m_formattedFields;
+  if(dictColl) {
+    dictColl->addEntryValues(this);
+  }
+  // every value may have changed
+  valueModified(QString());
   return *this;
 }
 
 Entry::~Entry() = default;
 
+Tellico::Data::EntryPtr Entry::copyWithDates() const {
+  EntryPtr entry(new Entry(*this));
+  static const QString cdate(QStringLiteral("cdate"));
+  static const QString mdate(QStringLiteral("mdate"));
+  if(m_fieldValues.contains(cdate)) {
+    entry->m_fieldValues.insert(cdate, m_fieldValues.value(cdate));
+  }
+  if(m_fieldValues.contains(mdate)) {
+    entry->m_fieldValues.insert(mdate, m_fieldValues.value(mdate));
+  }
+  return entry;
+}
+
 Tellico::Data::CollPtr Entry::collection() const {
   return m_coll;
 }
@@ -150,35 +176,7 @@ QString Entry::formattedField(Tellico::Data::FieldPtr field_, FieldFormat::Reque
   }
 
   if(!m_formattedFields.contains(field_->name())) {
-    QString formattedValue;
-    if(field_->type() == Field::Table) {
-      QStringList rows;
-      // we only format the first column
-      foreach(const QString& row, FieldFormat::splitTable(field(field_))) {
-        QStringList columns = FieldFormat::splitRow(row);
-        QStringList newValues;
-        if(!columns.isEmpty()) {
-          foreach(const QString& value, FieldFormat::splitValue(columns.at(0))) {
-            newValues << FieldFormat::format(value, field_->formatType(), FieldFormat::DefaultFormat);
-          }
-          columns.replace(0, newValues.join(FieldFormat::delimiterString()));
-        }
-        rows << columns.join(FieldFormat::columnDelimiterString());
-      }
-      formattedValue = rows.join(FieldFormat::rowDelimiterString());
-    } else {
-      QStringList values;
-      if(field_->hasFlag(Field::AllowMultiple)) {
-        values = FieldFormat::splitValue(field(field_));
-      } else {
-        values << field(field_);
-      }
-      QStringList formattedValues;
-      foreach(const QString& value, values) {
-        formattedValues << FieldFormat::format(m_coll->prepareText(value), flag, request_);
-      }
-      formattedValue = formattedValues.join(FieldFormat::delimiterString());
-    }
+    const QString formattedValue = formatValue(m_coll.data(), field_, field(field_), request_);
     if(!formattedValue.isEmpty()) {
       m_formattedFields.insert(field_->name(), Tellico::shareString(formattedValue));
     }
@@ -188,6 +186,52 @@ QString Entry::formattedField(Tellico::Data::FieldPtr field_, FieldFormat::Reque
   return m_formattedFields.value(field_->name());
 }
 
+QString Entry::formatValue(const Tellico::Data::Collection* coll_, Tellico::Data::FieldPtr field_, const QString& value_,
+                           FieldFormat::Request request_) {
+  Q_ASSERT(coll_);
+  return formatValue([coll_](const QString& text_) { return coll_->prepareText(text_); },
+                     field_, value_, request_);
+}
+
+QString Entry::formatValue(const std::function<QString(const QString&)>& prepareText_, Tellico::Data::FieldPtr field_,
+                           const QString& value_, FieldFormat::Request request_) {
+  const FieldFormat::Type flag = field_->formatType();
+  if(flag == FieldFormat::FormatNone) {
+    return prepareText_ ? prepareText_(value_) : value_;
+  }
+
+  QString formattedValue;
+  if(field_->type() == Field::Table) {
+    QStringList rows;
+    // we only format the first column
+    foreach(const QString& row, FieldFormat::splitTable(value_)) {
+      QStringList columns = FieldFormat::splitRow(row);
+      QStringList newValues;
+      if(!columns.isEmpty()) {
+        foreach(const QString& value, FieldFormat::splitValue(columns.at(0))) {
+          newValues << FieldFormat::format(value, field_->formatType(), FieldFormat::DefaultFormat);
+        }
+        columns.replace(0, newValues.join(FieldFormat::delimiterString()));
+      }
+      rows << columns.join(FieldFormat::columnDelimiterString());
+    }
+    formattedValue = rows.join(FieldFormat::rowDelimiterString());
+  } else {
+    QStringList values;
+    if(field_->hasFlag(Field::AllowMultiple)) {
+      values = FieldFormat::splitValue(value_);
+    } else {
+      values << value_;
+    }
+    QStringList formattedValues;
+    foreach(const QString& value, values) {
+      formattedValues << FieldFormat::format(prepareText_ ? prepareText_(value) : value, flag, request_);
+    }
+    formattedValue = formattedValues.join(FieldFormat::delimiterString());
+  }
+  return formattedValue;
+}
+
 // updating the modified date of the entry is expensive with the call to QDate::currentDate
 // when loading a collection from a file (in particular), it's faster to ignore that date
 bool Entry::setField(Tellico::Data::FieldPtr field_, const QString& value_, bool updateMDate_) {
@@ -230,10 +274,17 @@ bool Entry::setField(const QString& name_, const QString& value_, bool updateMDa
 bool Entry::setFieldImpl(Data::FieldPtr field_, const QString& value_) {
   if(!field_) return false;
   const auto name = field_->name();
+  // keep the collection's value dict current
+  const bool trackValue = m_coll && m_coll->hasFieldValueDict(name) && isInCollection();
+  const QString oldValue = trackValue ? m_fieldValues.value(name) : QString();
   // an empty value means remove the field
   if(value_.isEmpty()) {
     if(m_fieldValues.remove(name)) {
       invalidateFormattedFieldValue(name);
+      valueModified(name);
+      if(trackValue) {
+        m_coll->fieldValueChanged(name, oldValue, value_);
+      }
     }
     return true;
   }
@@ -257,9 +308,34 @@ bool Entry::setFieldImpl(Data::FieldPtr field_, const QString& value_) {
     m_fieldValues.insert(Tellico::shareString(name), value_);
   }
   invalidateFormattedFieldValue(name);
+  valueModified(name);
+  if(trackValue) {
+    m_coll->fieldValueChanged(name, oldValue, value_);
+  }
   return true;
 }
 
+void Entry::setCheckedField(Tellico::Data::FieldPtr field_, const QString& value_) {
+  Q_ASSERT(field_);
+  Q_ASSERT(!value_.isEmpty());
+  // the field name is already shared by the field
+  m_fieldValues.insert(field_->name(), value_);
+  invalidateFormattedFieldValue(field_->name());
+  m_generation = nextGeneration();
+}
+
+void Entry::valueModified(const QString& fieldName_) {
+  m_generation = nextGeneration();
+  // entries which are not yet added get counted when they are
+  if(isInCollection()) {
+    m_coll->markModified(fieldName_);
+  }
+}
+
+bool Entry::isInCollection() const {
+  return m_coll && m_id > -1 && m_coll->entryById(m_id).data() == this;
+}
+
 bool Entry::addToGroup(EntryGroup* group_) {
   if(!group_ || m_groups.contains(group_)) {
     return false;
@@ -296,22 +372,30 @@ QStringList Entry::groupNamesByFieldName(const QString& fieldName_) const {
     return QStringList();
   }
 
+  // tables use the raw value
+  if(f->type() == Field::Table) {
+    return groupNames(f, field(f), QString());
+  }
+  return groupNames(f, QString(), formattedField(f));
+}
+
+QStringList Entry::groupNames(Tellico::Data::FieldPtr field_, const QString& value_, const QString& formattedValue_) {
   StringSet groups;
   // check table before multiple since tables are always multiple
-  if(f->type() == Field::Table) {
+  if(field_->type() == Field::Table) {
     // we only take groups from the first column
-    foreach(const QString& row, FieldFormat::splitTable(field(f))) {
+    foreach(const QString& row, FieldFormat::splitTable(value_)) {
       const QStringList columns = FieldFormat::splitRow(row);
       const QStringList values = columns.isEmpty() ? QStringList() : FieldFormat::splitValue(columns.at(0));
       foreach(const QString& value, values) {
-        groups.add(FieldFormat::format(value, f->formatType(), FieldFormat::DefaultFormat));
+        groups.add(FieldFormat::format(value, field_->formatType(), FieldFormat::DefaultFormat));
       }
     }
-  } else if(f->hasFlag(Field::AllowMultiple)) {
+  } else if(field_->hasFlag(Field::AllowMultiple)) {
     // use a string split instead of regexp split, since we've already enforced the space after the semi-comma
-    groups.add(FieldFormat::splitValue(formattedField(f), FieldFormat::StringSplit));
+    groups.add(FieldFormat::splitValue(formattedValue_, FieldFormat::StringSplit));
   } else {
-    groups.add(formattedField(f));
+    groups.add(formattedValue_);
   }
 
   // possible to be empty for no value
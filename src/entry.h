@@ -27,11 +27,15 @@
 
 #include "datavectors.h"
 #include "fieldformat.h"
+#include "generation.h"
 
 #include <QStringList>
 #include <QHash>
 
+#include <functional>
+
 namespace Tellico {
+  class CollectionSnapshot;
 
   namespace Data {
     class Collection;
@@ -60,7 +64,8 @@ public:
   Entry(CollPtr coll);
   Entry(CollPtr coll, ID id);
   /**
-   * The copy constructor, needed since the id must be different.
+   * The copy constructor, needed since the id must be different. The copy is meant to be
+   * a new entry, so the creation and modification dates are not copied.
    */
   Entry(const Entry& entry);
   /**
@@ -70,6 +75,12 @@ public:
 
   ~Entry();
 
+  /**
+   * Returns a copy of the entry which keeps the creation and modification dates,
+   * for holding the old values of an entry that is about to be modified.
+   */
+  EntryPtr copyWithDates() const;
+
   /**
    * Every entry has a title.
    *
@@ -154,6 +165,41 @@ public:
    * @return The list of names
    */
   QStringList groupNamesByFieldName(const QString& fieldName) const;
+  /**
+   * Returns the group names for a value of a field, which must not be a derived field.
+   * The formatted value is ignored for table fields. Nothing is cached, so this may be
+   * used from a worker thread.
+   *
+   * @param field The field
+   * @param value The value of the field
+   * @param formattedValue The formatted value of the field
+   * @return The list of names
+   */
+  static QStringList groupNames(Data::FieldPtr field, const QString& value, const QString& formattedValue);
+  /**
+   * Formats a value of a non-derived field the same way as @ref formattedField, without
+   * caching the result.
+   *
+   * @param coll The collection, used to prepare the text
+   * @param field The field
+   * @param value The value of the field
+   * @param request The format request
+   * @return The formatted value
+   */
+  static QString formatValue(const Collection* coll, Data::FieldPtr field, const QString& value,
+                             FieldFormat::Request request = FieldFormat::DefaultFormat);
+  /**
+   * Formats a value the same way, using a function returned by Collection::textPreparer()
+   * in place of the collection itself.
+   *
+   * @param prepareText The text preparation function, which may be empty
+   * @param field The field
+   * @param value The value of the field
+   * @param request The format request
+   * @return The formatted value
+   */
+  static QString formatValue(const std::function<QString(const QString&)>& prepareText, Data::FieldPtr field,
+                             const QString& value, FieldFormat::Request request = FieldFormat::DefaultFormat);
   /**
    * Returns a list of all the field values contained in the entry.
    *
@@ -180,20 +226,41 @@ public:
    * @param name The name of the field that changed. an empty string means invalidate all fields.
    */
   void invalidateFormattedFieldValue(const QString& name=QString());
+  /**
+   * Returns the generation of the last change to any of the entry's values.
+   *
+   * @return The generation
+   */
+  Generation generation() const { return m_generation; }
 
 private:
+  // reads the field values directly, to share them
+  friend class ReadOnlyCollection;
+  // sets the dates of new entries without the usual checks
+  friend class Collection;
+  // restores values which were checked when the snapshot was written
+  friend class Tellico::CollectionSnapshot;
+
   // not used
   Entry();
 
   bool operator==(const Entry& other) const;
 
   bool setFieldImpl(Data::FieldPtr field, const QString& value);
+  // sets a value known to be allowed, for an entry not yet in a collection
+  void setCheckedField(Data::FieldPtr field, const QString& value);
+  /**
+   * Returns true if the collection holds this very entry, as opposed to a copy or
+   * an entry which has not yet been added.
+   */
+  bool isInCollection() const;
 
   CollPtr m_coll;
   ID m_id;
   QHash<QString, QString> m_fieldValues;
   mutable QHash<QString, QString> m_formattedFields;
   QList<EntryGroup*> m_groups;
+  Generation m_generation;
 };
 
 class EntryCmp {
@@ -0,0 +1,137 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "entrytransaction.h"
+#include "collection.h"
+#include "entry.h"
+
+using Tellico::EntryTransaction;
+
+EntryTransaction::EntryTransaction() : m_depth(0) {
+}
+
+EntryTransaction::~EntryTransaction() {
+}
+
+void EntryTransaction::begin(Tellico::Data::CollPtr coll_) {
+  if(m_depth++ == 0) {
+    m_coll = coll_;
+    if(m_coll) {
+      m_coll->beginTransaction();
+    }
+  }
+}
+
+bool EntryTransaction::commit() {
+  if(m_depth < 1 || --m_depth > 0) {
+    return false;
+  }
+  // update the groups before the views get notified
+  if(m_coll) {
+    m_coll->commitTransaction();
+    m_coll = Data::CollPtr();
+  }
+  return true;
+}
+
+void EntryTransaction::reset() {
+  if(m_depth > 0 && m_coll) {
+    // the collection has to be left with its dicts up to date
+    m_coll->commitTransaction();
+  }
+  m_depth = 0;
+  m_coll = Data::CollPtr();
+  clear();
+}
+
+void EntryTransaction::addEntries(const Tellico::Data::EntryList& entries_) {
+  foreach(Data::EntryPtr entry, entries_) {
+    if(m_removedSet.remove(entry.data())) {
+      // the observers still have it, but the values may be different now
+      m_removed.removeOne(entry);
+      if(!m_modifiedSet.contains(entry.data())) {
+        m_modifiedSet.insert(entry.data());
+        m_modified.append(entry);
+      }
+    } else if(!m_addedSet.contains(entry.data())) {
+      m_addedSet.insert(entry.data());
+      m_added.append(entry);
+    }
+  }
+}
+
+void EntryTransaction::modifyEntries(const Tellico::Data::EntryList& entries_) {
+  foreach(Data::EntryPtr entry, entries_) {
+    // new entries get added with their current values anyway
+    if(!m_addedSet.contains(entry.data()) && !m_modifiedSet.contains(entry.data())) {
+      m_modifiedSet.insert(entry.data());
+      m_modified.append(entry);
+    }
+  }
+}
+
+void EntryTransaction::removeEntries(const Tellico::Data::EntryList& entries_) {
+  foreach(Data::EntryPtr entry, entries_) {
+    if(m_modifiedSet.remove(entry.data())) {
+      m_modified.removeOne(entry);
+    }
+    if(m_addedSet.remove(entry.data())) {
+      // the observers never saw it
+      m_added.removeOne(entry);
+    } else if(!m_removedSet.contains(entry.data())) {
+      m_removedSet.insert(entry.data());
+      m_removed.append(entry);
+    }
+  }
+}
+
+Tellico::Data::EntryList EntryTransaction::takeAdded() {
+  const Data::EntryList entries = m_added;
+  m_added.clear();
+  m_addedSet.clear();
+  return entries;
+}
+
+Tellico::Data::EntryList EntryTransaction::takeModified() {
+  const Data::EntryList entries = m_modified;
+  m_modified.clear();
+  m_modifiedSet.clear();
+  return entries;
+}
+
+Tellico::Data::EntryList EntryTransaction::takeRemoved() {
+  const Data::EntryList entries = m_removed;
+  m_removed.clear();
+  m_removedSet.clear();
+  return entries;
+}
+
+void EntryTransaction::clear() {
+  m_added.clear();
+  m_modified.clear();
+  m_removed.clear();
+  m_addedSet.clear();
+  m_modifiedSet.clear();
+  m_removedSet.clear();
+}
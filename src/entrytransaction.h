@@ -0,0 +1,90 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TELLICO_ENTRYTRANSACTION_H
+#define TELLICO_ENTRYTRANSACTION_H
+
+#include "datavectors.h"
+
+#include <QSet>
+
+namespace Tellico {
+
+/**
+ * The EntryTransaction holds the state of an open transaction. The collection only updates
+ * its group dicts when the outermost transaction is committed, and the entry notifications
+ * are merged so that each entry gets reported only once, as added, modified, or removed.
+ *
+ * @author Robby Stephenson
+ */
+class EntryTransaction {
+public:
+  EntryTransaction();
+  ~EntryTransaction();
+
+  bool isOpen() const { return m_depth > 0; }
+  int depth() const { return m_depth; }
+
+  /**
+   * Opens a transaction, or nests one within the open transaction.
+   *
+   * @param coll The collection whose dict updates are held back
+   */
+  void begin(Data::CollPtr coll);
+  /**
+   * Closes the innermost transaction.
+   *
+   * @return Whether the outermost transaction was committed, so the pending changes should be sent
+   */
+  bool commit();
+  /**
+   * Closes every open transaction and drops the pending changes, for when the
+   * collection is replaced or removed while a transaction is open.
+   */
+  void reset();
+
+  void addEntries(const Data::EntryList& entries);
+  void modifyEntries(const Data::EntryList& entries);
+  void removeEntries(const Data::EntryList& entries);
+
+  Data::EntryList takeAdded();
+  Data::EntryList takeModified();
+  Data::EntryList takeRemoved();
+
+private:
+  void clear();
+
+  int m_depth;
+  // the collection may be replaced before the transaction is committed
+  Data::CollPtr m_coll;
+  Data::EntryList m_added;
+  Data::EntryList m_modified;
+  Data::EntryList m_removed;
+  QSet<Data::Entry*> m_addedSet;
+  QSet<Data::Entry*> m_modifiedSet;
+  QSet<Data::Entry*> m_removedSet;
+};
+
+} // end namespace
+#endif
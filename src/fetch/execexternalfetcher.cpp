@@ -82,7 +82,8 @@ QStringList ExecExternalFetcher::parseArguments(const QString& str_) {
 }
 
 ExecExternalFetcher::ExecExternalFetcher(QObject* parent_) : Fetcher(parent_),
-    m_started(false), m_collType(-1), m_formatType(-1), m_canUpdate(false), m_process(nullptr), m_deleteOnRemove(false) {
+    m_started(false), m_collType(-1), m_formatType(-1), m_canUpdate(false), m_process(nullptr), m_deleteOnRemove(false),
+    m_persistent(false), m_serverFailed(false), m_server(nullptr), m_lastRequestId(0), m_requestId(0) {
 }
 
 ExecExternalFetcher::~ExecExternalFetcher() {
@@ -91,6 +92,12 @@ ExecExternalFetcher::~ExecExternalFetcher() {
     m_process->deleteLater();
     m_process = nullptr;
   }
+  if(m_server) {
+    m_server->disconnect(this);
+    m_server->kill();
+    m_server->deleteLater();
+    m_server = nullptr;
+  }
 }
 
 QString ExecExternalFetcher::source() const {
@@ -152,6 +159,9 @@ void ExecExternalFetcher::readConfigHook(const KConfigGroup& config_) {
   m_formatType = config_.readEntry("FormatType", -1);
   m_deleteOnRemove = config_.readEntry("DeleteOnRemove", false);
   m_newStuffName = config_.readEntry("NewStuffName");
+  m_persistent = config_.hasKey("PersistentArgs");
+  m_persistentArgs = config_.readEntry("PersistentArgs");
+  m_serverFailed = false;
 }
 
 void ExecExternalFetcher::search() {
@@ -201,6 +211,11 @@ void ExecExternalFetcher::startSearch(const QStringList& args_) {
     return;
   }
 
+  if(m_persistent && !m_serverFailed && startServer()) {
+    sendRequest(args_);
+    return;
+  }
+
   m_process = new KProcess();
   connect(m_process, &QProcess::readyReadStandardOutput, this, &ExecExternalFetcher::slotData);
   connect(m_process, &QProcess::readyReadStandardError, this, &ExecExternalFetcher::slotError);
@@ -215,10 +230,55 @@ void ExecExternalFetcher::startSearch(const QStringList& args_) {
   }
 }
 
+bool ExecExternalFetcher::startServer() {
+  if(m_server && m_server->state() == QProcess::Running) {
+    return true;
+  }
+
+  m_server = new KProcess();
+  connect(m_server, &QProcess::readyReadStandardOutput, this, &ExecExternalFetcher::slotServerData);
+  connect(m_server, &QProcess::readyReadStandardError, this, &ExecExternalFetcher::slotServerError);
+  void (QProcess::* finished)(int, QProcess::ExitStatus) = &QProcess::finished;
+  connect(m_server, finished, this, &ExecExternalFetcher::slotServerExited);
+  m_server->setOutputChannelMode(KProcess::SeparateChannels);
+  m_server->setProgram(m_path, parseArguments(m_persistentArgs));
+  m_server->start();
+  if(!m_server->waitForStarted()) {
+    myLog() << source() << ": persistent process failed to start, running once per search instead";
+    m_server->disconnect(this);
+    m_server->deleteLater();
+    m_server = nullptr;
+    m_serverFailed = true;
+    return false;
+  }
+  return true;
+}
+
+void ExecExternalFetcher::sendRequest(const QStringList& args_) {
+  // zero means no request is waiting
+  if(++m_lastRequestId == 0) {
+    ++m_lastRequestId;
+  }
+  m_requestId = m_lastRequestId;
+  m_serverRequests.insert(m_requestId, ServerRequest{request(), args_});
+
+  QByteArray line = QByteArray::number(m_requestId);
+  foreach(const QString& arg, args_) {
+    QByteArray value = arg.toUtf8();
+    value.replace('\\', "\\\\").replace('\t', "\\t").replace('\n', "\\n");
+    line += '\t';
+    line += value;
+  }
+  line += '\n';
+  m_server->write(line);
+}
+
 void ExecExternalFetcher::stop() {
   if(!m_started) {
     return;
   }
+  // the request stays in the list of requests sent to the application, and its response gets dropped
+  m_requestId = 0;
   if(m_process) {
     if(m_process->state() != QProcess::NotRunning) {
       myLog() << "Stopping external process";
@@ -238,8 +298,12 @@ void ExecExternalFetcher::slotData() {
 }
 
 void ExecExternalFetcher::slotError() {
+  addError(m_process->readAllStandardError());
+}
+
+void ExecExternalFetcher::addError(const QByteArray& error_) {
   GUI::CursorSaver cs(Qt::ArrowCursor);
-  QString msg = QString::fromLocal8Bit(m_process->readAllStandardError());
+  QString msg = QString::fromLocal8Bit(error_);
   if(msg.isEmpty()) return;
   msg.prepend(source() + QLatin1String(": "));
   if(msg.endsWith(QChar::fromLatin1('\n'))) {
@@ -262,23 +326,90 @@ void ExecExternalFetcher::slotProcessExited() {
     stop();
     return;
   }
+  parseResults(m_data);
+}
+
+void ExecExternalFetcher::slotServerData() {
+  m_serverData.append(m_server->readAllStandardOutput());
+  while(m_server) {
+    const auto eol = m_serverData.indexOf('\n');
+    if(eol < 0) {
+      return;
+    }
+    const QList<QByteArray> header = m_serverData.left(eol).trimmed().split(' ');
+    bool idOk = false, lengthOk = false;
+    const uint id = header.value(0).toUInt(&idOk);
+    const qsizetype length = header.value(1).toLongLong(&lengthOk);
+    if(header.size() != 2 || !idOk || !lengthOk || length < 0) {
+      myLog() << source() << ": invalid response from persistent process";
+      // slotServerExited() falls back to running once per search
+      m_server->kill();
+      return;
+    }
+    if(m_serverData.size() < eol + 1 + length) {
+      // wait for the rest of the response
+      return;
+    }
+    const QByteArray data = m_serverData.mid(eol + 1, length);
+    m_serverData.remove(0, eol + 1 + length);
+    auto it = m_serverRequests.find(id);
+    if(it == m_serverRequests.end()) {
+      myLog() << source() << ": response to an unknown request" << id;
+      continue;
+    }
+    const ServerRequest serverRequest = it.value();
+    m_serverRequests.erase(it);
+    // responses to stopped requests are dropped
+    if(id != m_requestId) {
+      myLog() << source() << ": dropping the response to a stopped search for" << serverRequest.request.value();
+      continue;
+    }
+    m_requestId = 0;
+    parseResults(data);
+  }
+}
+
+void ExecExternalFetcher::slotServerError() {
+  addError(m_server->readAllStandardError());
+}
+
+void ExecExternalFetcher::slotServerExited() {
+  if(m_server) {
+    m_server->deleteLater();
+    m_server = nullptr;
+  }
+  m_serverData.clear();
+  // don't keep restarting an application that can't stay running
+  myLog() << source() << ": persistent process exited, running once per search instead";
+  m_serverFailed = true;
+  // only the current search gets run again, the responses to any others were going to be dropped
+  const ServerRequest current = m_serverRequests.value(m_requestId);
+  m_serverRequests.clear();
+  if(m_started && m_requestId != 0) {
+    m_requestId = 0;
+    m_errors.clear();
+    startSearch(current.args);
+  }
+}
+
+void ExecExternalFetcher::parseResults(const QByteArray& data_) {
   if(!m_errors.isEmpty()) {
     message(m_errors.join(QChar::fromLatin1('\n')), MessageHandler::Warning);
   }
 
-  if(m_data.isEmpty()) {
+  if(data_.isEmpty()) {
     myLog() << source() << ": no data returned";
     stop();
     return;
   }
 
-  const QString text = QString::fromUtf8(m_data.constData(), m_data.size());
+  const QString text = QString::fromUtf8(data_.constData(), data_.size());
 #if 0
   myWarning() << "Remove debug from ExecExternalFetcher.cpp";
   QFile f(QStringLiteral("/tmp/test-exec.txt"));
   if(f.open(QIODevice::WriteOnly)) {
     QTextStream t(&f);
-    t << m_data;
+    t << data_;
   }
   f.close();
 #endif
@@ -374,7 +505,7 @@ QString ExecExternalFetcher::defaultIcon() {
 }
 
 ExecExternalFetcher::ConfigWidget::ConfigWidget(QWidget* parent_, const ExecExternalFetcher* fetcher_/*=0*/)
-    : Fetch::ConfigWidget(parent_), m_deleteOnRemove(false) {
+    : Fetch::ConfigWidget(parent_), m_deleteOnRemove(false), m_persistent(false) {
   auto l = new QGridLayout(optionsWidget());
   l->setSpacing(4);
   l->setColumnStretch(1, 10);
@@ -504,6 +635,10 @@ ExecExternalFetcher::ConfigWidget::ConfigWidget(QWidget* parent_, const ExecExte
     m_formatCombo->setCurrentData(Import::TellicoXML);
   }
   m_deleteOnRemove = fetcher_ && fetcher_->m_deleteOnRemove;
+  if(fetcher_) {
+    m_persistent = fetcher_->m_persistent;
+    m_persistentArgs = fetcher_->m_persistentArgs;
+  }
   KAcceleratorManager::manage(optionsWidget());
 }
 
@@ -598,6 +733,8 @@ void ExecExternalFetcher::ConfigWidget::readConfig(const KConfigGroup& config_)
   m_deleteOnRemove = config_.readEntry("DeleteOnRemove", false);
   m_name = config_.readEntry("Name");
   m_newStuffName = config_.readEntry("NewStuffName");
+  m_persistent = config_.hasKey("PersistentArgs");
+  m_persistentArgs = config_.readEntry("PersistentArgs");
 }
 
 void ExecExternalFetcher::ConfigWidget::saveConfigHook(KConfigGroup& config_) {
@@ -645,6 +782,11 @@ void ExecExternalFetcher::ConfigWidget::saveConfigHook(KConfigGroup& config_) {
   if(!m_newStuffName.isEmpty()) {
     config_.writeEntry("NewStuffName", m_newStuffName);
   }
+  if(m_persistent) {
+    config_.writeEntry("PersistentArgs", m_persistentArgs);
+  } else {
+    config_.deleteEntry("PersistentArgs");
+  }
 }
 
 void ExecExternalFetcher::ConfigWidget::removed() {
@@ -49,6 +49,16 @@ namespace Tellico {
   namespace Fetch {
 
 /**
+ * Runs an external application for each search and imports whatever it writes to stdout.
+ *
+ * If the configuration includes PersistentArgs, the application is instead started once with
+ * those arguments and kept running. Each search is written to its stdin as a single line with a
+ * request id followed by the tab-separated arguments. Backslashes, tabs, and newlines within an
+ * argument are escaped C-style. Each response is a line with the request id and the byte length of
+ * the result, separated by a space, followed by exactly that many bytes. Several requests may be
+ * waiting on the application at once, and the responses may come back in any order. If the
+ * application exits, searches fall back to running it once per search.
+ *
  * @author Robby Stephenson
  */
 class ExecExternalFetcher : public Fetcher {
@@ -85,6 +95,9 @@ private Q_SLOTS:
   void slotData();
   void slotError();
   void slotProcessExited();
+  void slotServerData();
+  void slotServerError();
+  void slotServerExited();
 
 private:
   friend class ::ExternalFetcherTest;
@@ -93,6 +106,10 @@ private:
   virtual void search() override;
   virtual FetchRequest updateRequest(Data::EntryPtr entry) override;
   void startSearch(const QStringList& args);
+  bool startServer();
+  void sendRequest(const QStringList& args);
+  void addError(const QByteArray& error);
+  void parseResults(const QByteArray& data);
 
   bool m_started;
   int m_collType;
@@ -109,6 +126,20 @@ private:
   QStringList m_errors;
   bool m_deleteOnRemove;
   QString m_newStuffName;
+  // persistent mode
+  bool m_persistent;
+  bool m_serverFailed; // the application didn't stay running, so it gets run once per search
+  QString m_persistentArgs;
+  QPointer<KProcess> m_server;
+  QByteArray m_serverData;
+  uint m_lastRequestId;
+  uint m_requestId; // the request for the current search, 0 if none
+  // the requests which have been sent to the application and not answered yet, by request id
+  struct ServerRequest {
+    FetchRequest request;
+    QStringList args;
+  };
+  QHash<uint, ServerRequest> m_serverRequests;
 };
 
 class ExecExternalFetcher::ConfigWidget : public Fetch::ConfigWidget {
@@ -139,6 +170,9 @@ private:
   QList<GUI::LineEdit*> m_argEdits;
   QCheckBox* m_cbUpdate;
   GUI::LineEdit* m_leUpdate;
+  // not editable, but carried over from the spec file
+  bool m_persistent;
+  QString m_persistentArgs;
 };
 
   } // end namespace
@@ -36,6 +36,7 @@
 
 #include <QUrl>
 #include <QUuid>
+#include <QCryptographicHash>
 #include <QPointer>
 
 using namespace Tellico::Fetch;
@@ -137,6 +138,23 @@ void Fetcher::setConfigGroup(const KConfigGroup& group_) {
   m_configGroup = group_;
 }
 
+QByteArray Fetcher::configHash() const {
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  // the optional fields are included even when there's no saved config
+  hash.addData(m_fields.join(QLatin1Char(',')).toUtf8());
+  if(m_configGroup.isValid()) {
+    // the entry map is sorted by key, so the hash doesn't depend on the order in the file
+    const QMap<QString, QString> entries = m_configGroup.entryMap();
+    for(auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+      hash.addData(QByteArrayView("\n"));
+      hash.addData(it.key().toUtf8());
+      hash.addData(QByteArrayView("="));
+      hash.addData(it.value().toUtf8());
+    }
+  }
+  return hash.result();
+}
+
 Tellico::Data::EntryPtr Fetcher::fetchEntry(uint uid_) {
   // check if already fetched this entry
   if(m_entries.contains(uid_)) {
@@ -101,6 +101,10 @@ public:
   const FetchRequest& request() const;
   QStringList optionalFields() const { return m_fields; }
   QString uuid() const { return m_uuid; }
+  /**
+   * Returns a hash of the saved config, which changes whenever the options do
+   */
+  QByteArray configHash() const;
   /**
    * Starts a search, using a key and value. Calls search()
    */
@@ -0,0 +1,190 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "fetchresultcache.h"
+#include "fetchresult.h"
+#include "fetcher.h"
+#include "../translators/tellicoxmlexporter.h"
+#include "../translators/tellicoimporter.h"
+#include "../collection.h"
+#include "../entry.h"
+#include "../tellico_debug.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace {
+  // 20 MB is plenty for a few thousand entries with cover images
+  static const qint64 FETCH_CACHE_MAX_SIZE = 20 * 1024 * 1024;
+  // remote data does change, so don't keep anything around forever
+  static const int FETCH_CACHE_MAX_AGE_DAYS = 30;
+}
+
+using Tellico::Fetch::FetchResultCache;
+
+FetchResultCache::FetchResultCache(const QString& dirPath_) : m_dirPath(dirPath_)
+    , m_maxSize(FETCH_CACHE_MAX_SIZE), m_size(-1) {
+  if(m_dirPath.isEmpty()) {
+    m_dirPath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/fetchresults/");
+  } else if(!m_dirPath.endsWith(QLatin1Char('/'))) {
+    m_dirPath += QLatin1Char('/');
+  }
+}
+
+QString FetchResultCache::resultKey(FetchResult* result_) {
+  if(!result_ || !result_->fetcher()) {
+    return QString();
+  }
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  hash.addData(result_->fetcher()->uuid().toUtf8());
+  hash.addData(QByteArrayView("\n"));
+  // the same result can be fetched differently for another collection type or other options
+  hash.addData(QByteArray::number(result_->fetcher()->collectionType()));
+  hash.addData(QByteArrayView("\n"));
+  hash.addData(result_->fetcher()->configHash());
+  hash.addData(QByteArrayView("\n"));
+  hash.addData(result_->title.toUtf8());
+  hash.addData(QByteArrayView("\n"));
+  hash.addData(result_->desc.toUtf8());
+  hash.addData(QByteArrayView("\n"));
+  hash.addData(result_->isbn.toUtf8());
+  return QString::fromLatin1(hash.result().toHex());
+}
+
+QString FetchResultCache::filePath(const QString& key_) const {
+  return m_dirPath + key_ + QLatin1String(".xml");
+}
+
+Tellico::Data::EntryPtr FetchResultCache::entry(const QString& key_) {
+  if(key_.isEmpty()) {
+    return Data::EntryPtr();
+  }
+  const QString path = filePath(key_);
+  QFileInfo info(path);
+  if(!info.exists()) {
+    return Data::EntryPtr();
+  }
+  if(info.lastModified().daysTo(QDateTime::currentDateTime()) > FETCH_CACHE_MAX_AGE_DAYS) {
+    remove(key_);
+    return Data::EntryPtr();
+  }
+
+  QFile file(path);
+  if(!file.open(QIODevice::ReadOnly)) {
+    return Data::EntryPtr();
+  }
+  Import::TellicoImporter imp(QString::fromUtf8(file.readAll()));
+  Data::CollPtr coll = imp.collection();
+  if(!coll || coll->entries().isEmpty()) {
+    myDebug() << "removing unreadable cache file" << path;
+    file.close();
+    remove(key_);
+    return Data::EntryPtr();
+  }
+  // the modification time tracks when the entry was last used
+  file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+  return coll->entries().front();
+}
+
+void FetchResultCache::insert(const QString& key_, Data::EntryPtr entry_) {
+  if(key_.isEmpty() || !entry_ || !entry_->collection()) {
+    return;
+  }
+  if(!QDir().mkpath(m_dirPath)) {
+    myDebug() << "unable to create" << m_dirPath;
+    return;
+  }
+
+  Export::TellicoXMLExporter exporter(entry_->collection(), QUrl());
+  exporter.setEntries(Data::EntryList() << entry_);
+  exporter.setOptions(exporter.options() | Export::ExportUTF8);
+  exporter.setIncludeImages(true);
+  const QByteArray data = exporter.text().toUtf8();
+
+  const QString path = filePath(key_);
+  const qint64 oldSize = QFileInfo(path).size();
+  QSaveFile file(path);
+  if(!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+    myDebug() << "unable to write" << path;
+    return;
+  }
+  if(m_size > -1) {
+    m_size += data.size() - oldSize;
+  }
+  if(size() > m_maxSize) {
+    prune();
+  }
+}
+
+void FetchResultCache::remove(const QString& key_) {
+  const QString path = filePath(key_);
+  const qint64 fileSize = QFileInfo(path).size();
+  if(QFile::remove(path) && m_size > -1) {
+    m_size -= fileSize;
+  }
+}
+
+void FetchResultCache::setMaxSize(qint64 bytes_) {
+  m_maxSize = bytes_;
+  if(size() > m_maxSize) {
+    prune();
+  }
+}
+
+qint64 FetchResultCache::size() const {
+  if(m_size < 0) {
+    m_size = 0;
+    QDir dir(m_dirPath);
+    foreach(const QFileInfo& info, dir.entryInfoList(QDir::Files)) {
+      m_size += info.size();
+    }
+  }
+  return m_size;
+}
+
+void FetchResultCache::prune() {
+  // remove the least recently used files until the cache is comfortably below its limit,
+  // so that every insertion does not need to read the whole directory
+  const qint64 target = m_maxSize * 3 / 4;
+  QDir dir(m_dirPath);
+  const QFileInfoList files = dir.entryInfoList(QDir::Files, QDir::Time | QDir::Reversed);
+  m_size = 0;
+  foreach(const QFileInfo& info, files) {
+    m_size += info.size();
+  }
+  foreach(const QFileInfo& info, files) {
+    if(m_size <= target) {
+      break;
+    }
+    if(QFile::remove(info.filePath())) {
+      m_size -= info.size();
+    }
+  }
+}
@@ -0,0 +1,83 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef TELLICO_FETCH_FETCHRESULTCACHE_H
+#define TELLICO_FETCH_FETCHRESULTCACHE_H
+
+#include "../datavectors.h"
+
+#include <QString>
+
+namespace Tellico {
+  namespace Fetch {
+
+class FetchResult;
+
+/**
+ * A persistent cache of the entries fetched for search results, so that showing or
+ * adding a result which was fetched before does not require another request to the
+ * data source. Each entry is saved in the cache directory along with its images.
+ * When the cache grows too large, the least recently used entries are removed.
+ *
+ * @author Robby Stephenson
+ */
+class FetchResultCache {
+public:
+  /**
+   * @param dirPath The cache directory. If empty, the user's cache location is used
+   */
+  explicit FetchResultCache(const QString& dirPath = QString());
+
+  /**
+   * Returns a key for the search result, which is the same every time the same
+   * result is returned by the same data source.
+   */
+  static QString resultKey(FetchResult* result);
+
+  /**
+   * Returns the cached entry for a key, or a null pointer if it is not in the cache.
+   */
+  Data::EntryPtr entry(const QString& key);
+  void insert(const QString& key, Data::EntryPtr entry);
+  void remove(const QString& key);
+
+  qint64 maxSize() const { return m_maxSize; }
+  void setMaxSize(qint64 bytes);
+  qint64 size() const;
+
+private:
+  Q_DISABLE_COPY(FetchResultCache)
+  QString filePath(const QString& key) const;
+  void prune();
+
+  QString m_dirPath;
+  qint64 m_maxSize;
+  mutable qint64 m_size; // -1 until the directory is read
+};
+
+  } // end namespace
+} // end namespace
+
+#endif
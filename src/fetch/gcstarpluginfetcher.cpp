@@ -23,7 +23,6 @@
  ***************************************************************************/
 
 #include "gcstarpluginfetcher.h"
-#include "gcstarthread.h"
 #include "fetchmanager.h"
 #include "../collection.h"
 #include "../entry.h"
@@ -44,6 +43,7 @@
 #include <KCompressionDevice>
 
 #include <QTemporaryDir>
+#include <QFile>
 #include <QDir>
 #include <QLabel>
 #include <QShowEvent>
@@ -61,7 +61,7 @@ GCstarPluginFetcher::PluginParse GCstarPluginFetcher::pluginParse = NotYet;
 GCstarPluginFetcher::PluginList GCstarPluginFetcher::plugins(int collType_) {
   if(!collectionPlugins.contains(collType_)) {
     GUI::CursorSaver cs;
-    QString gcstar = QStandardPaths::findExecutable(QStringLiteral("gcstar"));
+    const QString gcstar = gcstarExecutable();
 
     if(pluginParse == NotYet) {
       KProcess proc;
@@ -197,18 +197,23 @@ QString GCstarPluginFetcher::gcstarType(int collType_) {
   return QString();
 }
 
+QString GCstarPluginFetcher::gcstarExecutable() {
+  // the executable path doesn't change while running, so only look for it once
+  static const QString gcstar = QStandardPaths::findExecutable(QStringLiteral("gcstar"));
+  return gcstar;
+}
+
 GCstarPluginFetcher::GCstarPluginFetcher(QObject* parent_) : Fetcher(parent_),
-    m_started(false), m_collType(-1), m_thread(nullptr) {
+    m_started(false), m_collType(-1), m_process(nullptr), m_exportDir(nullptr) {
 }
 
 GCstarPluginFetcher::~GCstarPluginFetcher() {
-  if(m_thread) {
-    if(m_thread->isRunning()) {
-      m_thread->terminate();
-      m_thread->wait();
-    }
-    delete m_thread;
+  if(m_process) {
+    m_process->kill();
+    m_process->waitForFinished();
+    delete m_process;
   }
+  delete m_exportDir;
 }
 
 QString GCstarPluginFetcher::source() const {
@@ -235,62 +240,82 @@ void GCstarPluginFetcher::search() {
 
   m_data.clear();
 
-  const QString gcstar = QStandardPaths::findExecutable(QStringLiteral("gcstar"));
+  const QString gcstar = gcstarExecutable();
   if(gcstar.isEmpty()) {
     myWarning() << "gcstar not found!";
     stop();
     return;
   }
 
+  // every search gets its own export location so that searches from
+  // multiple GCstar sources can run at the same time without clobbering each other
+  delete m_exportDir;
+  m_exportDir = new QTemporaryDir();
+  if(!m_exportDir->isValid()) {
+    myWarning() << "unable to create temporary directory";
+    stop();
+    return;
+  }
+  const QString exportPrefs = QStringLiteral("collection=>%1,file=>%2")
+                              .arg(m_exportDir->filePath(QStringLiteral("collection.gcs")),
+                                   m_exportDir->filePath(QStringLiteral("collection.tar.gz")));
+
   QStringList args;
   args << QStringLiteral("--execute")
        << QStringLiteral("--collection")  << gcstarType(m_collType)
        << QStringLiteral("--export")      << QStringLiteral("TarGz")
-       << QStringLiteral("--exportprefs") << QStringLiteral("collection=>/tmp/test.gcs,file=>/tmp/test1.tar.gz")
+       << QStringLiteral("--exportprefs") << exportPrefs
        << QStringLiteral("--website")     << m_plugin
        << QStringLiteral("--download")    << KShell::quoteArg(request().value());
   myLog() << args;
 
-  m_thread = new GCstarThread(this);
-  m_thread->setProgram(gcstar, args);
-  connect(m_thread, &GCstarThread::standardOutput, this, &GCstarPluginFetcher::slotData);
-  connect(m_thread, &GCstarThread::standardError, this, &GCstarPluginFetcher::slotError);
-  connect(m_thread, &QThread::finished, this, &GCstarPluginFetcher::slotProcessExited);
-  m_thread->start();
+  m_process = new KProcess(this);
+  connect(m_process, &QProcess::readyReadStandardOutput, this, &GCstarPluginFetcher::slotData);
+  connect(m_process, &QProcess::readyReadStandardError, this, &GCstarPluginFetcher::slotError);
+  void (QProcess::* finished)(int, QProcess::ExitStatus) = &QProcess::finished;
+  connect(m_process, finished, this, &GCstarPluginFetcher::slotProcessExited);
+  m_process->setOutputChannelMode(KProcess::SeparateChannels);
+  m_process->setProgram(gcstar, args);
+  m_process->start();
+  if(!m_process->waitForStarted()) {
+    myWarning() << "gcstar failed to start";
+    stop();
+  }
 }
 
 void GCstarPluginFetcher::stop() {
   if(!m_started) {
     return;
   }
-  if(m_thread) {
-    if(m_thread->isRunning()) {
-      m_thread->terminate();
-      m_thread->wait();
+  if(m_process) {
+    // stop() can be called from within the finished signal, so the process is deleted later
+    m_process->disconnect(this);
+    if(m_process->state() != QProcess::NotRunning) {
+      m_process->kill();
     }
-    delete m_thread;
-    m_thread = nullptr;
+    m_process->deleteLater();
+    m_process = nullptr;
   }
+  delete m_exportDir;
+  m_exportDir = nullptr;
   m_data.clear();
   m_started = false;
   m_errors.clear();
   Q_EMIT signalDone(this);
 }
 
-void GCstarPluginFetcher::slotData(const QByteArray& data_) {
-  m_data.append(data_);
+void GCstarPluginFetcher::slotData() {
+  m_data.append(m_process->readAllStandardOutput());
 }
 
-void GCstarPluginFetcher::slotError(const QByteArray& data_) {
-  QString msg = QString::fromLocal8Bit(data_);
+void GCstarPluginFetcher::slotError() {
+  QString msg = QString::fromLocal8Bit(m_process->readAllStandardError());
   msg.prepend(source() + QLatin1String(": "));
   myDebug() << msg;
   m_errors << msg;
 }
 
 void GCstarPluginFetcher::slotProcessExited() {
-  // if stop() is called and the thread terminated
-  // the finished() signal will still fire
   if(!m_started) {
     return;
   }
@@ -299,6 +324,14 @@ void GCstarPluginFetcher::slotProcessExited() {
     message(m_errors.join(QLatin1String("\n")), MessageHandler::Warning);
   }
 
+  if(m_data.isEmpty() && m_exportDir) {
+    // nothing on stdout, so check if gcstar wrote the export file instead
+    QFile exportFile(m_exportDir->filePath(QStringLiteral("collection.tar.gz")));
+    if(exportFile.open(QIODevice::ReadOnly)) {
+      m_data = exportFile.readAll();
+    }
+  }
+
   if(m_data.isEmpty()) {
     myDebug() << source() << ": no data";
     stop();
@@ -33,6 +33,8 @@
 #include <QList>
 
 class QLabel;
+class QTemporaryDir;
+class KProcess;
 
 namespace Tellico {
   namespace GUI {
@@ -41,9 +43,10 @@ namespace Tellico {
   }
   namespace Fetch {
 
-  class GCstarThread;
-
 /**
+ * Runs a GCstar plugin search as an asynchronous process, so several GCstar sources can
+ * search at the same time. Each search exports to its own temporary directory.
+ *
  * @author Robby Stephenson
  */
 class GCstarPluginFetcher : public Fetcher {
@@ -75,8 +78,8 @@ public:
   static StringHash allOptionalFields() { return StringHash(); }
 
 private Q_SLOTS:
-  void slotData(const QByteArray& data);
-  void slotError(const QByteArray& data);
+  void slotData();
+  void slotError();
   void slotProcessExited();
 
 private:
@@ -96,12 +99,14 @@ private:
   static void readPluginsNew(int collType, const QString& exe);
   static void readPluginsOld(int collType, const QString& exe);
   static QString gcstarType(int collType);
+  static QString gcstarExecutable();
 
   bool m_started;
   int m_collType;
   QString m_plugin;
 
-  GCstarThread* m_thread;
+  KProcess* m_process;
+  QTemporaryDir* m_exportDir;
   QByteArray m_data;
   QHash<uint, Data::EntryPtr> m_entries; // map from search result id to entry
   QStringList m_errors;
@@ -33,6 +33,7 @@
 #include <KConfigGroup>
 
 #include <QLabel>
+#include <QTimer>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 
@@ -40,7 +41,10 @@ using namespace Tellico;
 using Tellico::Fetch::MultiFetcher;
 
 MultiFetcher::MultiFetcher(QObject* parent_)
-    : Fetcher(parent_), m_collType(0), m_fetcherIndex(0), m_resultIndex(0), m_started(false) {
+    : Fetcher(parent_), m_collType(0), m_timeout(0), m_emitIndex(0), m_timer(new QTimer(this))
+    , m_started(false), m_searchingFirst(false), m_stoppingSources(false) {
+  m_timer->setSingleShot(true);
+  connect(m_timer, &QTimer::timeout, this, &MultiFetcher::slotTimeout);
 }
 
 MultiFetcher::~MultiFetcher() {
@@ -64,6 +68,8 @@ bool MultiFetcher::canSearch(Fetch::FetchKey k) const {
 void MultiFetcher::readConfigHook(const KConfigGroup& config_) {
   m_collType = config_.readEntry("CollectionType", -1);
   m_uuids = config_.readEntry("Sources", QStringList());
+  // an overall time limit for the search, in seconds. Zero means no limit
+  m_timeout = config_.readEntry("Timeout", 0);
 }
 
 void MultiFetcher::readSources() const {
@@ -89,12 +95,20 @@ void MultiFetcher::readSources() const {
 void MultiFetcher::search() {
   m_started = true;
   readSources();
+  m_entries.clear();
+  m_updateSources.clear();
+  m_bestMatches.clear();
+  m_pendingSources.clear();
+  m_emitIndex = 0;
   if(m_fetchers.isEmpty()) {
 //    myDebug() << source() << "has no sources";
-    slotDone();
+    finish();
     return;
   }
-  m_matches.clear();
+  if(m_timeout > 0) {
+    m_timer->start(m_timeout * 1000);
+  }
+  m_searchingFirst = true;
 //  myDebug() << "Starting" << m_fetchers.front()->source();
   m_fetchers.front()->startSearch(request());
 }
@@ -104,78 +118,189 @@ void MultiFetcher::stop() {
     return;
   }
   m_started = false;
+  m_timer->stop();
+  stopSources();
+  Q_EMIT signalDone(this);
+}
+
+void MultiFetcher::stopSources() {
+  // any results or done signals from the sources while stopping are ignored
+  m_stoppingSources = true;
   foreach(Fetcher::Ptr fetcher, m_fetchers) {
-    fetcher->stop();
+    if(fetcher && fetcher->isSearching()) {
+      fetcher->stop();
+    }
   }
-  // no need to emit done, since slotDone() will get called
+  m_stoppingSources = false;
+}
+
+int MultiFetcher::updateSourceIndex(Fetcher* fetcher_) const {
+  for(int i = 0; i < m_updateSources.count(); ++i) {
+    if(m_updateSources.at(i).fetcher.data() == fetcher_) {
+      return i;
+    }
+  }
+  return -1;
 }
 
 void MultiFetcher::slotResult(Tellico::Fetch::FetchResult* result) {
+  if(!m_started || m_stoppingSources) {
+    return;
+  }
   Data::EntryPtr newEntry = result->fetchEntry();
-  // if fetcher index is 0, this is the first set of results, save them all
-  if(m_fetcherIndex == 0) {
+  if(!newEntry) {
+    return;
+  }
+  // while the first source is searching, save all the results
+  if(m_searchingFirst) {
 //    myDebug() << "...found new result:" << newEntry->title();
     m_entries.append(newEntry);
     return;
   }
 
   // otherwise, keep the entry to compare later
-  m_matches.append(newEntry);
+  const int idx = updateSourceIndex(result->fetcher());
+  if(idx > -1) {
+    m_updateSources[idx].matches.append(newEntry);
+  }
 }
 
-void MultiFetcher::slotDone() {
-  if(m_fetcherIndex == 0) {
-    m_fetcherIndex++;
-    m_resultIndex = 0;
-  } else {
-    // iterate over all the matches from this data source and figure out which one is the best match to the existing result
-    Data::EntryPtr entry = m_entries.at(m_resultIndex);
-    int bestScore = -1;
-    int bestIndex = -1;
-    for(int idx = 0; idx < m_matches.count(); ++idx) {
-      auto match = m_matches.at(idx);
-      const int score = entry->collection()->sameEntry(entry, match);
-      if(score > bestScore) {
-        bestScore = score;
-        bestIndex = idx;
-      }
-      if(score >= EntryComparison::ENTRY_PERFECT_MATCH) {
-        // no need to compare further
-        break;
-      }
+void MultiFetcher::slotDone(Tellico::Fetch::Fetcher* fetcher_) {
+  if(!m_started || m_stoppingSources) {
+    return;
+  }
+  if(m_searchingFirst) {
+    if(fetcher_ == m_fetchers.front().data()) {
+      m_searchingFirst = false;
+      startUpdates();
     }
-//    myDebug() << "best score" << bestScore  << "; index:" << bestIndex;
-    if(bestIndex > -1 && bestScore >= EntryComparison::ENTRY_GOOD_MATCH) {
-      auto newEntry = m_matches.at(bestIndex);
-//      myDebug() << "...merging from" << newEntry->title() << "into" << entry->title();
-      Merge::mergeEntry(entry, newEntry);
-    } else {
-//      myDebug() << "___no match for" << entry->title();
+    return;
+  }
+
+  const int sourceIndex = updateSourceIndex(fetcher_);
+  if(sourceIndex < 0 || m_updateSources.at(sourceIndex).resultIndex < 0) {
+    return;
+  }
+
+  // iterate over all the matches from this data source and figure out which one is the best match to the existing result
+  UpdateSource& source = m_updateSources[sourceIndex];
+  const int resultIndex = source.resultIndex;
+  Data::EntryPtr entry = m_entries.at(resultIndex);
+  int bestScore = -1;
+  int bestIndex = -1;
+  for(int idx = 0; idx < source.matches.count(); ++idx) {
+    auto match = source.matches.at(idx);
+    const int score = entry->collection()->sameEntry(entry, match);
+    if(score > bestScore) {
+      bestScore = score;
+      bestIndex = idx;
     }
+    if(score >= EntryComparison::ENTRY_PERFECT_MATCH) {
+      // no need to compare further
+      break;
+    }
+  }
+//  myDebug() << "best score" << bestScore  << "; index:" << bestIndex;
+  if(bestIndex > -1 && bestScore >= EntryComparison::ENTRY_GOOD_MATCH) {
+    // the merge waits until all the sources are done with the result, to keep the source order
+    m_bestMatches[resultIndex][sourceIndex] = source.matches.at(bestIndex);
+  }
+  source.matches.clear();
+  --m_pendingSources[resultIndex];
 
-    // now, bump to next result and continue trying to match
-    m_resultIndex++;
-    if(m_resultIndex >= m_entries.count()) {
-      m_fetcherIndex++;
-      m_resultIndex = 0;
+  emitResults();
+  if(m_started) {
+    updateNext(sourceIndex);
+  }
+}
+
+void MultiFetcher::startUpdates() {
+  // the same fetcher can only run one search at a time, and updating from it twice does nothing more
+  for(int i = 1; i < m_fetchers.count(); ++i) {
+    Fetcher::Ptr fetcher = m_fetchers.at(i);
+    if(fetcher && updateSourceIndex(fetcher.data()) == -1) {
+      m_updateSources.append(UpdateSource{fetcher, -1, Data::EntryList()});
     }
   }
 
-  if(m_fetcherIndex < m_fetchers.count() && m_resultIndex < m_entries.count()) {
-    Fetcher::Ptr fetcher = m_fetchers.at(m_fetcherIndex);
-    Q_ASSERT(fetcher);
-//    myDebug() << "updating entry#" << m_resultIndex << "from" << fetcher->source();
-    fetcher->startUpdate(m_entries.at(m_resultIndex));
+  for(int i = 0; i < m_entries.count(); ++i) {
+    m_bestMatches.append(Data::EntryList(m_updateSources.count()));
+    m_pendingSources.append(m_updateSources.count());
+  }
+
+  if(m_entries.isEmpty() || m_updateSources.isEmpty()) {
+    emitResults();
+    return;
+  }
+
+  // a fetcher might be done immediately, which starts its next update before this loop continues
+  for(int i = 0; i < m_updateSources.count() && m_started; ++i) {
+    updateNext(i);
+  }
+}
+
+void MultiFetcher::updateNext(int sourceIndex_) {
+  UpdateSource& source = m_updateSources[sourceIndex_];
+  const int resultIndex = source.resultIndex + 1;
+  if(resultIndex >= m_entries.count()) {
+    source.resultIndex = -1;
     return;
   }
+  source.resultIndex = resultIndex;
+  Fetcher::Ptr fetcher = source.fetcher;
+//  myDebug() << "updating entry#" << resultIndex << "from" << fetcher->source();
+  // the fetcher might emit done before returning, so the source reference must not be used after this
+  fetcher->startUpdate(m_entries.at(resultIndex));
+}
 
-  // at this point, all the fetchers have run through all the results, so we're
-  // done so emit all results
-  foreach(Data::EntryPtr entry, m_entries) {
+void MultiFetcher::emitResults() {
+  // results are emitted in order, as soon as all the data sources are done with them
+  while(m_emitIndex < m_entries.count() && m_pendingSources.at(m_emitIndex) == 0) {
+    Data::EntryPtr entry = m_entries.at(m_emitIndex);
+    foreach(Data::EntryPtr match, m_bestMatches.at(m_emitIndex)) {
+      if(match) {
+//        myDebug() << "...merging from" << match->title() << "into" << entry->title();
+        Merge::mergeEntry(entry, match);
+      }
+    }
+    ++m_emitIndex;
     FetchResult* r = new FetchResult(this, entry);
     m_entryHash.insert(r->uid, entry);
     Q_EMIT signalResultFound(r);
+    // the search might get stopped when a result is found
+    if(!m_started) {
+      return;
+    }
+  }
+
+  if(m_emitIndex >= m_entries.count()) {
+    finish();
+  }
+}
+
+void MultiFetcher::slotTimeout() {
+  if(!m_started) {
+    return;
+  }
+  myLog() << source() << "reached the time limit of" << m_timeout << "seconds";
+  stopSources();
+  if(m_searchingFirst) {
+    m_searchingFirst = false;
+    for(int i = 0; i < m_entries.count(); ++i) {
+      m_bestMatches.append(Data::EntryList());
+      m_pendingSources.append(0);
+    }
+  }
+  // whatever has been merged so far gets used
+  for(int i = 0; i < m_pendingSources.count(); ++i) {
+    m_pendingSources[i] = 0;
   }
+  emitResults();
+}
+
+void MultiFetcher::finish() {
+  m_timer->stop();
+  m_started = false;
   Q_EMIT signalDone(this);
 }
 
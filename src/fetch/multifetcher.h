@@ -32,6 +32,8 @@
 
 #include <QFrame>
 
+class QTimer;
+
 namespace Tellico {
 
   namespace GUI {
@@ -44,6 +46,12 @@ namespace Tellico {
 /**
  * A fetcher for combining results from multiple other fetchers
  *
+ * The results from the first source are updated by all the other sources at the same time.
+ * Each source works through the results in order, and a result is emitted as soon as
+ * every source has had a chance to update it. The merges are always done in the order
+ * of the sources. An optional time limit ends the search early, with whatever has been
+ * merged so far.
+ *
  * @author Robby Stephenson
  */
 class MultiFetcher : public Fetcher {
@@ -84,23 +92,44 @@ public:
 
 private Q_SLOTS:
   void slotResult(Tellico::Fetch::FetchResult* result);
-  void slotDone();
+  void slotDone(Tellico::Fetch::Fetcher* fetcher);
+  void slotTimeout();
 
 private:
   virtual void search() override;
   virtual FetchRequest updateRequest(Data::EntryPtr entry) override;
   void readSources() const;
+  int updateSourceIndex(Fetcher* fetcher) const;
+  void startUpdates();
+  void updateNext(int sourceIndex);
+  void emitResults();
+  void stopSources();
+  void finish();
+
+  // one of the sources used to update the results from the first source
+  struct UpdateSource {
+    Fetcher::Ptr fetcher;
+    int resultIndex; // the result currently being updated, -1 if not started
+    Data::EntryList matches;
+  };
 
   Data::EntryList m_entries;
-  Data::EntryList m_matches;
   QHash<uint, Data::EntryPtr> m_entryHash;
   int m_collType;
+  int m_timeout; // in seconds
   QStringList m_uuids;
   mutable QList<Fetcher::Ptr> m_fetchers;
-  int m_fetcherIndex;
-  int m_resultIndex;
+  QList<UpdateSource> m_updateSources;
+  // for every result, the best match from each update source
+  QList<Data::EntryList> m_bestMatches;
+  // for every result, the number of update sources which have not finished with it
+  QList<int> m_pendingSources;
+  int m_emitIndex;
+  QTimer* m_timer;
 
   bool m_started;
+  bool m_searchingFirst;
+  bool m_stoppingSources;
 };
 
 class MultiFetcher::ConfigWidget : public Fetch::ConfigWidget {
@@ -40,10 +40,13 @@ Tellico data source setup:
 - Arguments:
 Title (checked) = %1
 Update (checked) = %{title}
+
+With the --persistent argument, the script keeps running and reads one search per line
+on stdin, so Tellico only has to start it once.
 """
 
 import sys, os, re, hashlib, random, string
-import urllib, time, base64
+import urllib, time, base64, io
 import xml.dom.minidom
 from urllib.request import urlopen
 
@@ -476,7 +479,36 @@ def showUsage():
 	print("Usage: %s comic" % sys.argv[0])
 	sys.exit(1)
 
+def unescape(arg):
+	return re.sub(r'\\(.)', lambda m: {'t': '\t', 'n': '\n'}.get(m.group(1), m.group(1)), arg)
+
+def serve():
+	"""
+	Each request is a line with an id followed by tab-separated arguments. Each response
+	is a line with the id and the length in bytes of the result, followed by the result.
+	"""
+	stdout = sys.stdout
+	for line in sys.stdin:
+		fields = line.rstrip('\n').split('\t')
+		result = io.StringIO()
+		sys.stdout = result
+		try:
+			if len(fields) > 1:
+				DarkHorseParser().run(unescape(fields[1]))
+		except Exception as e:
+			print("Error: %s" % e, file=sys.stderr)
+		finally:
+			sys.stdout = stdout
+		data = result.getvalue().encode('utf-8')
+		stdout.buffer.write(("%s %d\n" % (fields[0], len(data))).encode('ascii'))
+		stdout.buffer.write(data)
+		stdout.buffer.flush()
+
 def main():
+	if len(sys.argv) > 1 and sys.argv[1] == '--persistent':
+		serve()
+		return
+
 	if len(sys.argv) < 2:
 		showUsage()
 
@@ -40,5 +40,6 @@ Name[tr]=Kara At Karikatürleri
 Name[uk]=Комікси Темного Коня
 Name[zh_CN]=Drak Horse 连环画
 Type=data-source
+PersistentArgs=--persistent
 UpdateArgs=%{title}
 Uuid={cdc5de8e-73e5-4914-b528-589f74ee8265}
@@ -36,6 +36,9 @@
 
 #include <QFile>
 #include <QApplication>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QMultiHash>
 
 #ifdef HAVE_YAZ
 extern "C" {
@@ -76,6 +79,106 @@ namespace {
     yaz_iconv_t iconv;
     yaz_marc_t marc;
   };
+
+  // servers tend to drop idle connections after a few minutes anyway
+  static const qint64 Z3950_POOL_IDLE_TIMEOUT = 3 * 60 * 1000;
+  static const int Z3950_POOL_MAX_IDLE = 8;
+
+  // idle connections, shared between every search thread
+  class ConnectionPool {
+  public:
+    ConnectionPool() : m_maxIdle(Z3950_POOL_MAX_IDLE), m_idleTimeout(Z3950_POOL_IDLE_TIMEOUT) {}
+    ~ConnectionPool() {
+      for(auto it = m_idle.constBegin(); it != m_idle.constEnd(); ++it) {
+        destroy(it.value());
+      }
+    }
+
+    bool take(const QByteArray& key_, ZOOM_options* options_, ZOOM_connection* conn_) {
+      QMutexLocker locker(&m_mutex);
+      expire();
+      auto it = m_idle.find(key_);
+      if(it == m_idle.end()) {
+        return false;
+      }
+      *options_ = it.value().options;
+      *conn_ = it.value().conn;
+      m_idle.erase(it);
+      return true;
+    }
+
+    void put(const QByteArray& key_, ZOOM_options options_, ZOOM_connection conn_) {
+      QMutexLocker locker(&m_mutex);
+      expire();
+      Idle entry;
+      entry.options = options_;
+      entry.conn = conn_;
+      if(m_maxIdle < 1) {
+        destroy(entry);
+        return;
+      }
+      trim(m_maxIdle - 1);
+      entry.idle.start();
+      m_idle.insert(key_, entry);
+    }
+
+    int count() {
+      QMutexLocker locker(&m_mutex);
+      return m_idle.size();
+    }
+
+    void setLimits(int maxIdle_, qint64 idleTimeout_) {
+      QMutexLocker locker(&m_mutex);
+      m_maxIdle = maxIdle_ < 0 ? Z3950_POOL_MAX_IDLE : maxIdle_;
+      m_idleTimeout = idleTimeout_ < 0 ? Z3950_POOL_IDLE_TIMEOUT : idleTimeout_;
+      expire();
+      trim(m_maxIdle);
+    }
+
+  private:
+    struct Idle {
+      ZOOM_options options;
+      ZOOM_connection conn;
+      QElapsedTimer idle;
+    };
+
+    static void destroy(const Idle& entry_) {
+      ZOOM_options_destroy(entry_.options);
+      ZOOM_connection_destroy(entry_.conn);
+    }
+
+    void expire() {
+      for(auto it = m_idle.begin(); it != m_idle.end(); ) {
+        if(it.value().idle.hasExpired(m_idleTimeout)) {
+          destroy(it.value());
+          it = m_idle.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+
+    // drops the connections which have been idle the longest
+    void trim(int maxCount_) {
+      while(!m_idle.isEmpty() && m_idle.size() > maxCount_) {
+        auto oldest = m_idle.begin();
+        for(auto it = m_idle.begin(); it != m_idle.end(); ++it) {
+          if(it.value().idle.elapsed() > oldest.value().idle.elapsed()) {
+            oldest = it;
+          }
+        }
+        destroy(oldest.value());
+        m_idle.erase(oldest);
+      }
+    }
+
+    int m_maxIdle;
+    qint64 m_idleTimeout;
+    QMutex m_mutex;
+    QMultiHash<QByteArray, Idle> m_idle;
+  };
+
+  Q_GLOBAL_STATIC(ConnectionPool, s_connectionPool)
 #endif
 }
 
@@ -95,7 +198,7 @@ Z3950ResultFound::~Z3950ResultFound() {
 class Z3950Connection::Private {
 public:
 #ifdef HAVE_YAZ
-  Private() : conn_opt(nullptr), conn(nullptr) {}
+  Private() : conn_opt(nullptr), conn(nullptr), pooled(false) {}
   ~Private() {
     ZOOM_options_destroy(conn_opt);
     ZOOM_connection_destroy(conn);
@@ -103,6 +206,8 @@ public:
 
   ZOOM_options conn_opt;
   ZOOM_connection conn;
+  // true if the connection came from the pool, rather than being newly made
+  bool pooled;
 #else
   Private() {}
 #endif
@@ -134,11 +239,29 @@ Z3950Connection::Z3950Connection(Fetch::Fetcher* fetcher,
 }
 
 Z3950Connection::~Z3950Connection() {
+  releaseConnection();
   m_connected = false;
   delete d;
   d = nullptr;
 }
 
+int Z3950Connection::idleConnectionCount() {
+#ifdef HAVE_YAZ
+  return s_connectionPool->count();
+#else
+  return 0;
+#endif
+}
+
+void Z3950Connection::setPoolLimits(int maxIdle_, qint64 idleTimeout_) {
+#ifdef HAVE_YAZ
+  s_connectionPool->setLimits(maxIdle_, idleTimeout_);
+#else
+  Q_UNUSED(maxIdle_);
+  Q_UNUSED(idleTimeout_);
+#endif
+}
+
 void Z3950Connection::reset() {
   m_start = 0;
   m_limit = Z3950_DEFAULT_MAX_RECORDS;
@@ -162,6 +285,12 @@ void Z3950Connection::setCharacterSet(const QString& queryCharSet_, const QStrin
 }
 
 void Z3950Connection::run() {
+  search();
+  // hand the connection back so any other search on the same server can use it
+  releaseConnection();
+}
+
+void Z3950Connection::search() {
   m_aborted = false;
   m_hasMore = false;
   resultsLeft = 0;
@@ -186,6 +315,20 @@ void Z3950Connection::run() {
   }
 
   ZOOM_resultset resultSet = ZOOM_connection_search(d->conn, query);
+  if(d->pooled) {
+    const int connError = ZOOM_connection_errcode(d->conn);
+    if(connError == ZOOM_ERROR_CONNECTION_LOST || connError == ZOOM_ERROR_CONNECT) {
+      // the server closed the connection while it sat in the pool, so try once more with a new one
+      myLog() << "reconnecting to" << m_host;
+      ZOOM_resultset_destroy(resultSet);
+      closeConnection();
+      if(!makeConnection(false /* allowPooled */)) {
+        done();
+        return;
+      }
+      resultSet = ZOOM_connection_search(d->conn, query);
+    }
+  }
   ResultDestroyer rd(resultSet);
 
   // check abort status
@@ -217,7 +360,7 @@ void Z3950Connection::run() {
   const char* addinfo;
   errcode = ZOOM_connection_error(d->conn, &errmsg, &addinfo);
   if(errcode != 0) {
-    m_connected = false;
+    closeConnection();
 
     QString s = i18n("Connection search error %1: %2", errcode, responseToString(errmsg));
     if(!QByteArray(addinfo).isEmpty()) {
@@ -394,12 +537,18 @@ void Z3950Connection::run() {
   done();
 }
 
-bool Z3950Connection::makeConnection() {
+bool Z3950Connection::makeConnection(bool allowPooled_) {
   if(m_connected) {
     return true;
   }
 // I don't know what to do except assume database, user, and password are in locale encoding
 #ifdef HAVE_YAZ
+  if(allowPooled_ && s_connectionPool->take(poolKey(), &d->conn_opt, &d->conn)) {
+    d->pooled = true;
+    m_connected = true;
+    return true;
+  }
+  d->pooled = false;
   d->conn_opt = ZOOM_options_create();
   ZOOM_options_set(d->conn_opt, "implementationName", "Tellico");
   QByteArray ba = queryToByteArray(m_dbname);
@@ -417,9 +566,7 @@ bool Z3950Connection::makeConnection() {
   const char* addinfo;
   errcode = ZOOM_connection_error(d->conn, &errmsg, &addinfo);
   if(errcode != 0) {
-    ZOOM_options_destroy(d->conn_opt);
-    ZOOM_connection_destroy(d->conn);
-    m_connected = false;
+    closeConnection();
 
     QString s = i18n("Connection error %1: %2", errcode, responseToString(errmsg));
     if(!QByteArray(addinfo).isEmpty()) {
@@ -436,6 +583,38 @@ bool Z3950Connection::makeConnection() {
   return true;
 }
 
+void Z3950Connection::releaseConnection() {
+#ifdef HAVE_YAZ
+  if(!m_connected || !d->conn) {
+    return;
+  }
+  s_connectionPool->put(poolKey(), d->conn_opt, d->conn);
+  d->conn_opt = nullptr;
+  d->conn = nullptr;
+#endif
+  m_connected = false;
+}
+
+void Z3950Connection::closeConnection() {
+#ifdef HAVE_YAZ
+  ZOOM_options_destroy(d->conn_opt);
+  ZOOM_connection_destroy(d->conn);
+  d->conn_opt = nullptr;
+  d->conn = nullptr;
+#endif
+  m_connected = false;
+}
+
+QByteArray Z3950Connection::poolKey() const {
+  // the database name and the credentials are set when connecting, so they're part of the key
+  QByteArray key = m_host.toUtf8();
+  key += ':' + QByteArray::number(m_port);
+  key += '\0' + m_dbname.toUtf8();
+  key += '\0' + m_user.toUtf8();
+  key += '\0' + m_password.toUtf8();
+  return key;
+}
+
 void Z3950Connection::done() {
   checkPendingEvents();
   if(m_fetcher) {
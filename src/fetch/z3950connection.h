@@ -77,6 +77,10 @@ private:
 };
 
 /**
+ * Runs a single Z39.50 search on its own thread. Server connections are kept in a pool shared
+ * by all searches, keyed by host, database, and credentials, so that repeated searches on the
+ * same server do not have to connect again each time.
+ *
  * @author Robby Stephenson
  */
 class Z3950Connection : public QThread {
@@ -99,11 +103,28 @@ public:
 
   void abort() { m_aborted = true; }
 
+  /**
+   * Returns the number of idle connections in the pool.
+   */
+  static int idleConnectionCount();
+  /**
+   * Changes how many idle connections the pool keeps, and for how long. Connections over
+   * the new limits are closed right away. A negative value restores the default.
+   *
+   * @param maxIdle The most idle connections to keep
+   * @param idleTimeout How long to keep an idle connection, in milliseconds
+   */
+  static void setPoolLimits(int maxIdle, qint64 idleTimeout);
+
 private:
   static QByteArray iconvRun(const QByteArray& text, const QString& fromCharSet, const QString& toCharSet);
   static QString toXML(const QByteArray& marc, const QString& fromCharSet);
 
-  bool makeConnection();
+  void search();
+  bool makeConnection(bool allowPooled = true);
+  void releaseConnection();
+  void closeConnection();
+  QByteArray poolKey() const;
   void done();
   void done(const QString& message, int type);
   QByteArray queryToByteArray(const QString& text);
@@ -28,6 +28,7 @@
 #include "fetch/fetchmanager.h"
 #include "fetch/fetcher.h"
 #include "fetch/fetchresult.h"
+#include "fetch/fetchresultcache.h"
 #include "config/tellico_config.h"
 #include "entryview.h"
 #include "utils/isbnvalidator.h"
@@ -135,6 +136,7 @@ FetchDialog::FetchDialog(QWidget* parent_)
     , m_timer(new QTimer(this))
     , m_started(false)
     , m_resultCount(0)
+    , m_resultCache(new Fetch::FetchResultCache())
     , m_treeWasResized(false)
     , m_canSearchMultiple(true)
     , m_barcodePreview(nullptr)
@@ -357,6 +359,8 @@ FetchDialog::~FetchDialog() {
 
   qDeleteAll(m_results);
   m_results.clear();
+  delete m_resultCache;
+  m_resultCache = nullptr;
 
   // we might have downloaded a lot of images we don't need to keep
   Data::EntryList entriesToCheck;
@@ -543,7 +547,7 @@ void FetchDialog::slotAddEntry() {
     FetchResultItem* item = static_cast<FetchResultItem*>(item_);
 
     Fetch::FetchResult* r = item->m_result;
-    Data::EntryPtr entry = m_entries.value(r->uid);
+    Data::EntryPtr entry = cachedEntry(r);
     if(!entry) {
       setStatus(i18n("Fetching %1...", r->title));
       startProgress();
@@ -552,6 +556,7 @@ void FetchDialog::slotAddEntry() {
         continue;
       }
       m_entries.insert(r->uid, entry);
+      m_resultCache->insert(Fetch::FetchResultCache::resultKey(r), entry);
       stopProgress();
       setStatus(i18n("Ready."));
     }
@@ -602,13 +607,14 @@ void FetchDialog::slotShowEntry() {
   FetchResultItem* item = static_cast<FetchResultItem*>(items.first());
   Fetch::FetchResult* r = item->m_result;
   setStatus(i18n("Fetching %1...", r->title));
-  Data::EntryPtr entry = m_entries.value(r->uid);
+  Data::EntryPtr entry = cachedEntry(r);
   if(!entry) {
     GUI::CursorSaver cs;
     startProgress();
     entry = r->fetchEntry();
     if(entry) { // might conceivably be null
       m_entries.insert(r->uid, entry);
+      m_resultCache->insert(Fetch::FetchResultCache::resultKey(r), entry);
     }
     stopProgress();
   }
@@ -633,6 +639,19 @@ void FetchDialog::slotShowEntry() {
   m_entryView->showEntry(entry);
 }
 
+Tellico::Data::EntryPtr FetchDialog::cachedEntry(Fetch::FetchResult* result_) {
+  Data::EntryPtr entry = m_entries.value(result_->uid);
+  if(entry) {
+    return entry;
+  }
+  // the same result might have been fetched in an earlier search, even in an earlier session
+  entry = m_resultCache->entry(Fetch::FetchResultCache::resultKey(result_));
+  if(entry) {
+    m_entries.insert(result_->uid, entry);
+  }
+  return entry;
+}
+
 void FetchDialog::startProgress() {
   m_progress->show();
   m_timer->start(100);
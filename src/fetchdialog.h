@@ -38,6 +38,7 @@ namespace Tellico {
   namespace Fetch {
     class Fetcher;
     class FetchResult;
+    class FetchResultCache;
   }
   namespace GUI {
     class ComboBox;
@@ -114,6 +115,7 @@ private:
   void startProgress();
   void stopProgress();
   void setStatus(const QString& text);
+  Data::EntryPtr cachedEntry(Fetch::FetchResult* result);
 
   void openBarcodePreview();
   void closeBarcodePreview();
@@ -145,6 +147,7 @@ private:
   QStringList m_statusMessages;
   QHash<int, Data::EntryPtr> m_entries;
   QList<Fetch::FetchResult*> m_results;
+  Fetch::FetchResultCache* m_resultCache;
   int m_collType;
   bool m_treeWasResized;
   bool m_canSearchMultiple;
@@ -36,7 +36,7 @@ using Tellico::Data::Field;
 // this constructor is for anything but Choice type
 Field::Field(const QString& name_, const QString& title_, Type type_/*=Line*/)
     : QSharedData(), m_name(Tellico::shareString(name_)), m_title(title_),  m_category(i18n("General")), m_desc(title_),
-      m_type(type_), m_flags(0), m_formatType(FieldFormat::FormatNone) {
+      m_type(type_), m_flags(0), m_formatType(FieldFormat::FormatNone), m_generation(nextGeneration()) {
 
   Q_ASSERT(m_type != Choice);
   // a paragraph's category is always its title, along with tables
@@ -77,14 +77,15 @@ Field::Field(const QString& name_, const QString& title_, Type type_/*=Line*/)
 // if this constructor is called, the type is necessarily Choice
 Field::Field(const QString& name_, const QString& title_, const QStringList& allowed_)
     : QSharedData(), m_name(Tellico::shareString(name_)), m_title(title_), m_category(i18n("General")), m_desc(title_),
-      m_type(Field::Choice), m_allowed(allowed_), m_flags(0), m_formatType(FieldFormat::FormatNone) {
+      m_type(Field::Choice), m_allowed(allowed_), m_flags(0), m_formatType(FieldFormat::FormatNone),
+      m_generation(nextGeneration()) {
 }
 
 Field::Field(const Field& field_)
     : QSharedData(field_), m_name(field_.name()), m_title(field_.title()), m_category(field_.category()),
       m_desc(field_.description()), m_type(field_.type()), m_allowed(field_.allowed()),
       m_flags(field_.flags()), m_formatType(field_.formatType()),
-      m_properties(field_.propertyList()) {
+      m_properties(field_.propertyList()), m_generation(nextGeneration()) {
 }
 
 Field& Field::operator=(const Field& field_) {
@@ -100,12 +101,14 @@ Field& Field::operator=(const Field& field_) {
   m_flags = field_.flags();
   m_formatType = field_.formatType();
   m_properties = field_.propertyList();
+  m_generation = nextGeneration();
   return *this;
 }
 
 Field::~Field() = default;
 
 void Field::setTitle(const QString& title_) {
+  m_generation = nextGeneration();
   m_title = title_;
   if(isSingleCategory()) {
     m_category = title_;
@@ -113,6 +116,7 @@ void Field::setTitle(const QString& title_) {
 }
 
 void Field::setType(Field::Type type_) {
+  m_generation = nextGeneration();
   m_type = type_;
   if(m_type != Field::Choice) {
     m_allowed = QStringList();
@@ -149,12 +153,14 @@ void Field::setType(Field::Type type_) {
 }
 
 void Field::setCategory(const QString& category_) {
+  m_generation = nextGeneration();
   if(!isSingleCategory()) {
     m_category = category_;
   }
 }
 
 void Field::setFlags(int flags_) {
+  m_generation = nextGeneration();
   // tables always have multiple allowed
   if(m_type == Table) {
     m_flags = AllowMultiple | flags_;
@@ -168,6 +174,7 @@ bool Field::hasFlag(FieldFlag flag_) const {
 }
 
 void Field::setFormatType(FieldFormat::Type type_) {
+  m_generation = nextGeneration();
   // Choice and Data fields are not allowed a format type
   if(m_type != Choice && m_type != Date) {
     m_formatType = type_;
@@ -228,10 +235,12 @@ void Field::addAllowed(const QString& value_) {
   }
   if(!m_allowed.contains(value_)) {
     m_allowed += value_;
+    m_generation = nextGeneration();
   }
 }
 
 void Field::setProperty(const QString& key_, const QString& value_) {
+  m_generation = nextGeneration();
   if(value_.isEmpty()) {
     m_properties.remove(key_);
   } else {
@@ -240,6 +249,7 @@ void Field::setProperty(const QString& key_, const QString& value_) {
 }
 
 void Field::setPropertyList(const Tellico::StringMap& props_) {
+  m_generation = nextGeneration();
   m_properties = props_;
 }
 
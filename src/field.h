@@ -27,6 +27,7 @@
 
 #include "datavectors.h"
 #include "fieldformat.h"
+#include "generation.h"
 
 #include <QStringList>
 
@@ -157,7 +158,7 @@ public:
    *
    * @param name The field name
    */
-  void setName(const QString& name) { m_name = name; }
+  void setName(const QString& name) { m_name = name; m_generation = nextGeneration(); }
   /**
    * Returns the title of the field.
    *
@@ -193,7 +194,7 @@ public:
    *
    * @param allowed The allowed values
    */
-  void setAllowed(const QStringList& allowed) { m_allowed = allowed; }
+  void setAllowed(const QStringList& allowed) { m_allowed = allowed; m_generation = nextGeneration(); }
   /**
    * Add a value to the allowed list
    *
@@ -249,7 +250,7 @@ public:
    *
    * @param desc The field description
    */
-  void setDescription(const QString& desc) { m_desc = desc; }
+  void setDescription(const QString& desc) { m_desc = desc; m_generation = nextGeneration(); }
   /**
    * Returns the default value for the field.
    *
@@ -294,6 +295,13 @@ public:
    * @return The property list
    */
   const StringMap& propertyList() const { return m_properties; }
+  /**
+   * Returns the generation of the last change to the field. Fields are sometimes
+   * modified in place, so this may be later than the collection's own generation.
+   *
+   * @return The generation
+   */
+  Generation generation() const { return m_generation; }
 
   /*************************** STATIC **********************************/
   /**
@@ -336,6 +344,7 @@ private:
   int m_flags;
   FieldFormat::Type m_formatType;
   StringMap m_properties;
+  Generation m_generation;
 };
 
   } // end namespace
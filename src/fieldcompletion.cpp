@@ -24,12 +24,40 @@
 
 #include "fieldcompletion.h"
 #include "fieldformat.h"
+#include "collection.h"
 
 #include <KCompletionMatches>
 
 using Tellico::FieldCompletion;
 
-FieldCompletion::FieldCompletion(bool multiple_) : KCompletion(), m_multiple(multiple_) {
+FieldCompletion::FieldCompletion(bool multiple_) : KCompletion(), m_multiple(multiple_),
+    m_generation(0), m_loaded(false) {
+}
+
+void FieldCompletion::setFieldValues(Tellico::Data::CollPtr coll_, const QString& fieldName_) {
+  m_coll = coll_.data();
+  m_fieldName = fieldName_;
+  m_loaded = false;
+}
+
+void FieldCompletion::updateFieldValues() {
+  if(!m_coll) {
+    return;
+  }
+  const uint generation = m_coll->fieldValuesGeneration(m_fieldName);
+  if(m_loaded && generation == m_generation) {
+    return;
+  }
+  if(m_loaded) {
+    // some values may no longer be used
+    KCompletion::setItems(m_coll->valuesByFieldName(m_fieldName));
+  } else {
+    // keep any items which were added explicitly
+    KCompletion::insertItems(m_coll->valuesByFieldName(m_fieldName));
+  }
+  // the first call may have built the value dict
+  m_generation = m_coll->fieldValuesGeneration(m_fieldName);
+  m_loaded = true;
 }
 
 QString FieldCompletion::makeCompletion(const QString& string_) {
@@ -38,6 +66,8 @@ QString FieldCompletion::makeCompletion(const QString& string_) {
     return QString();
   }
 
+  updateFieldValues();
+
   if(!m_multiple) {
     return KCompletion::makeCompletion(string_);
   }
@@ -25,9 +25,16 @@
 #ifndef TELLICOFIELDCOMPLETION_H
 #define TELLICOFIELDCOMPLETION_H
 
+#include "datavectors.h"
+
 #include <KCompletion>
 
+#include <QPointer>
+
 namespace Tellico {
+  namespace Data {
+    class Collection;
+  }
 
 /**
  * @author Robby Stephenson
@@ -39,6 +46,12 @@ public:
   FieldCompletion(bool multiple);
 
   void setMultiple(bool m) { m_multiple = m; }
+  /**
+   * Use the values of a collection field as the completion items. The items are
+   * only read when a completion is first needed, and are read again whenever the
+   * collection's values for the field change.
+   */
+  void setFieldValues(Data::CollPtr coll, const QString& fieldName);
   virtual QString makeCompletion(const QString& string) override;
   virtual void clear() override;
 
@@ -48,8 +61,14 @@ protected:
   virtual void postProcessMatches(KCompletionMatches* matches) const override;
 
 private:
+  void updateFieldValues();
+
   bool m_multiple;
   QString m_beginText;
+  QPointer<Data::Collection> m_coll;
+  QString m_fieldName;
+  uint m_generation;
+  bool m_loaded;
 };
 
 } // end namespace
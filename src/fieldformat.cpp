@@ -25,8 +25,118 @@
 #include "fieldformat.h"
 #include "config/tellico_config.h"
 
+#include <QSet>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <memory>
+
 using Tellico::FieldFormat;
 
+namespace {
+
+// The formatting preferences compiled into lookup tables. A rule set is never modified
+// after it is built, a change in the preferences replaces it with a new one, so a group
+// dict being built on a worker thread can keep formatting with the rules it started with.
+// The rules are only built from the preferences on the GUI thread, which is the only thread
+// that writes them, and the worker threads never read the preferences themselves.
+class FormatRules {
+public:
+  FormatRules();
+
+  // returns the length of the article the title starts with, including the following space, or 0
+  int articleLength(const QString& title) const;
+
+  bool autoCapitalization;
+  bool autoFormat;
+  QStringList aposArticles;
+  QList<QRegularExpression> articleRxList;
+  // all of these are case-folded
+  QSet<QString> nameSuffixes;
+  QSet<QString> surnamePrefixes;
+  QSet<QString> noCapitalization;
+
+private:
+  // the articles, each followed by a space, indexed by first character in preference order
+  QHash<QChar, QStringList> m_articles;
+};
+
+QSet<QString> foldedSet(const QStringList& list_) {
+  QSet<QString> set;
+  set.reserve(list_.size());
+  foreach(const QString& value, list_) {
+    set.insert(value.toCaseFolded());
+  }
+  return set;
+}
+
+FormatRules::FormatRules()
+    : autoCapitalization(Tellico::Config::autoCapitalization())
+    , autoFormat(Tellico::Config::autoFormat()) {
+  static const QRegularExpression commaSplit(QStringLiteral("\\s*,\\s*"));
+  static const QRegularExpression commaSpaceSplit(QStringLiteral("\\s*[, ]\\s*"));
+
+  // the articles are already in lower-case
+  foreach(const QString& article, Tellico::Config::articlesString().split(commaSplit)) {
+    const QString spaced = article + QLatin1Char(' ');
+    m_articles[spaced.at(0)] += spaced;
+    if(article.endsWith(QLatin1Char('\''))) {
+      aposArticles += article;
+    }
+    articleRxList << QRegularExpression(QLatin1String("\\b") +
+                                        QRegularExpression::escape(article) +
+                                        QLatin1String("\\b"));
+  }
+  nameSuffixes = foldedSet(Tellico::Config::nameSuffixesString().split(commaSplit));
+  surnamePrefixes = foldedSet(Tellico::Config::surnamePrefixesString().split(commaSpaceSplit));
+  noCapitalization = foldedSet(Tellico::Config::noCapitalizationString().split(commaSplit));
+}
+
+int FormatRules::articleLength(const QString& title_) const {
+  if(title_.isEmpty()) {
+    return 0;
+  }
+  const auto it = m_articles.constFind(title_.at(0));
+  if(it == m_articles.constEnd()) {
+    return 0;
+  }
+  foreach(const QString& article, it.value()) {
+    if(title_.startsWith(article)) {
+      return article.length();
+    }
+  }
+  return 0;
+}
+
+// the lock is only held to copy or replace the pointer, never while formatting, and
+// std::atomic<std::shared_ptr> is not available with every standard library
+QMutex s_formatRulesMutex;
+std::shared_ptr<const FormatRules> s_formatRules;
+
+std::shared_ptr<const FormatRules> formatRules() {
+  QMutexLocker locker(&s_formatRulesMutex);
+  if(!s_formatRules) {
+    // only until the rules are first built on the GUI thread, before anything runs in the background
+    s_formatRules = std::make_shared<const FormatRules>();
+  }
+  return s_formatRules;
+}
+
+inline bool isRegExpSpace(QChar c) {
+  // the same characters as \s in a regular expression
+  return c == QLatin1Char(' ') || (c >= QLatin1Char('\t') && c <= QLatin1Char('\r'));
+}
+
+}
+
+void FieldFormat::updateFormatRules() {
+  // build the new rules before taking the lock, so formatting doesn't wait on reading the config
+  std::shared_ptr<const FormatRules> rules = std::make_shared<const FormatRules>();
+  QMutexLocker locker(&s_formatRulesMutex);
+  s_formatRules.swap(rules);
+}
+
 QString FieldFormat::delimiterString() {
   static QString ds(QStringLiteral("; "));
   return ds;
@@ -101,15 +211,14 @@ QStringList FieldFormat::splitTable(const QString& string_) {
 }
 
 QString FieldFormat::sortKeyTitle(const QString& title_) {
-  foreach(const QString& article, Config::articleList()) {
-    // assume white space is already stripped
-    // the articles are already in lower-case
-    if(title_.startsWith(article + QLatin1Char(' '))) {
-      return title_.mid(article.length() + 1);
-    }
+  const auto rules = formatRules();
+  // assume white space is already stripped
+  const int length = rules->articleLength(title_);
+  if(length > 0) {
+    return title_.mid(length);
   }
   // check apostrophes, too
-  foreach(const QString& article, Config::articleAposList()) {
+  foreach(const QString& article, rules->aposArticles) {
     if(title_.startsWith(article)) {
       return title_.mid(article.length());
     }
@@ -118,18 +227,8 @@ QString FieldFormat::sortKeyTitle(const QString& title_) {
 }
 
 void FieldFormat::stripArticles(QString& value) {
-  static QStringList oldArticleList;
-  static QList<QRegularExpression> rxList;
-  if(oldArticleList != Config::articleList()) {
-    oldArticleList = Config::articleList();
-    rxList.clear();
-    foreach(const QString& article, oldArticleList) {
-      rxList << QRegularExpression(QLatin1String("\\b") +
-                                   QRegularExpression::escape(article) +
-                                   QLatin1String("\\b"));
-    }
-  }
-  foreach(const QRegularExpression& rx, rxList) {
+  const auto rules = formatRules();
+  foreach(const QRegularExpression& rx, rules->articleRxList) {
     value.remove(rx);
   }
   value = value.trimmed();
@@ -143,11 +242,12 @@ QString FieldFormat::format(const QString& value_, Type type_, Request request_)
     return value_;
   }
 
+  const auto rules = formatRules();
   Options options;
-  if(request_ == ForceFormat || (request_ != AsIsFormat && Config::autoCapitalization())) {
+  if(request_ == ForceFormat || (request_ != AsIsFormat && rules->autoCapitalization)) {
     options |= FormatCapitalize;
   }
-  if(request_ == ForceFormat || (request_ != AsIsFormat && Config::autoFormat())) {
+  if(request_ == ForceFormat || (request_ != AsIsFormat && rules->autoFormat)) {
     options |= FormatAuto;
   }
 
@@ -193,21 +293,19 @@ QString FieldFormat::title(const QString& title_, Options opt_) {
   }
 
   if(opt_.testFlag(FormatAuto)) {
-    const QString lower = newTitle.toLower();
     // TODO if the title has ",the" at the end, put it at the front
-    foreach(const QString& article, Config::articleList()) {
-      // assume white space is already stripped
-      // the articles are already in lower-case
-      if(lower.startsWith(article + QLatin1Char(' '))) {
-        QRegularExpression rx(QLatin1Char('^') + QRegularExpression::escape(article) + QLatin1String("\\s*"),
-                              QRegularExpression::CaseInsensitiveOption);
-        // can't just use article since it's in lower-case
-        QString titleArticle = newTitle.left(article.length());
-        newTitle = newTitle.remove(rx)
-                           .append(QLatin1String(", "))
-                           .append(titleArticle);
-        break;
+    // the length of the article includes the space which follows it
+    const int length = formatRules()->articleLength(newTitle.toLower()) - 1;
+    if(length > -1) {
+      // can't just use article since it's in lower-case
+      const QString titleArticle = newTitle.left(length);
+      int pos = length;
+      while(pos < newTitle.length() && isRegExpSpace(newTitle.at(pos))) {
+        ++pos;
       }
+      newTitle = newTitle.mid(pos)
+                         .append(QLatin1String(", "))
+                         .append(titleArticle);
     }
   }
 
@@ -219,6 +317,7 @@ QString FieldFormat::name(const QString& name_, Options opt_) {
   // the ending look-ahead is so that a space is not added at the end
   static const QRegularExpression periodSpace(QStringLiteral("\\.\\s*(?=.)"));
 
+  const auto rules = formatRules();
   QString name = name_;
   name.replace(periodSpace, QStringLiteral(". "));
   if(opt_.testFlag(FormatCapitalize)) {
@@ -234,7 +333,7 @@ QString FieldFormat::name(const QString& name_, Options opt_) {
 
   // if it contains a comma already and the last word is not a suffix, don't format it
   if(!opt_.testFlag(FormatAuto) ||
-      (name.indexOf(QLatin1Char(',')) > -1 && !Config::nameSuffixList().contains(words.last(), Qt::CaseInsensitive))) {
+      (name.indexOf(QLatin1Char(',')) > -1 && !rules->nameSuffixes.contains(words.last().toCaseFolded()))) {
     // arbitrarily impose rule that no spaces before a comma and
     // a single space after every comma
     name.replace(commaSplitRegularExpression(), QStringLiteral(", "));
@@ -243,7 +342,7 @@ QString FieldFormat::name(const QString& name_, Options opt_) {
     // but only if there is more than one word
 
     // if the last word is a suffix, it has to be kept with last name
-    if(Config::nameSuffixList().contains(words.last(), Qt::CaseInsensitive)) {
+    if(rules->nameSuffixes.contains(words.last().toCaseFolded())) {
       words.prepend(words.last().append(QLatin1Char(',')));
       words.removeLast();
     }
@@ -257,7 +356,7 @@ QString FieldFormat::name(const QString& name_, Options opt_) {
     // In a previous version of Tellico, using a prefix such as "van der" (with a space) would work
     // because QStringList::contains did substring matching, but now need to add a function for tokenizing
     // the list with whitespace as well as comma
-    while(Config::surnamePrefixTokens().contains(words.last(), Qt::CaseInsensitive)) {
+    while(rules->surnamePrefixes.contains(words.last().toCaseFolded())) {
       words.prepend(words.last());
       words.removeLast();
     }
@@ -304,6 +403,7 @@ QString FieldFormat::capitalize(QString str_) {
     return str_;
   }
 
+  const auto rules = formatRules();
   // first letter is always capitalized
   str_.replace(0, 1, str_.at(0).toUpper());
 
@@ -317,7 +417,7 @@ QString FieldFormat::capitalize(QString str_) {
 
   QString word = str_.mid(0, pos);
   // now check to see if words starts with apostrophe list
-  foreach(const QString& aposArticle, Config::articleAposList()) {
+  foreach(const QString& aposArticle, rules->aposArticles) {
     if(word.startsWith(aposArticle, Qt::CaseInsensitive)) {
       const uint l = aposArticle.length();
       str_.replace(l, 1, str_.at(l).toUpper());
@@ -335,7 +435,7 @@ QString FieldFormat::capitalize(QString str_) {
     word = str_.mid(pos+1, nextPos-pos-1);
     bool aposMatch = false;
     // now check to see if words starts with apostrophe list
-    foreach(const QString& aposArticle, Config::articleAposList()) {
+    foreach(const QString& aposArticle, rules->aposArticles) {
       if(word.startsWith(aposArticle, Qt::CaseInsensitive)) {
         const uint l = aposArticle.length();
         // if the word is not the end of the string, capitalize the letter after it
@@ -350,10 +450,11 @@ QString FieldFormat::capitalize(QString str_) {
     if(!aposMatch) {
       // check against the noCapitalization list AND the surnamePrefix list
       // does this hold true everywhere other than english?
-      if(!Config::noCapitalizationList().contains(word, Qt::CaseInsensitive) &&
-         !Config::surnamePrefixTokens().contains(word, Qt::CaseInsensitive) &&
-         nextPos-pos > 1) {
-        str_.replace(pos+1, 1, str_.at(pos+1).toUpper());
+      if(nextPos-pos > 1) {
+        const QString foldedWord = word.toCaseFolded();
+        if(!rules->noCapitalization.contains(foldedWord) && !rules->surnamePrefixes.contains(foldedWord)) {
+          str_.replace(pos+1, 1, str_.at(pos+1).toUpper());
+        }
       }
     }
 
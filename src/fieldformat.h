@@ -95,6 +95,12 @@ public:
   static QString sortKeyTitle(const QString& title);
 
   static void stripArticles(QString& value);
+  /**
+   * Builds the formatting rules again from the current preferences. The rules are shared
+   * with the worker threads, which never read the preferences, so this must be called
+   * on the GUI thread whenever the formatting preferences change.
+   */
+  static void updateFormatRules();
 
   static QString format(const QString& value, Type type, Request req);
 
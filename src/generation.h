@@ -0,0 +1,64 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TELLICO_DATA_GENERATION_H
+#define TELLICO_DATA_GENERATION_H
+
+#include <QAtomicInteger>
+
+namespace Tellico {
+  namespace Data {
+
+/**
+ * Collections, fields and entries are stamped with a generation whenever they change.
+ * All the stamps come from one clock, and each is larger than any before it, so a cache
+ * only has to remember the generation it was built at to tell whether something it
+ * depends on has changed since.
+ */
+typedef quint64 Generation;
+
+inline QAtomicInteger<quint64>& generationClock() {
+  static QAtomicInteger<quint64> clock(0);
+  return clock;
+}
+
+/**
+ * Returns a new generation, larger than all the earlier ones.
+ */
+inline Generation nextGeneration() {
+  return generationClock().fetchAndAddRelaxed(1) + 1;
+}
+
+/**
+ * Returns the latest generation, without advancing the clock. A cache built now
+ * is current as long as none of its sources have a later generation.
+ */
+inline Generation currentGeneration() {
+  return generationClock().loadRelaxed();
+}
+
+  } // end namespace
+} // end namespace
+
+#endif
@@ -128,9 +128,13 @@ void GroupView::populateCollection() {
     return;
   }
 
-  Data::EntryGroupDict* dict = m_coll->entryGroupDictByName(m_groupBy);
-  if(!dict) { // could happen if m_groupBy is non empty, but there are no entries with a value
+  // large collections are grouped in the background, and the remaining groups
+  // get added as they come in through slotModifyGroups()
+  Data::EntryGroupDict* dict = m_coll->entryGroupDictInBackground(m_groupBy);
+  if(!dict || dict->isEmpty()) { // could happen if m_groupBy is non empty, but there are no entries with a value
     setUpdatesEnabled(true);
+    // sort now so the groups still to come get sorted as they're added
+    model()->sort(0, sortOrder());
     return;
   }
 
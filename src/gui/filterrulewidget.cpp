@@ -116,7 +116,7 @@ void FilterRuleWidget::slotRuleFieldChanged(int which_) {
   Data::FieldPtr field = Data::Document::self()->collection()->fieldByTitle(fieldTitle);
   if(field && field->hasFlag(Data::Field::AllowCompletion)) {
     FieldCompletion* completion = new FieldCompletion(field->hasFlag(Data::Field::AllowMultiple));
-    completion->setItems(Data::Document::self()->collection()->valuesByFieldName(field->name()));
+    completion->setFieldValues(Data::Document::self()->collection(), field->name());
     completion->setIgnoreCase(true);
     m_ruleValue->setCompletionObject(completion);
     m_ruleValue->setAutoDeleteCompletionObject(true);
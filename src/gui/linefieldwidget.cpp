@@ -104,7 +104,7 @@ QWidget* LineFieldWidget::widget() {
 void LineFieldWidget::createCompletionObject(const QString& fieldName_) {
   Q_ASSERT(m_lineEdit);
   FieldCompletion* completion = new FieldCompletion(true);
-  completion->setItems(Data::Document::self()->collection()->valuesByFieldName(fieldName_));
+  completion->setFieldValues(Data::Document::self()->collection(), fieldName_);
   completion->setIgnoreCase(true);
   m_lineEdit->setCompletionObject(completion);
   m_lineEdit->setAutoDeleteCompletionObject(true);
@@ -131,6 +131,13 @@ Tellico::Data::Image* ImageDirectory::imageById(const QString& id_) {
 }
 
 bool ImageDirectory::writeImage(const Data::Image& img_) {
+  createDirectory();
+  QUrl target = dir();
+  target.setPath(target.path() + img_.id());
+  return FileHandler::writeDataURL(target, img_.byteArray(), true /* force */);
+}
+
+bool ImageDirectory::createDirectory() {
   if(dir().isEmpty()) {
     // an empty directory means the data file itself hasn't been saved yet
     if(!m_tempDir) {
@@ -138,13 +145,12 @@ bool ImageDirectory::writeImage(const Data::Image& img_) {
     }
     // It's a directory, so be sure to end with a slash
     ImageDirectory::setDirectory(QUrl::fromLocalFile(m_tempDir->path() + QLatin1Char('/')));
-    return writeImage(img_);
   }
 
-  QUrl target = dir();
   if(!m_pathExists) {
+    QUrl target = dir();
     if(m_isLocal) {
-      const QString localPath = dir().toLocalFile();
+      const QString localPath = target.toLocalFile();
       Q_ASSERT(!localPath.isEmpty());
       QDir dir;
       if(dir.mkdir(localPath)) {
@@ -165,8 +171,7 @@ bool ImageDirectory::writeImage(const Data::Image& img_) {
       }
     }
   }
-  target.setPath(target.path() + img_.id());
-  return FileHandler::writeDataURL(target, img_.byteArray(), true /* force */);
+  return m_pathExists;
 }
 
 bool ImageDirectory::removeImage(const QString& id_) {
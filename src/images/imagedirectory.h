@@ -66,6 +66,10 @@ public:
   bool hasImage(const QString& id) override;
   Data::Image* imageById(const QString& id) override;
   bool writeImage(const Data::Image& image);
+  /**
+   * Creates the directory if it does not exist yet, returning true if it exists afterwards
+   */
+  bool createDirectory();
   bool removeImage(const QString& id);
 
 private:
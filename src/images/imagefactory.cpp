@@ -40,6 +40,10 @@
 #include <QDir>
 #include <QTimer>
 #include <QImageReader>
+#include <QSaveFile>
+#include <QThread>
+#include <QFutureWatcher>
+#include <QtConcurrentRun>
 
 using namespace Tellico;
 using Tellico::ImageFactory;
@@ -51,10 +55,28 @@ Tellico::StringSet ImageFactory::s_imagesToRelease;
 
 Tellico::ImageFactory* ImageFactory::factory = nullptr;
 
+namespace {
+  // limits for the number of image downloads running at the same time
+  static const int IMAGE_REQUEST_HOST_LIMIT = 4;
+  static const int IMAGE_REQUEST_TOTAL_LIMIT = 12;
+
+  // the same url might get requested as a link and not as a link, which results in different images
+  inline QString requestKey(const QUrl& url, bool linkOnly) {
+    return linkOnly ? QLatin1String("link:") + url.url() : url.url();
+  }
+}
+
 class ImageFactory::Private {
 public:
   Private() = default;
 
+  struct ImageRequest {
+    QUrl url;
+    QUrl referrer;
+    bool quiet;
+    bool linkOnly;
+  };
+
   QHash<QString, Data::Image*> imageDict;
   QCache<QString, Data::Image> imageCache;
   QCache<QString, QPixmap> pixmapCache;
@@ -64,6 +86,14 @@ public:
   ImageZipArchive imageZipArchive;
   StringSet nullImages;
   QTimer releaseImagesTimer;
+
+  // the asynchronous image requests waiting for a download slot, by host
+  QHash<QString, QList<ImageRequest>> queuedRequests;
+  // number of running image jobs, by host
+  QHash<QString, int> runningRequests;
+  int runningRequestCount = 0;
+  // every request which is either queued or running, so duplicates are ignored
+  StringSet pendingRequests;
 };
 
 inline
@@ -291,46 +321,62 @@ const Tellico::Data::Image& ImageFactory::addCachedImageImpl(const QString& id_,
   return *img;
 }
 
+QStringList ImageFactory::addImages(const QList<ImageData>& images_) {
+  Q_ASSERT_X(factory, "ImageFactory::addImages", "ImageFactory is not initialized!");
+  QStringList ids;
+  if(images_.isEmpty()) {
+    return ids;
+  }
+  // the list of output formats is lazily initialized, do it here rather than in a worker thread
+  Data::Image::outputFormat("PNG");
+
+  QList<QFuture<Data::Image*>> futures;
+  for(const auto& image : images_) {
+    if(!image.id.isEmpty() &&
+       (factory->d->imageCache.contains(image.id) || factory->d->imageDict.contains(image.id))) {
+      myLog() << "already exists: " << image.id;
+      ids << image.id;
+      continue;
+    }
+    futures << QtConcurrent::run([](const ImageData& data) {
+      return new Data::Image(data.data, data.format, data.id);
+    }, image);
+  }
+
+  // no events get processed while waiting, so nothing else can touch the image dict in the meantime
+  for(auto& future : futures) {
+    Data::Image* img = future.result();
+    if(img->isNull()) {
+      myDebug() << "NULL IMAGE!!!!!";
+      delete img;
+      continue;
+    }
+    // the same image might be in the batch twice
+    if(factory->d->imageCache.contains(img->id()) || factory->d->imageDict.contains(img->id())) {
+      myLog() << "already exists: " << img->id();
+      ids << img->id();
+      delete img;
+      continue;
+    }
+    myLog() << "Loading image from data:" << img->id();
+    factory->d->imageDict.insert(img->id(), img);
+    s_imageInfoMap.insert(img->id(), Data::ImageInfo(*img));
+    ids << img->id();
+  }
+  return ids;
+}
+
 bool ImageFactory::writeCachedImage(const QString& id_, CacheDir dir_, bool force_ /*=false*/) {
   if(id_.isEmpty()) {
     return false;
   }
 //  myLog() << "dir =" << (dir_ == DataDir ? "DataDir" : "TmpDir" ) << "; id =" << id_;
-  ImageDirectory* imgDir = nullptr;
-  switch(dir_) {
-    case DataDir:
-      imgDir = &factory->d->dataImageDir;
-      break;
-    case TempDir:
-      imgDir = &factory->d->tempImageDir;
-      break;
-    case LocalDir:
-      // special case when configured to use local dir but for a new collection when no local dir exists
-      imgDir = factory->d->localImageDir.dir().isEmpty() ?
-                 &factory->d->tempImageDir :
-                 &factory->d->localImageDir;
-      break;
-    case ZipArchive:
-      myDebug() << "writeCachedImage() - ZipArchive - should never be called";
-      imgDir = &factory->d->tempImageDir;
-      break;
-  }
-
+  ImageDirectory* imgDir = factory->imageDirectory(dir_);
   Q_ASSERT(imgDir);
   bool success = writeCachedImage(id_, imgDir, force_);
 
   if(success) {
-    // remove from dict and add to cache
-    // it might not be in dict though
-    if(factory->d->imageDict.contains(id_)) {
-      Data::Image* img = factory->d->imageDict.take(id_);
-      Q_ASSERT(img);
-      // imageCache.insert will delete the image by itself if the cost exceeds the cache size
-      if(tryCacheInsert(img, factory->d->imageCache)) {
-        s_imageInfoMap.remove(id_);
-        s_imagesToRelease.add(id_);
-      }
-    }
+    factory->cacheWrittenImage(id_);
   }
   return success;
 }
@@ -352,6 +398,228 @@ bool ImageFactory::writeCachedImage(const QString& id_, ImageDirectory* imgDir_,
   return success;
 }
 
+// reads each image on the GUI thread, since the image dict and cache are not thread-safe, and encodes
+// and writes it in the thread pool, with a limited number of images held in memory
+class ImageFactory::WriteJob : public QObject {
+public:
+  WriteJob(ImageFactory* factory, const QStringList& ids, ImageDirectory* imgDir, bool cacheWritten,
+           const std::function<bool(int)>& progress)
+    : QObject(), m_factory(factory), m_ids(ids), m_imgDir(imgDir), m_cacheWritten(cacheWritten)
+    , m_progress(progress) {}
+
+  // waits on each write in turn, so no events get processed until it is done
+  QStringList exec() {
+    if(!useThreads()) {
+      writeAll();
+      return m_failed;
+    }
+    writeNext();
+    while(!m_running.isEmpty()) {
+      const Write write = m_running.takeFirst();
+      write.future.waitForFinished();
+      writeFinished(write);
+      writeNext();
+    }
+    return m_failed;
+  }
+
+  // each write is handled by a future watcher, and the job deletes itself when done
+  void start(const std::function<void(const QStringList&)>& finished) {
+    setParent(m_factory);
+    m_finished = finished;
+    m_background = true;
+    if(useThreads()) {
+      writeNext();
+    } else {
+      writeAll();
+    }
+    if(m_running.isEmpty()) {
+      QTimer::singleShot(0, this, [this]() { finish(); });
+    }
+  }
+
+private:
+  struct Write {
+    QString id;
+    QFuture<bool> future;
+    QFutureWatcher<bool>* watcher = nullptr;
+  };
+
+  static bool writeImage(const QString& fileName, const Data::Image& img, const QByteArray& format) {
+    QSaveFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly)) {
+      return false;
+    }
+    const QByteArray data = Data::Image::byteArray(img, format);
+    return !data.isEmpty() && file.write(data) == data.size() && file.commit();
+  }
+
+  bool useThreads() {
+    if(!m_imgDir || !m_imgDir->createDirectory() || !m_imgDir->dir().isLocalFile() ||
+       QThread::idealThreadCount() < 2) {
+      return false;
+    }
+    m_dirPath = m_imgDir->dir().toLocalFile();
+    return true;
+  }
+
+  // remote directories are written through KIO, one image at a time
+  void writeAll() {
+    while(!m_cancelled && m_next < m_ids.size()) {
+      const QString id = m_ids.at(m_next++);
+      imageDone(id, writeCachedImage(id, m_imgDir));
+    }
+  }
+
+  void writeNext() {
+    const int maxRunning = 2*QThread::idealThreadCount();
+    while(!m_cancelled && m_next < m_ids.size() && m_running.size() < maxRunning) {
+      const QString id = m_ids.at(m_next++);
+      if(id.isEmpty()) {
+        imageDone(id, false);
+        continue;
+      }
+      if(m_imgDir->hasImage(id)) {
+        // only write if it doesn't exist
+        imageDone(id, true);
+        continue;
+      }
+      // an image still in the zip archive gets read directly, since imageById() would go ahead
+      // and write it to the temporary directory first
+      const Data::Image& img = hasImageInZipArchive(id) ? m_factory->addCachedImageImpl(id, ZipArchive)
+                                                        : imageById(id);
+      if(img.isNull()) {
+        imageDone(id, false);
+        continue;
+      }
+      Write write;
+      write.id = id;
+      // the image reference might not survive the cache, so the worker gets a copy
+      write.future = QtConcurrent::run(&WriteJob::writeImage, m_dirPath + id, Data::Image(img),
+                                       Data::Image::outputFormat(img.format()));
+      if(m_background) {
+        write.watcher = new QFutureWatcher<bool>(this);
+        QFutureWatcher<bool>* watcher = write.watcher;
+        connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher]() {
+          watcherFinished(watcher);
+        });
+        watcher->setFuture(write.future);
+      }
+      m_running << write;
+    }
+  }
+
+  void watcherFinished(QFutureWatcher<bool>* watcher) {
+    for(int i = 0; i < m_running.size(); ++i) {
+      if(m_running.at(i).watcher == watcher) {
+        writeFinished(m_running.takeAt(i));
+        break;
+      }
+    }
+    watcher->deleteLater();
+    writeNext();
+    if(m_running.isEmpty()) {
+      finish();
+    }
+  }
+
+  void writeFinished(const Write& write) {
+    const bool success = write.future.result();
+    if(!success) {
+      myWarning() << "Failed to write image:" << m_dirPath + write.id;
+    }
+    imageDone(write.id, success);
+  }
+
+  void imageDone(const QString& id, bool success) {
+    if(!success) {
+      m_failed << id;
+    } else if(m_cacheWritten) {
+      m_factory->cacheWrittenImage(id);
+    }
+    ++m_done;
+    if(!m_cancelled && m_progress && !m_progress(m_done)) {
+      m_cancelled = true;
+    }
+  }
+
+  void finish() {
+    if(m_finished) {
+      m_finished(m_failed);
+    }
+    deleteLater();
+  }
+
+  ImageFactory* m_factory;
+  const QStringList m_ids;
+  ImageDirectory* m_imgDir;
+  const bool m_cacheWritten;
+  const std::function<bool(int)> m_progress;
+  std::function<void(const QStringList&)> m_finished;
+  QString m_dirPath;
+  QStringList m_failed;
+  QList<Write> m_running;
+  int m_next = 0;
+  int m_done = 0;
+  bool m_cancelled = false;
+  bool m_background = false;
+};
+
+QStringList ImageFactory::writeCachedImages(const QStringList& ids_, CacheDir dir_,
+                                            const std::function<bool(int)>& progress_) {
+  Q_ASSERT_X(factory, "ImageFactory::writeCachedImages", "ImageFactory is not initialized!");
+  WriteJob job(factory, ids_, factory->imageDirectory(dir_), true, progress_);
+  return job.exec();
+}
+
+QStringList ImageFactory::writeCachedImages(const QStringList& ids_, ImageDirectory* imgDir_,
+                                            const std::function<bool(int)>& progress_) {
+  Q_ASSERT_X(factory, "ImageFactory::writeCachedImages", "ImageFactory is not initialized!");
+  WriteJob job(factory, ids_, imgDir_, false, progress_);
+  return job.exec();
+}
+
+void ImageFactory::requestWriteCachedImages(const QStringList& ids_, CacheDir dir_,
+                                            const std::function<bool(int)>& progress_,
+                                            const std::function<void(const QStringList&)>& finished_) {
+  Q_ASSERT_X(factory, "ImageFactory::requestWriteCachedImages", "ImageFactory is not initialized!");
+  auto job = new WriteJob(factory, ids_, factory->imageDirectory(dir_), true, progress_);
+  job->start(finished_);
+}
+
+Tellico::ImageDirectory* ImageFactory::imageDirectory(CacheDir dir_) {
+  switch(dir_) {
+    case DataDir:
+      return &d->dataImageDir;
+    case TempDir:
+      return &d->tempImageDir;
+    case LocalDir:
+      // special case when configured to use local dir but for a new collection when no local dir exists
+      return d->localImageDir.dir().isEmpty() ? &d->tempImageDir : &d->localImageDir;
+    case ZipArchive:
+      myDebug() << "writeCachedImage() - ZipArchive - should never be called";
+      return &d->tempImageDir;
+  }
+  return &d->tempImageDir;
+}
+
+void ImageFactory::cacheWrittenImage(const QString& id_) {
+  // remove from dict and add to cache
+  // it might not be in dict though
+  if(d->imageDict.contains(id_)) {
+    Data::Image* img = d->imageDict.take(id_);
+    Q_ASSERT(img);
+    // imageCache.insert will delete the image by itself if the cost exceeds the cache size
+    if(tryCacheInsert(img, d->imageCache)) {
+      // the info gets read again from the image, except that a link-only image would lose the flag
+      if(!s_imageInfoMap.value(id_).linkOnly) {
+        s_imageInfoMap.remove(id_);
+      }
+      s_imagesToRelease.add(id_);
+    }
+  }
+}
+
 const Tellico::Data::Image& ImageFactory::imageById(const QString& id_) {
   Q_ASSERT_X(factory, "ImageFactory::imageById", "ImageFactory is not initialized!");
   if(id_.isEmpty() || !factory || factory->d->nullImages.contains(id_)) {
@@ -523,6 +791,14 @@ bool ImageFactory::hasImageInDirOrMemory(const QString& id_) {
   // Now they're treated identically to remote paths
 }
 
+bool ImageFactory::hasImageInZipArchive(const QString& id_) {
+  Q_ASSERT_X(factory, "ImageFactory::hasImageInZipArchive", "ImageFactory is not initialized!");
+  if(id_.isEmpty() || !factory) {
+    return false;
+  }
+  return !factory->hasImageInMemory(id_) && factory->d->imageZipArchive.hasImage(id_);
+}
+
 void ImageFactory::requestImageById(const QString& id_) {
   Q_ASSERT_X(factory, "ImageFactory::requestImageById()", "ImageFactory is not initialized!");
   if(hasImageInDirOrMemory(id_)) {
@@ -571,11 +847,45 @@ void ImageFactory::requestImageById(const QString& id_) {
 }
 
 void ImageFactory::requestImageByUrlImpl(const QUrl& url_, bool quiet_, const QUrl& refer_, bool link_) {
-  auto job = new ImageJob(url_, QString() /* id, use calculated one */, quiet_);
-  job->setLinkOnly(link_);
-  job->setReferrer(refer_);
-  connect(job, &ImageJob::result,
-          this, &ImageFactory::slotImageJobResult);
+  const QString key = requestKey(url_, link_);
+  if(d->pendingRequests.contains(key)) {
+    // imageRequestFinished will be emitted when the first request is done
+    return;
+  }
+  d->pendingRequests.add(key);
+  d->queuedRequests[url_.host()].append(Private::ImageRequest{url_, refer_, quiet_, link_});
+  startImageRequests();
+}
+
+void ImageFactory::startImageRequests() {
+  bool started = true;
+  while(started && d->runningRequestCount < IMAGE_REQUEST_TOTAL_LIMIT) {
+    // take one request from each host in turn, so a single slow server doesn't hold up the rest
+    started = false;
+    for(auto it = d->queuedRequests.begin(); it != d->queuedRequests.end(); ) {
+      if(it.value().isEmpty()) {
+        it = d->queuedRequests.erase(it);
+        continue;
+      }
+      if(d->runningRequestCount >= IMAGE_REQUEST_TOTAL_LIMIT) {
+        break;
+      }
+      int& running = d->runningRequests[it.key()];
+      if(running < IMAGE_REQUEST_HOST_LIMIT) {
+        // the most recent request is most likely for an entry that is visible right now
+        const Private::ImageRequest request = it.value().takeLast();
+        ++running;
+        ++d->runningRequestCount;
+        started = true;
+        auto job = new ImageJob(request.url, QString() /* id, use calculated one */, request.quiet);
+        job->setLinkOnly(request.linkOnly);
+        job->setReferrer(request.referrer);
+        connect(job, &ImageJob::result,
+                this, &ImageFactory::slotImageJobResult);
+      }
+      ++it;
+    }
+  }
 }
 
 Tellico::Data::ImageInfo ImageFactory::imageInfo(const QString& id_) {
@@ -776,6 +1086,15 @@ void ImageFactory::slotImageJobResult(KJob* job_) {
     myWarning() << "No image job";
     return;
   }
+  // free up the download slot for the next request
+  const QString host = imageJob->url().host();
+  if(--d->runningRequests[host] <= 0) {
+    d->runningRequests.remove(host);
+  }
+  --d->runningRequestCount;
+  d->pendingRequests.remove(requestKey(imageJob->url(), imageJob->linkOnly()));
+  startImageRequests();
+
   const Data::Image& img = imageJob->image();
   if(img.isNull()) {
     myDebug() << "Null image returned for" << imageJob->url().url(QUrl::PreferLocalFile);
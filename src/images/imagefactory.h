@@ -32,8 +32,10 @@
 #include <QColor>
 #include <QHash>
 #include <QPixmap>
+#include <QStringList>
 
 #include <memory>
+#include <functional>
 
 class KZip;
 class KJob;
@@ -109,8 +111,44 @@ public:
    */
   static QString addImage(const QByteArray& data, const QString& format, const QString& id=QString());
 
+  struct ImageData {
+    QByteArray data;
+    QString format;
+    QString id;
+  };
+  /**
+   * Add a batch of images from data, the same as calling addImage() for each one, except that
+   * the images are decoded by worker threads. Must be called from the GUI thread, which waits
+   * for the batch without processing any events.
+   *
+   * @param images The image data, format, and id for each image
+   * @return The ids of the images which were added
+   */
+  static QStringList addImages(const QList<ImageData>& images);
+
   static bool writeCachedImage(const QString& id, CacheDir dir, bool force = false);
   static bool writeCachedImage(const QString& id, ImageDirectory* dir, bool force = false);
+  /**
+   * Write a list of images, the same as calling writeCachedImage() for each one, except that
+   * the images are encoded and written to local directories by worker threads. The progress
+   * function is called from the GUI thread with the number of images done so far, and returning
+   * false from it cancels the remaining writes. The GUI thread waits for the writes without
+   * processing any events.
+   *
+   * @return The ids of the images which could not be written
+   */
+  static QStringList writeCachedImages(const QStringList& ids, CacheDir dir,
+                                       const std::function<bool(int)>& progress = {});
+  static QStringList writeCachedImages(const QStringList& ids, ImageDirectory* dir,
+                                       const std::function<bool(int)>& progress = {});
+  /**
+   * Write a list of images in the background, the same as writeCachedImages() except that it
+   * returns right away. The progress and finished functions are called from the event loop, and
+   * finished gets the ids of the images which could not be written.
+   */
+  static void requestWriteCachedImages(const QStringList& ids, CacheDir dir,
+                                       const std::function<bool(int)>& progress,
+                                       const std::function<void(const QStringList&)>& finished);
 
   /**
    * Returns an image reference given its id. If none is found, a null image
@@ -122,6 +160,10 @@ public:
   static const Data::Image& imageById(const QString& id);
   static bool hasImageInDir(const QString& id);
   static bool hasImageInDirOrMemory(const QString& id);
+  /**
+   * Returns true if the image is in the zip archive of the data file and has not been loaded yet
+   */
+  static bool hasImageInZipArchive(const QString& id);
   bool hasImageInMemory(const QString& id) const;
   // just used for testing
   bool hasNullImage(const QString& id) const;
@@ -184,6 +226,10 @@ private:
                                   const QUrl& referrer = QUrl(), bool linkOnly = false);
   void requestImageByUrlImpl(const QUrl& url, bool quiet=false,
                              const QUrl& referrer = QUrl(), bool linkOnly = false);
+  /**
+   * Starts as many of the queued image requests as the download limits allow.
+   */
+  void startImageRequests();
   /**
    * Add an image, reading it from a regular QImage, which is the case when dragging and dropping
    * an image in the @ref ImageWidget. The format has to be included, since the QImage doesn't
@@ -208,6 +254,14 @@ private:
 
   const Data::Image& addCachedImageImpl(const QString& id, CacheDir dir);
 
+  ImageDirectory* imageDirectory(CacheDir dir);
+  /**
+   * Moves a written image from the dict into the cache, since it can be reloaded from disk
+   */
+  void cacheWrittenImage(const QString& id);
+
+  class WriteJob;
+
   static ImageFactory* factory;
 
   static QHash<QString, Data::ImageInfo> s_imageInfoMap;
@@ -26,6 +26,7 @@
 #include "mainwindow.h"
 #include "tellico_kernel.h"
 #include "document.h"
+#include "documentjournal.h"
 #include "detailedlistview.h"
 #include "entryeditdialog.h"
 #include "groupview.h"
@@ -33,6 +34,7 @@
 #include "collection.h"
 #include "collectionfactory.h"
 #include "entry.h"
+#include "fieldformat.h"
 #include "configdialog.h"
 #include "filter.h"
 #include "filterparser.h"
@@ -787,6 +789,9 @@ void MainWindow::initDocument() {
 
   connect(Kernel::self()->commandHistory(), &QUndoStack::cleanChanged,
           doc, &Data::Document::slotSetClean);
+
+  // the journal sees every change the undo commands make
+  Controller::self()->addObserver(doc->journal());
 }
 
 void MainWindow::initView() {
@@ -817,6 +822,9 @@ void MainWindow::initView() {
                                     "for each entry.</qt>"));
   connect(Data::Document::self(), &Data::Document::signalCollectionImagesLoaded,
           m_detailedView, &DetailedListView::slotRefreshImages);
+  // the entry count is only final once a new collection has been completely added
+  connect(m_detailedView, &DetailedListView::signalEntriesLoaded,
+          this, &MainWindow::slotEntryCount);
 
   m_iconView = m_viewStack->iconView();
   EntryIconModel* iconModel = new EntryIconModel(m_iconView);
@@ -1136,6 +1144,7 @@ void MainWindow::readOptions() {
   m_groupView->setSorting(sortOrder, sortRole);
 
   BibtexHandler::s_quoteStyle = Config::useBraces() ? BibtexHandler::BRACES : BibtexHandler::QUOTES;
+  FieldFormat::updateFormatRules();
 
   // Don't read any options for the edit dialog here, since it's not yet initialized.
   // Put them in init()
@@ -1156,6 +1165,7 @@ bool MainWindow::querySaveModified() {
 
       case KMessageBox::ButtonCode::SecondaryAction:
         Data::Document::self()->setModified(false);
+        Data::Document::self()->journal()->discard();
         completed = true;
         break;
 
@@ -1174,6 +1184,8 @@ bool MainWindow::queryClose() {
   Data::Document::self()->cancelImageWriting();
   const bool willClose = m_editDialog->queryModified() && querySaveModified();
   if(willClose) {
+    // nothing is left unsaved, so there's nothing to recover later
+    Data::Document::self()->journal()->discard();
     ImageFactory::clean(true);
     saveOptions();
   }
@@ -1309,7 +1321,13 @@ bool MainWindow::openURL(const QUrl& url_) {
   bool success = Data::Document::self()->openDocument(url_);
 
   if(success) {
+    // changes recovered from the journal are not in the file
+    const bool recovered = Data::Document::self()->isModified();
     Kernel::self()->resetHistory();
+    if(recovered) {
+      // so undoing can never get back to the saved state
+      Kernel::self()->commandHistory()->resetClean();
+    }
     m_quickFilter->clear();
     slotEnableOpenedActions();
     m_newDocument = false;
@@ -1671,8 +1689,9 @@ void MainWindow::slotHandleConfigChange() {
     nocaps != Config::noCapitalizationList() ||
     suffixes != Config::nameSuffixList() ||
     prefixes != Config::surnamePrefixList()) {
-    // invalidate all groups
+    // invalidate all groups and format the values again with the new preferences
     Data::Document::self()->collection()->invalidateGroups();
+    Data::Document::self()->collection()->reformatEntries();
     // refreshing the title causes the group view to refresh
     Controller::self()->slotRefreshField(Data::Document::self()->collection()->fieldByName(QStringLiteral("title")));
   }
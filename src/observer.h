@@ -51,6 +51,7 @@ public:
   // coll, oldfield, newfield
   virtual void modifyField(Data::CollPtr, Data::FieldPtr, Data::FieldPtr) {}
   virtual void removeField(Data::CollPtr, Data::FieldPtr) {}
+  virtual void reorderFields(Data::CollPtr) {}
 
   virtual void    addFilter(FilterPtr) {}
   virtual void modifyFilter(FilterPtr) {}
@@ -0,0 +1,149 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "readonlycollection.h"
+#include "derivedvalue.h"
+
+using Tellico::Data::ReadOnlyCollection;
+
+class ReadOnlyCollection::Private {
+public:
+  Collection::Type type = Collection::Base;
+  QString title;
+  FieldList fields;
+  QHash<QString, FieldPtr> fieldByName;
+  QHash<QString, FieldPtr> fieldByTitle;
+  QList<ReadOnlyEntry> entries;
+  QHash<ID, qsizetype> entryIndex;
+  std::function<QString(const QString&)> prepareText;
+};
+
+ReadOnlyCollection::ReadOnlyCollection() : d(std::make_shared<const Private>()) {
+}
+
+ReadOnlyCollection::ReadOnlyCollection(const Tellico::Data::Collection* coll_) {
+  Q_ASSERT(coll_);
+  auto p = std::make_shared<Private>();
+  p->type = coll_->type();
+  p->title = coll_->title();
+  p->prepareText = coll_->textPreparer();
+
+  // fields are few and may be changed in place, so each one gets copied
+  p->fields.reserve(coll_->fields().count());
+  foreach(FieldPtr field, coll_->fields()) {
+    FieldPtr copy(new Field(*field));
+    p->fields.append(copy);
+    p->fieldByName.insert(copy->name(), copy);
+    p->fieldByTitle.insert(copy->title(), copy);
+  }
+
+  const EntryList& entries = coll_->entries();
+  p->entries.reserve(entries.count());
+  p->entryIndex.reserve(entries.count());
+  foreach(EntryPtr entry, entries) {
+    ReadOnlyEntry readOnlyEntry;
+    readOnlyEntry.m_id = entry->id();
+    // the value hash is implicitly shared, it only gets copied once the entry changes
+    readOnlyEntry.m_fieldValues = entry->m_fieldValues;
+    p->entryIndex.insert(readOnlyEntry.m_id, p->entries.count());
+    p->entries.append(readOnlyEntry);
+  }
+  d = p;
+}
+
+Tellico::Data::Collection::Type ReadOnlyCollection::type() const {
+  return d->type;
+}
+
+QString ReadOnlyCollection::title() const {
+  return d->title;
+}
+
+const Tellico::Data::FieldList& ReadOnlyCollection::fields() const {
+  return d->fields;
+}
+
+Tellico::Data::FieldPtr ReadOnlyCollection::fieldByName(const QString& name_) const {
+  return d->fieldByName.value(name_);
+}
+
+Tellico::Data::FieldPtr ReadOnlyCollection::fieldByTitle(const QString& title_) const {
+  return d->fieldByTitle.value(title_);
+}
+
+const QList<Tellico::Data::ReadOnlyEntry>& ReadOnlyCollection::entries() const {
+  return d->entries;
+}
+
+int ReadOnlyCollection::entryCount() const {
+  return d->entries.count();
+}
+
+Tellico::Data::ReadOnlyEntry ReadOnlyCollection::entryById(ID id_) const {
+  const qsizetype pos = d->entryIndex.value(id_, -1);
+  return pos > -1 ? d->entries.at(pos) : ReadOnlyEntry();
+}
+
+QString ReadOnlyCollection::field(const ReadOnlyEntry& entry_, FieldPtr field_) const {
+  if(!field_) {
+    return QString();
+  }
+
+  if(field_->hasFlag(Field::Derived)) {
+    DerivedValue dv(field_);
+    return dv.value(*this, entry_, false);
+  }
+
+  return entry_.field(field_->name());
+}
+
+QString ReadOnlyCollection::field(const ReadOnlyEntry& entry_, const QString& fieldName_) const {
+  return field(entry_, fieldByName(fieldName_));
+}
+
+QString ReadOnlyCollection::formattedField(const ReadOnlyEntry& entry_, FieldPtr field_,
+                                           FieldFormat::Request request_) const {
+  if(!field_) {
+    return QString();
+  }
+
+  // don't format the value unless it's requested to do so
+  if(request_ == FieldFormat::AsIsFormat) {
+    return field(entry_, field_);
+  }
+
+  const FieldFormat::Type flag = field_->formatType();
+  if(field_->hasFlag(Field::Derived)) {
+    DerivedValue dv(field_);
+    // format sub fields and whole string
+    return FieldFormat::format(dv.value(*this, entry_, true), flag, request_);
+  }
+
+  return Entry::formatValue(d->prepareText, field_, entry_.field(field_->name()), request_);
+}
+
+QString ReadOnlyCollection::formattedField(const ReadOnlyEntry& entry_, const QString& fieldName_,
+                                           FieldFormat::Request request_) const {
+  return formattedField(entry_, fieldByName(fieldName_), request_);
+}
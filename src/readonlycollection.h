@@ -0,0 +1,116 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TELLICO_DATA_READONLYCOLLECTION_H
+#define TELLICO_DATA_READONLYCOLLECTION_H
+
+#include "collection.h"
+
+#include <memory>
+
+namespace Tellico {
+  namespace Data {
+
+/**
+ * An entry in a @ref ReadOnlyCollection, holding the field values it had when the
+ * snapshot was taken.
+ */
+class ReadOnlyEntry {
+public:
+  ReadOnlyEntry() : m_id(-1) {}
+
+  ID id() const { return m_id; }
+  /**
+   * Returns the stored value of a field. Derived values are not stored, so use
+   * @ref ReadOnlyCollection::field for those.
+   *
+   * @param fieldName The name of the field
+   * @return The value
+   */
+  QString field(const QString& fieldName) const { return m_fieldValues.value(fieldName); }
+
+private:
+  friend class ReadOnlyCollection;
+
+  ID m_id;
+  QHash<QString, QString> m_fieldValues;
+};
+
+/**
+ * The ReadOnlyCollection class is a snapshot of the fields and entries of a @ref Collection,
+ * taken with @ref Collection::snapshot.
+ *
+ * Nothing in the snapshot changes once it is taken, so any number of threads may read it
+ * at the same time while the collection keeps being edited. Copies of the snapshot share
+ * the same data. Unlike @ref Entry, no formatted values are cached.
+ *
+ * @author Robby Stephenson
+ */
+class ReadOnlyCollection {
+public:
+  /**
+   * Creates an empty snapshot.
+   */
+  ReadOnlyCollection();
+  /**
+   * Takes a snapshot of a collection. This has to be done in the thread which
+   * modifies the collection, normally the main one.
+   */
+  explicit ReadOnlyCollection(const Collection* coll);
+
+  Collection::Type type() const;
+  QString title() const;
+  const FieldList& fields() const;
+  FieldPtr fieldByName(const QString& name) const;
+  FieldPtr fieldByTitle(const QString& title) const;
+  const QList<ReadOnlyEntry>& entries() const;
+  int entryCount() const;
+  /**
+   * Returns the entry with a certain id, or an entry with an id of -1 if there is none.
+   */
+  ReadOnlyEntry entryById(ID id) const;
+
+  /**
+   * Returns the value of a field for an entry, the same as @ref Entry::field,
+   * including the values of derived fields.
+   */
+  QString field(const ReadOnlyEntry& entry, FieldPtr field) const;
+  QString field(const ReadOnlyEntry& entry, const QString& fieldName) const;
+  /**
+   * Returns the formatted value of a field for an entry, the same as @ref Entry::formattedField.
+   */
+  QString formattedField(const ReadOnlyEntry& entry, FieldPtr field,
+                         FieldFormat::Request request = FieldFormat::DefaultFormat) const;
+  QString formattedField(const ReadOnlyEntry& entry, const QString& fieldName,
+                         FieldFormat::Request request = FieldFormat::DefaultFormat) const;
+
+private:
+  class Private;
+  std::shared_ptr<const Private> d;
+};
+
+  } // end namespace
+} // end namespace
+
+#endif
@@ -73,13 +73,15 @@ namespace {
   static const int INDEX_HTML = 0;
   static const int INDEX_CHART = 1;
   static const int ALL_ENTRIES = -1;
+  // the web view limit is 2 MB after percent encoding, etc., so give some padding
+  static const int REPORT_MAX_HTML_SIZE = 1200000;
 }
 
 using Tellico::ReportDialog;
 
 // default button is going to be used as a print button, so it's separated
 ReportDialog::ReportDialog(QWidget* parent_)
-    : QDialog(parent_), m_exporter(nullptr), m_tempFile(nullptr) {
+    : QDialog(parent_), m_exporter(nullptr), m_tempFile(nullptr), m_allEntriesReport(false) {
   setModal(false);
   setWindowTitle(i18n("Collection Report"));
 
@@ -196,6 +198,7 @@ ReportDialog::~ReportDialog() {
 
 void ReportDialog::slotGenerate() {
   GUI::CursorSaver cs(Qt::WaitCursor);
+  m_allEntriesReport = false;
 
   QVariant curData = m_templateCombo->currentData();
   const auto metaType = static_cast<QMetaType::Type>(curData.typeId());
@@ -281,35 +284,49 @@ void ReportDialog::generateAllEntries() {
     return;
   }
 
-  // do some surgery on the HTML since we've got <html> elements in every page
+  // the entry templates only show a single entry, so each one gets transformed separately.
+  // Rather than concatenating everything into one string, the first page provides the
+  // html head and the body of every page is written straight to a temporary file
+  delete m_tempFile;
+  m_tempFile = new QTemporaryFile(QDir::tempPath() + QLatin1String("/tellicoreport_XXXXXX") + QLatin1String(".html"));
+  if(!m_tempFile->open()) {
+    myWarning() << "unable to open temporary file for report";
+    return;
+  }
+  QTextStream ts(m_tempFile);
+  ts.setEncoding(QStringConverter::Utf8);
+
   static const QRegularExpression bodyRx(QStringLiteral("<body[^>]*>"));
-  m_exporter->setEntries(Controller::self()->visibleEntries());
-  QString html = m_exporter->text();
-  auto bodyMatch = bodyRx.match(html);
-  Q_ASSERT(bodyMatch.hasMatch());
-  const QString htmlStart = html.left(bodyMatch.capturedStart() + bodyMatch.capturedLength());
-  const QString htmlEnd = html.mid(html.lastIndexOf(QLatin1String("</body")));
   const QString htmlBetween = QStringLiteral("<p style=\"page-break-after: always;\">&nbsp;</p>"
                                              "<p style=\"page-break-before: always;\">&nbsp;</p>");
-
-  // estimate how much space in the string to reserve
-  const auto estimatedSize = Controller::self()->visibleEntries().size() * html.size();
-  html = htmlStart;
-  html.reserve(1.1*estimatedSize);
+  QString htmlEnd;
+  bool first = true;
   foreach(Data::EntryPtr entry, Controller::self()->visibleEntries()) {
     m_exporter->setEntries(Data::EntryList() << entry);
-    QString fullText = m_exporter->text();
+    const QString fullText = m_exporter->text();
     // extract the body portion
-    auto bodyMatch = bodyRx.match(fullText);
-    if(bodyMatch.hasMatch()) {
-      const auto bodyEnd = fullText.lastIndexOf(QLatin1String("</body"));
-      const auto bodyLength = bodyEnd - bodyMatch.capturedEnd();
-      html += fullText.mid(bodyMatch.capturedEnd(), bodyLength) + htmlBetween;
+    const auto bodyMatch = bodyRx.match(fullText);
+    if(!bodyMatch.hasMatch()) {
+      continue;
     }
+    const auto bodyStart = bodyMatch.capturedEnd();
+    const auto bodyEnd = fullText.lastIndexOf(QLatin1String("</body"));
+    if(bodyEnd < bodyStart) {
+      continue;
+    }
+    if(first) {
+      ts << QStringView(fullText).left(bodyStart);
+      htmlEnd = fullText.mid(bodyEnd);
+      first = false;
+    } else {
+      ts << htmlBetween;
+    }
+    ts << QStringView(fullText).mid(bodyStart, bodyEnd - bodyStart);
   }
-  html += htmlEnd;
-  m_exporter->setCustomHtml(html);
-  showText(html, QUrl::fromLocalFile(m_xsltFile));
+  ts << htmlEnd;
+  ts.flush();
+  m_allEntriesReport = true;
+  showTempFile(QUrl::fromLocalFile(m_xsltFile));
 }
 
 void ReportDialog::slotRefresh() {
@@ -335,8 +352,7 @@ void ReportDialog::slotRefresh() {
 }
 
 void ReportDialog::showText(const QString& text_, const QUrl& url_) {
-  // limit is 2 MB after percent encoding, etc., so give some padding
-  if(text_.size() > 1200000) {
+  if(text_.size() > REPORT_MAX_HTML_SIZE) {
     delete m_tempFile;
     m_tempFile = new QTemporaryFile(QDir::tempPath() + QLatin1String("/tellicoreport_XXXXXX") + QLatin1String(".html"));
     if(m_tempFile->open()) {
@@ -359,6 +375,16 @@ void ReportDialog::showText(const QString& text_, const QUrl& url_) {
 #endif
 }
 
+void ReportDialog::showTempFile(const QUrl& url_) {
+  // small reports are still set directly, so relative links resolve against the url
+  if(m_tempFile->size() > REPORT_MAX_HTML_SIZE) {
+    m_webView->load(QUrl::fromLocalFile(m_tempFile->fileName()));
+  } else {
+    m_tempFile->seek(0);
+    m_webView->setHtml(QString::fromUtf8(m_tempFile->readAll()), url_);
+  }
+}
+
 // actually the print button
 void ReportDialog::slotPrint() {
   if(m_reportView->currentIndex() == INDEX_CHART) {
@@ -442,7 +468,15 @@ void ReportDialog::slotSaveAs() {
       QUrl oldURL = m_exporter->url();
       m_exporter->setURL(u);
 
-      m_exporter->exec();
+      if(m_allEntriesReport && m_tempFile) {
+        // only read the report back in for as long as it takes to save it
+        m_tempFile->seek(0);
+        m_exporter->setCustomHtml(QString::fromUtf8(m_tempFile->readAll()));
+        m_exporter->exec();
+        m_exporter->setCustomHtml(QString());
+      } else {
+        m_exporter->exec();
+      }
 
       m_exporter->setURL(oldURL);
     }
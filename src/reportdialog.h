@@ -71,6 +71,7 @@ private:
   void generateHtml();
   void generateAllEntries();
   void showText(const QString& text, const QUrl& url);
+  void showTempFile(const QUrl& url);
 
   QStackedWidget* m_reportView;
   QWebEngineView* m_webView;
@@ -78,6 +79,8 @@ private:
   Export::HTMLExporter* m_exporter;
   QString m_xsltFile;
   QTemporaryFile* m_tempFile;
+  // the all entries report only exists in the temporary file
+  bool m_allEntriesReport;
 };
 
 } // end namespace
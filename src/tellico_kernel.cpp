@@ -25,6 +25,7 @@
 #include "tellico_kernel.h"
 #include "document.h"
 #include "collection.h"
+#include "controller.h"
 #include "filter.h"
 #include "filterdialog.h"
 #include "loandialog.h"
@@ -38,9 +39,12 @@
 #include "commands/removeloans.h"
 #include "commands/reorderfields.h"
 #include "commands/renamecollection.h"
+#include "commands/undohistory.h"
 #include "collectionfactory.h"
 #include "utils/cursorsaver.h"
 #include "utils/mergeconflictresolver.h"
+#include "config/tellico_config.h"
+#include "tellico_debug.h"
 
 #include <KMessageBox>
 #include <KLocalizedString>
@@ -53,7 +57,7 @@ Kernel* Kernel::s_self = nullptr;
 
 Kernel::Kernel(QWidget* parent) : QObject()
     , m_widget(parent)
-    , m_commandHistory(new QUndoStack(parent)) {
+    , m_commandHistory(new Command::UndoHistory(parent)) {
 }
 
 Kernel::~Kernel() {
@@ -81,17 +85,29 @@ void Kernel::sorry(const QString& text_, QWidget* widget_/* =nullptr */) {
   KMessageBox::error(widget_ ? widget_ : m_widget, text_);
 }
 
+QUndoStack* Kernel::commandHistory() {
+  return m_commandHistory->stack();
+}
+
 void Kernel::beginCommandGroup(const QString& name_) {
-  m_commandHistory->beginMacro(name_);
+  m_commandHistory->beginGroup(name_);
 }
 
 void Kernel::endCommandGroup() {
-  m_commandHistory->endMacro();
+  m_commandHistory->setMemoryLimit(Config::undoMemoryLimit());
+  m_commandHistory->endGroup();
+}
+
+void Kernel::beginTransaction() {
+  Controller::self()->beginTransaction(Data::Document::self()->collection());
+}
+
+void Kernel::commitTransaction() {
+  Controller::self()->commitTransaction();
 }
 
 void Kernel::resetHistory() {
   m_commandHistory->clear();
-  m_commandHistory->setClean();
 }
 
 bool Kernel::addField(Tellico::Data::FieldPtr field_) {
@@ -309,6 +325,8 @@ void Kernel::renameCollection() {
 }
 
 void Kernel::doCommand(QUndoCommand* command_) {
+  // the limit is checked once the command has run, when its size is known
+  m_commandHistory->setMemoryLimit(Config::undoMemoryLimit());
   m_commandHistory->push(command_);
 }
 
@@ -40,6 +40,9 @@ namespace Tellico {
   namespace Data {
     class Collection;
   }
+  namespace Command {
+    class UndoHistory;
+  }
 
 /**
  * @author Robby Stephenson
@@ -93,7 +96,7 @@ public:
   void replaceCollection(Data::CollPtr coll);
 
   void renameCollection();
-  QUndoStack* commandHistory() { return m_commandHistory; }
+  QUndoStack* commandHistory();
 
   int askAndMerge(Data::EntryPtr entry1, Data::EntryPtr entry2, Data::FieldPtr field,
                   QString value1 = QString(), QString value2 = QString());
@@ -101,6 +104,12 @@ public:
 public Q_SLOTS:
   void beginCommandGroup(const QString& name);
   void endCommandGroup();
+  /**
+   * Entry changes made within a transaction only update the group dicts and
+   * notify the views once, when the outermost transaction is committed.
+   */
+  void beginTransaction();
+  void commitTransaction();
 
   bool addField(Tellico::Data::FieldPtr field);
   bool modifyField(Tellico::Data::FieldPtr field);
@@ -118,7 +127,7 @@ private:
   void doCommand(QUndoCommand* command);
 
   QWidget* m_widget;
-  QUndoStack* m_commandHistory;
+  Command::UndoHistory* m_commandHistory;
 };
 
 } // end namespace
@@ -110,6 +110,33 @@ void BibtexTest::testImport() {
 #endif
 }
 
+void BibtexTest::testImportBatches() {
+#ifdef ENABLE_BTPARSE
+  // more entries than get converted in a single batch
+  QString text = QStringLiteral("@string{ACM = \"Association for Computing Machinery\"}\n");
+  for(int i = 0; i < 2500; ++i) {
+    text += QStringLiteral("@article{key%1,\n  author = {First %1 and Second {\\\"o}},\n"
+                           "  title = {Title {\\'e} %1},\n  publisher = ACM,\n  year = %2\n}\n").arg(i).arg(1900 + i % 100);
+  }
+
+  Tellico::Import::BibtexImporter importer(text);
+  Tellico::Data::CollPtr tmpColl(new Tellico::Data::BibtexCollection(true));
+  importer.setCurrentCollection(tmpColl);
+  Tellico::Data::CollPtr coll = importer.collection();
+  QVERIFY(coll);
+  QCOMPARE(coll->entryCount(), 2500);
+
+  Tellico::Data::BibtexCollection* bColl = static_cast<Tellico::Data::BibtexCollection*>(coll.data());
+  QCOMPARE(bColl->macroList().value(QStringLiteral("ACM")), QL1("Association for Computing Machinery"));
+  Tellico::Data::EntryPtr entry = bColl->entryByBibtexKey(QStringLiteral("key2345"));
+  QVERIFY(entry);
+  QCOMPARE(entry->field("author"), QString::fromUtf8("First 2345; Second \u00f6"));
+  QCOMPARE(entry->field("title"), QString::fromUtf8("Title \u00e9 2345"));
+  QCOMPARE(entry->field("publisher"), QL1("ACM"));
+  QCOMPARE(entry->field("year"), QL1("1945"));
+#endif
+}
+
 void BibtexTest::testPages() {
   // small test to check the pages value ends up with 2 hyphens
   Tellico::Data::CollPtr coll(new Tellico::Data::BibtexCollection(true));
@@ -33,6 +33,7 @@ Q_OBJECT
 private Q_SLOTS:
   void initTestCase();
   void testImport();
+  void testImportBatches();
   void testPages();
   void testDuplicateKeys();
   void testMapping();
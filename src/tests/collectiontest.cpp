@@ -25,8 +25,11 @@
 #include "collectiontest.h"
 
 #include "../collection.h"
+#include "../readonlycollection.h"
 #include "../field.h"
 #include "../entry.h"
+#include "../entrygroup.h"
+#include "../fieldformat.h"
 #include "../collectionfactory.h"
 #include "../collections/collectioninitializer.h"
 #include "../collections/bookcollection.h"
@@ -36,6 +39,7 @@
 #include "../images/imagefactory.h"
 #include "../document.h"
 #include "../utils/mergeconflictresolver.h"
+#include "../config/tellico_config.h"
 
 #include <KLocalizedString>
 #include <KProcess>
@@ -43,6 +47,7 @@
 #include <QTest>
 #include <QStandardPaths>
 #include <QRandomGenerator>
+#include <QtConcurrent>
 
 QTEST_GUILESS_MAIN( CollectionTest )
 
@@ -449,7 +454,7 @@ void CollectionTest::testDuplicate() {
   QVERIFY(entry1->field(QStringLiteral("cdate")) != entry2->field(QStringLiteral("cdate")));
   QCOMPARE(entry2->field(QStringLiteral("cdate")), QDate::currentDate().toString(Qt::ISODate));
 
-  // also test operator= which is how ModifyEntries::swapValues() works
+  // also test operator=, which changes the entry id
   Tellico::Data::Entry* entryPtr = new Tellico::Data::Entry(coll);
   *entryPtr = *entry1;
   Tellico::Data::EntryPtr entry3(entryPtr);
@@ -724,3 +729,308 @@ void CollectionTest::testNonTitle() {
   // since there's a new field formatted as a title, the entry title changes
   QCOMPARE(entry->title(), QStringLiteral("Proxy Title"));
 }
+
+void CollectionTest::testValueDict() {
+  Tellico::Data::CollPtr coll(new Tellico::Data::Collection(true)); // add default fields
+  Tellico::Data::FieldPtr field(new Tellico::Data::Field(QStringLiteral("author"), QStringLiteral("Author")));
+  field->setFlags(Tellico::Data::Field::AllowMultiple | Tellico::Data::Field::AllowCompletion);
+  coll->addField(field);
+
+  Tellico::Data::EntryPtr entry1(new Tellico::Data::Entry(coll));
+  entry1->setField(QStringLiteral("author"), QStringLiteral("Author 1; Author 2"));
+  coll->addEntries(entry1);
+
+  QVERIFY(!coll->hasFieldValueDict(QStringLiteral("author")));
+  QStringList values = coll->valuesByFieldName(QStringLiteral("author"));
+  QVERIFY(coll->hasFieldValueDict(QStringLiteral("author")));
+  QCOMPARE(values.count(), 2);
+  const uint generation = coll->fieldValuesGeneration(QStringLiteral("author"));
+  QVERIFY(generation > 0);
+
+  // adding an entry with an existing value doesn't change the values
+  Tellico::Data::EntryPtr entry2(new Tellico::Data::Entry(coll));
+  entry2->setField(QStringLiteral("author"), QStringLiteral("Author 2"));
+  coll->addEntries(entry2);
+  QCOMPARE(coll->fieldValuesGeneration(QStringLiteral("author")), generation);
+  QCOMPARE(coll->valuesByFieldName(QStringLiteral("author")).count(), 2);
+
+  // a new value does
+  entry2->setField(QStringLiteral("author"), QStringLiteral("Author 3"));
+  QVERIFY(coll->fieldValuesGeneration(QStringLiteral("author")) != generation);
+  values = coll->valuesByFieldName(QStringLiteral("author"));
+  QCOMPARE(values.count(), 3);
+  QVERIFY(values.contains(QStringLiteral("Author 3")));
+
+  // copies and entries not in the collection are not counted
+  Tellico::Data::EntryPtr entry3(new Tellico::Data::Entry(*entry2));
+  entry3->setField(QStringLiteral("author"), QStringLiteral("Author 4"));
+  QCOMPARE(coll->valuesByFieldName(QStringLiteral("author")).count(), 3);
+
+  // swapping values the way the modify command does
+  const Tellico::Data::ID id = entry2->id();
+  *entry2 = *entry3;
+  entry2->setId(id);
+  values = coll->valuesByFieldName(QStringLiteral("author"));
+  QCOMPARE(values.count(), 3);
+  QVERIFY(values.contains(QStringLiteral("Author 4")));
+  QVERIFY(!values.contains(QStringLiteral("Author 3")));
+
+  coll->removeEntries(Tellico::Data::EntryList() << entry1);
+  values = coll->valuesByFieldName(QStringLiteral("author"));
+  QCOMPARE(values, QStringList() << QStringLiteral("Author 4"));
+
+  coll->removeField(field);
+  QVERIFY(!coll->hasFieldValueDict(QStringLiteral("author")));
+}
+
+void CollectionTest::testTransaction() {
+  Tellico::Data::CollPtr coll(new Tellico::Data::BookCollection(true));
+  coll->setTrackGroups(true);
+  Tellico::Data::EntryPtr entry1(new Tellico::Data::Entry(coll));
+  entry1->setField(QStringLiteral("genre"), QStringLiteral("Genre 1"));
+  Tellico::Data::EntryPtr entry2(new Tellico::Data::Entry(coll));
+  entry2->setField(QStringLiteral("genre"), QStringLiteral("Genre 1"));
+  coll->addEntries(Tellico::Data::EntryList() << entry1 << entry2);
+
+  Tellico::Data::EntryGroupDict* dict = coll->entryGroupDictByName(QStringLiteral("genre"));
+  QVERIFY(dict);
+  QCOMPARE(dict->count(), 1);
+
+  coll->beginTransaction();
+  entry1->setField(QStringLiteral("genre"), QStringLiteral("Genre 2"));
+  coll->updateDicts(Tellico::Data::EntryList() << entry1, QStringList() << QStringLiteral("genre"));
+  entry2->setField(QStringLiteral("genre"), QStringLiteral("Genre 3"));
+  coll->updateDicts(Tellico::Data::EntryList() << entry2, QStringList() << QStringLiteral("genre"));
+  // nested transactions only update on the outermost commit
+  coll->beginTransaction();
+  coll->commitTransaction();
+  // the groups are not updated yet
+  QCOMPARE(dict->count(), 1);
+  QVERIFY(dict->contains(QStringLiteral("Genre 1")));
+
+  // removed entries don't get added back
+  coll->removeEntries(Tellico::Data::EntryList() << entry2);
+  coll->commitTransaction();
+  QCOMPARE(dict->count(), 1);
+  QVERIFY(dict->contains(QStringLiteral("Genre 2")));
+  QCOMPARE(dict->value(QStringLiteral("Genre 2"))->count(), 1);
+}
+
+void CollectionTest::testGroupDictInBackground() {
+  Tellico::Data::CollPtr coll(new Tellico::Data::BookCollection(true));
+  coll->setTrackGroups(true);
+  const QString genre(QStringLiteral("genre"));
+  const QString keyword(QStringLiteral("keyword"));
+  Tellico::Data::EntryList entries;
+  // enough entries to be grouped in the background
+  for(int i = 0; i < 2000; ++i) {
+    Tellico::Data::EntryPtr entry(new Tellico::Data::Entry(coll));
+    entry->setField(genre, QStringLiteral("Genre %1; Genre %2").arg(i % 10).arg(i % 7 + 100));
+    entry->setField(keyword, QStringLiteral("Keyword %1").arg(i % 5));
+    entries << entry;
+  }
+  coll->addEntries(entries);
+
+  Tellico::Data::EntryGroupDict* dict = coll->entryGroupDictInBackground(genre);
+  QVERIFY(dict);
+  QVERIFY(coll->isBuildingEntryGroupDict(genre));
+  // modify one entry while the groups are being built
+  entries.at(0)->setField(genre, QStringLiteral("Genre New"));
+  coll->updateDicts(Tellico::Data::EntryList() << entries.at(0), QStringList() << genre);
+  QTRY_VERIFY(!coll->isBuildingEntryGroupDict(genre));
+
+  QCOMPARE(dict->count(), 18);
+  QVERIFY(dict->contains(QStringLiteral("Genre New")));
+  QCOMPARE(dict->value(QStringLiteral("Genre New"))->count(), 1);
+  QCOMPARE(dict->value(QStringLiteral("Genre 0"))->count(), 199);
+  QCOMPARE(dict->value(QStringLiteral("Genre 100"))->count(), 285);
+
+  // asking for a dict directly finishes the build right away
+  coll->prepareEntryGroupDicts(QStringList() << keyword);
+  Tellico::Data::EntryGroupDict* keywordDict = coll->entryGroupDictByName(keyword);
+  QVERIFY(keywordDict);
+  QVERIFY(!coll->isBuildingEntryGroupDict(keyword));
+  QCOMPARE(keywordDict->count(), 5);
+  QCOMPARE(keywordDict->value(QStringLiteral("Keyword 0"))->count(), 400);
+}
+
+void CollectionTest::testReformatEntries() {
+  Tellico::Config::setAutoFormat(true);
+  Tellico::Config::setAutoCapitalization(true);
+  Tellico::Config::setArticlesString(QStringLiteral("the"));
+  Tellico::Config::setNameSuffixesString(QStringLiteral("jr."));
+  Tellico::FieldFormat::updateFormatRules();
+
+  Tellico::Data::CollPtr coll(new Tellico::Data::BookCollection(true));
+  const QString author(QStringLiteral("author"));
+  Tellico::Data::EntryList entries;
+  // enough entries to be formatted in parallel
+  for(int i = 0; i < 2000; ++i) {
+    Tellico::Data::EntryPtr entry(new Tellico::Data::Entry(coll));
+    entry->setField(QStringLiteral("title"), QStringLiteral("the title %1").arg(i));
+    entry->setField(author, QStringLiteral("tom swift %1").arg(i % 2 ? QStringLiteral("jr.") : QStringLiteral("sr.")));
+    entries << entry;
+  }
+  coll->addEntries(entries);
+
+  coll->reformatEntries();
+  QCOMPARE(entries.at(0)->formattedField(QStringLiteral("title")), QStringLiteral("Title 0, The"));
+  QCOMPARE(entries.at(0)->formattedField(author), QStringLiteral("Sr., Tom Swift"));
+  QCOMPARE(entries.at(1)->formattedField(author), QStringLiteral("Swift, Jr., Tom"));
+
+  // changing the preferences gets new formatting rules
+  Tellico::Config::setArticlesString(QStringLiteral("a,an"));
+  Tellico::Config::setNameSuffixesString(QStringLiteral("jr.,sr."));
+  Tellico::FieldFormat::updateFormatRules();
+  coll->invalidateGroups();
+  coll->reformatEntries();
+  QCOMPARE(entries.at(0)->formattedField(QStringLiteral("title")), QStringLiteral("The Title 0"));
+  QCOMPARE(entries.at(0)->formattedField(author), QStringLiteral("Swift, Sr., Tom"));
+  QCOMPARE(entries.at(1)->formattedField(author), QStringLiteral("Swift, Jr., Tom"));
+
+  Tellico::Config::setArticlesString(QStringLiteral("the"));
+  Tellico::Config::setNameSuffixesString(QStringLiteral("jr.,jr,iii,iv"));
+  Tellico::FieldFormat::updateFormatRules();
+}
+
+void CollectionTest::testSnapshot() {
+  Tellico::Data::CollPtr coll(new Tellico::Data::BookCollection(true));
+  const QString author(QStringLiteral("author"));
+  Tellico::Data::FieldPtr derived(new Tellico::Data::Field(QStringLiteral("test"), QStringLiteral("Test")));
+  derived->setProperty(QStringLiteral("template"), QStringLiteral("%{author:1} (%{@id})"));
+  derived->setFlags(Tellico::Data::Field::Derived);
+  coll->addField(derived);
+
+  Tellico::Data::EntryList entries;
+  for(int i = 0; i < 2000; ++i) {
+    Tellico::Data::EntryPtr entry(new Tellico::Data::Entry(coll));
+    entry->setField(QStringLiteral("title"), QStringLiteral("the title %1").arg(i));
+    entry->setField(author, QStringLiteral("tom swift %1; ned newton").arg(i));
+    entries << entry;
+  }
+  coll->addEntries(entries);
+
+  QStringList expected;
+  foreach(Tellico::Data::EntryPtr entry, entries) {
+    expected << entry->formattedField(author) + QLatin1Char('|') + entry->field(QStringLiteral("test"));
+  }
+
+  Tellico::Data::ReadOnlyCollection snapshot = coll->snapshot();
+  QCOMPARE(snapshot.type(), Tellico::Data::Collection::Book);
+  QCOMPARE(snapshot.entryCount(), 2000);
+  QCOMPARE(snapshot.fields().count(), coll->fields().count());
+
+  // edits to the live collection don't show up in the snapshot
+  entries.at(0)->setField(author, QStringLiteral("someone else"));
+  coll->removeField(QStringLiteral("test"));
+  coll->removeEntries(Tellico::Data::EntryList() << entries.at(1));
+  QVERIFY(!coll->hasField(QStringLiteral("test")));
+  QVERIFY(snapshot.fieldByName(QStringLiteral("test")));
+  QCOMPARE(snapshot.entryCount(), 2000);
+  const Tellico::Data::ReadOnlyEntry first = snapshot.entryById(entries.at(0)->id());
+  QCOMPARE(first.field(author), QStringLiteral("tom swift 0; ned newton"));
+  QCOMPARE(snapshot.field(first, QStringLiteral("test")),
+           QStringLiteral("tom swift 0 (%1)").arg(entries.at(0)->id()));
+
+  // any number of threads can read the snapshot at once
+  const QStringList values = QtConcurrent::blockingMapped<QStringList>(snapshot.entries(),
+    [snapshot, author](const Tellico::Data::ReadOnlyEntry& entry) {
+      return snapshot.formattedField(entry, author) + QLatin1Char('|') + snapshot.field(entry, QStringLiteral("test"));
+    });
+  QCOMPARE(values, expected);
+}
+
+void CollectionTest::testGenerations() {
+  Tellico::Data::CollPtr coll(new Tellico::Data::BookCollection(true));
+  const QString title(QStringLiteral("title"));
+  const QString author(QStringLiteral("author"));
+  Tellico::Data::EntryPtr entry1(new Tellico::Data::Entry(coll));
+  entry1->setField(title, QStringLiteral("Title 1"));
+  Tellico::Data::EntryPtr entry2(new Tellico::Data::Entry(coll));
+  entry2->setField(title, QStringLiteral("Title 2"));
+
+  Tellico::Data::Generation stamp = Tellico::Data::currentGeneration();
+  coll->addEntries(Tellico::Data::EntryList() << entry1 << entry2);
+  // adding entries changes the values of every field
+  QVERIFY(coll->generation() > stamp);
+  QVERIFY(coll->fieldGeneration(title) > stamp);
+  QVERIFY(coll->fieldGeneration(author) > stamp);
+
+  // changing a value only changes that entry and that field
+  stamp = Tellico::Data::currentGeneration();
+  entry1->setField(author, QStringLiteral("Albert Einstein"));
+  QVERIFY(entry1->generation() > stamp);
+  QVERIFY(entry2->generation() <= stamp);
+  QVERIFY(coll->generation() > stamp);
+  QVERIFY(coll->fieldGeneration(author) > stamp);
+  QVERIFY(coll->fieldGeneration(title) <= stamp);
+
+  // a snapshot is shared until something changes
+  Tellico::Data::ReadOnlyCollection snapshot1 = coll->snapshot();
+  Tellico::Data::ReadOnlyCollection snapshot2 = coll->snapshot();
+  QCOMPARE(&snapshot1.entries(), &snapshot2.entries());
+  coll->fieldByName(title)->setProperty(QStringLiteral("test"), QStringLiteral("value"));
+  Tellico::Data::ReadOnlyCollection snapshot3 = coll->snapshot();
+  QVERIFY(&snapshot3.entries() != &snapshot1.entries());
+  QCOMPARE(snapshot3.fieldByName(title)->property(QStringLiteral("test")), QStringLiteral("value"));
+
+  stamp = Tellico::Data::currentGeneration();
+  Tellico::Data::FieldPtr field(new Tellico::Data::Field(*coll->fieldByName(author)));
+  field->setTitle(QStringLiteral("Writer"));
+  QVERIFY(field->generation() > stamp);
+  stamp = Tellico::Data::currentGeneration();
+  coll->modifyField(field);
+  QVERIFY(coll->fieldGeneration(author) > stamp);
+  QVERIFY(coll->fieldGeneration(title) <= stamp);
+
+  stamp = Tellico::Data::currentGeneration();
+  coll->removeEntries(Tellico::Data::EntryList() << entry2);
+  QVERIFY(coll->fieldGeneration(title) > stamp);
+  QCOMPARE(coll->snapshot().entryCount(), 1);
+
+  // a removed entry no longer changes the collection
+  stamp = Tellico::Data::currentGeneration();
+  entry2->setField(title, QStringLiteral("Title 3"));
+  QVERIFY(entry2->generation() > stamp);
+  QVERIFY(coll->generation() <= stamp);
+}
+
+void CollectionTest::testAddManyEntries() {
+  Tellico::Data::CollPtr coll(new Tellico::Data::BookCollection(true));
+  const QString today = QDate::currentDate().toString(Qt::ISODate);
+  const QString weekAgo = QDate::currentDate().addDays(-7).toString(Qt::ISODate);
+
+  Tellico::Data::EntryList entries;
+  for(int i = 0; i < 1000; ++i) {
+    Tellico::Data::EntryPtr entry(new Tellico::Data::Entry(coll));
+    entry->setField(QStringLiteral("title"), QStringLiteral("Title %1").arg(i));
+    entry->setField(QStringLiteral("author"), (i % 2 == 0) ? QStringLiteral("Author A") : QStringLiteral("Author B"));
+    if(i % 10 == 0) {
+      entry->setField(QStringLiteral("mdate"), weekAgo);
+    }
+    entries += entry;
+  }
+  // a duplicate id gets replaced
+  entries.at(1)->setId(5);
+  entries.at(2)->setId(5);
+  coll->addEntries(entries);
+  QCOMPARE(coll->entryCount(), 1000);
+
+  QSet<Tellico::Data::ID> ids;
+  foreach(Tellico::Data::EntryPtr entry, coll->entries()) {
+    ids.insert(entry->id());
+    QCOMPARE(coll->entryById(entry->id()), entry);
+  }
+  QCOMPARE(ids.count(), 1000);
+
+  // cdate falls back to mdate when it exists
+  QCOMPARE(entries.at(0)->field(QStringLiteral("cdate")), weekAgo);
+  QCOMPARE(entries.at(0)->field(QStringLiteral("mdate")), weekAgo);
+  QCOMPARE(entries.at(1)->field(QStringLiteral("cdate")), today);
+  QCOMPARE(entries.at(1)->field(QStringLiteral("mdate")), today);
+
+  Tellico::Data::EntryGroupDict* dict = coll->entryGroupDictByName(QStringLiteral("author"));
+  QVERIFY(dict);
+  QCOMPARE(dict->count(), 2);
+  QCOMPARE(dict->value(QStringLiteral("Author A"))->count(), 500);
+}
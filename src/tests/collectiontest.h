@@ -51,6 +51,13 @@ private Q_SLOTS:
   void testGamePlatform();
   void testEsrb();
   void testNonTitle();
+  void testValueDict();
+  void testTransaction();
+  void testGroupDictInBackground();
+  void testReformatEntries();
+  void testSnapshot();
+  void testGenerations();
+  void testAddManyEntries();
 };
 
 #endif
@@ -28,6 +28,7 @@
 #include "../models/stringcomparison.h"
 #include "../models/fieldcomparison.h"
 #include "../images/imagefactory.h"
+#include "../fieldformat.h"
 #include "../config/tellico_config.h"
 
 #include <KLocalizedString>
@@ -39,6 +40,7 @@ QTEST_GUILESS_MAIN( ComparisonTest )
 void ComparisonTest::initTestCase() {
   KLocalizedString::setApplicationDomain("tellico");
   Tellico::Config::setArticlesString(QStringLiteral("the,l'"));
+  Tellico::FieldFormat::updateFormatRules();
   Tellico::ImageFactory::init();
 }
 
@@ -38,6 +38,9 @@
 
 #include <QTest>
 #include <QStandardPaths>
+#include <QBuffer>
+#include <QTemporaryDir>
+#include <QFile>
 
 QTEST_MAIN( CsvTest )
 
@@ -88,6 +91,34 @@ void CsvTest::testTokens_data() {
     << (QStringList() << QSL("robby") << QSL("stephenson\n,is,cool"));
 }
 
+void CsvTest::testDevice() {
+  // enough rows to span several chunks, with quoted newlines
+  QByteArray data("title,author\n");
+  for(int i = 0; i < 5000; ++i) {
+    data += "\"title " + QByteArray::number(i) + "\nline two\",author " + QByteArray::number(i) + '\n';
+  }
+  QBuffer buffer(&data);
+  QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+  Tellico::CSVParser p(&buffer);
+  p.setDelimiter(QSL(","));
+  p.skipLine();
+
+  int count = 0;
+  QStringList tokens;
+  while(p.hasNext()) {
+    tokens = p.nextTokens();
+    if(count == 0) {
+      QCOMPARE(tokens, QStringList() << QSL("title 0\nline two") << QSL("author 0"));
+    }
+    ++count;
+  }
+  QCOMPARE(count, 5000);
+  QCOMPARE(tokens, QStringList() << QSL("title 4999\nline two") << QSL("author 4999"));
+  QCOMPARE(p.position(), p.size());
+  QVERIFY(p.nextTokens().isEmpty());
+}
+
 void CsvTest::testEntry() {
   Tellico::Data::CollPtr coll(new Tellico::Data::Collection(true));
   Tellico::Data::EntryPtr entry(new Tellico::Data::Entry(coll));
@@ -108,6 +139,36 @@ void CsvTest::testEntry() {
   QCOMPARE(output, QStringLiteral("\"title, with comma\""));
 }
 
+void CsvTest::testExportFile() {
+  Tellico::Data::CollPtr coll(new Tellico::Data::Collection(true));
+  Tellico::Data::EntryList entries;
+  // enough entries for the export to be formatted in several chunks
+  for(int i = 0; i < 2345; ++i) {
+    Tellico::Data::EntryPtr entry(new Tellico::Data::Entry(coll));
+    entry->setField(QSL("title"), QSL("title %1, with comma \u00e9").arg(i));
+    entries << entry;
+  }
+  coll->addEntries(entries);
+
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  const QString fileName = dir.filePath(QSL("export.csv"));
+
+  Tellico::Export::CSVExporter exporter(coll);
+  exporter.setEntries(coll->entries());
+  exporter.setOptions(Tellico::Export::ExportUTF8 | Tellico::Export::ExportForce);
+  exporter.setURL(QUrl::fromLocalFile(fileName));
+  QVERIFY(exporter.exec());
+
+  QFile file(fileName);
+  QVERIFY(file.open(QIODevice::ReadOnly));
+  const QString output = QString::fromUtf8(file.readAll());
+  // the streamed file has the same text, in the same order, as the text built in memory
+  QCOMPARE(output, exporter.text());
+  QCOMPARE(output.count(QLatin1Char('\n')), 2346);
+  QVERIFY(output.contains(QSL("\"title 2344, with comma \u00e9\"")));
+}
+
 void CsvTest::testImportBook() {
   QUrl url = QUrl::fromLocalFile(QFINDTESTDATA("data/test-book.csv"));
   Tellico::Import::CSVImporter importer(url);
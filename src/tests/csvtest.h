@@ -36,7 +36,9 @@ private Q_SLOTS:
 
   void testTokens();
   void testTokens_data();
+  void testDevice();
   void testEntry();
+  void testExportFile();
   void testImportBook();
   void testBug386483();
   void testDateFormat();
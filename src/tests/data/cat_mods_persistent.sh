@@ -0,0 +1,11 @@
+#!/bin/sh
+
+# answer every request line with the MODS file, framed by the request id and its length
+BASEDIR=$(dirname $0)
+FILE=${BASEDIR}/example_mods.xml
+SIZE=$(wc -c < ${FILE})
+while read -r line; do
+  id=$(echo "$line" | cut -f1)
+  printf '%s %s\n' "$id" ${SIZE}
+  /usr/bin/cat ${FILE}
+done
@@ -0,0 +1,9 @@
+ArgumentKeys=1,3
+Arguments=%1,%1
+CollectionType=2
+FormatType=6
+Name=Cat File
+Type=data-source
+PersistentArgs=--persistent
+UpdateArgs=%{title} %{isbn}
+Uuid={5a0b2c9e-6f1d-4c8a-9e3b-7d4f1a2c8b60}
@@ -26,6 +26,13 @@
 
 #include "documenttest.h"
 #include "../document.h"
+#include "../documentjournal.h"
+#include "../changenotifier.h"
+#include "../commands/addentries.h"
+#include "../commands/modifyentries.h"
+#include "../commands/removeentries.h"
+#include "../commands/fieldcommand.h"
+#include "../commands/renamecollection.h"
 #include "../images/imagefactory.h"
 #include "../images/image.h"
 #include "../config/tellico_config.h"
@@ -42,6 +49,7 @@
 #include <QTemporaryDir>
 #include <QTemporaryFile>
 #include <QFile>
+#include <QDir>
 #include <QStandardPaths>
 #include <QLoggingCategory>
 #include <QCoreApplication>
@@ -332,3 +340,111 @@ void DocumentTest::testView() {
   QVERIFY(imageDir.exists(imageName));
   QVERIFY(imageDir.exists(newImageId));
 }
+
+void DocumentTest::testJournal() {
+  QTemporaryDir tempDir;
+  QVERIFY(tempDir.isValid());
+  const QString fileName = tempDir.path() + "/journal.tc";
+  QVERIFY(QFile::copy(QFINDTESTDATA("data/with-image.tc"), fileName));
+  QFile::setPermissions(fileName, QFile::ReadOwner | QFile::WriteOwner);
+  const QUrl url = QUrl::fromLocalFile(fileName);
+  const QDir journalDir(Tellico::Data::DocumentJournal::journalDirectory());
+  // the journal is a hidden option
+  QVERIFY(!Tellico::Config::changeJournal());
+  Tellico::Config::setChangeJournal(true);
+
+  auto doc = Tellico::Data::Document::self();
+  QVERIFY(doc->openDocument(url));
+  QVERIFY(!doc->isModified());
+  Tellico::Data::CollPtr coll = doc->collection();
+  const int count = coll->entryCount();
+
+  // the undo commands notify the journal the same way they do in the main window
+  Tellico::ChangeNotifier notifier;
+  QCOMPARE(Tellico::ChangeNotifier::self(), &notifier);
+  notifier.addObserver(doc->journal());
+
+  const QString title = QStringLiteral("title");
+  Tellico::Data::EntryPtr entry = coll->entries().at(0);
+  const Tellico::Data::ID id = entry->id();
+  Tellico::Data::EntryPtr oldEntry(new Tellico::Data::Entry(*entry));
+  entry->setField(title, QStringLiteral("Journaled Title"));
+  Tellico::Command::ModifyEntries modifyCmd(coll, Tellico::Data::EntryList() << oldEntry,
+                                            Tellico::Data::EntryList() << entry, QStringList() << title);
+  modifyCmd.redo();
+
+  Tellico::Data::EntryPtr newEntry(new Tellico::Data::Entry(coll));
+  newEntry->setField(title, QStringLiteral("New Entry"));
+  Tellico::Command::AddEntries addCmd(coll, Tellico::Data::EntryList() << newEntry);
+  addCmd.redo();
+  const Tellico::Data::ID newId = newEntry->id();
+
+  // the whole field definition is journaled, not just its values
+  Tellico::Data::FieldPtr field(new Tellico::Data::Field(QStringLiteral("journaled"), QStringLiteral("Journaled"),
+                                                         QStringList() << QStringLiteral("one") << QStringLiteral("two")));
+  field->setFlags(Tellico::Data::Field::AllowGrouped);
+  Tellico::Command::FieldCommand fieldCmd(Tellico::Command::FieldCommand::FieldAdd, coll, field);
+  fieldCmd.redo();
+  oldEntry = Tellico::Data::EntryPtr(new Tellico::Data::Entry(*entry));
+  entry->setField(field, QStringLiteral("two"));
+  Tellico::Command::ModifyEntries fieldValueCmd(coll, Tellico::Data::EntryList() << oldEntry,
+                                                Tellico::Data::EntryList() << entry, QStringList() << field->name());
+  fieldValueCmd.redo();
+  QCOMPARE(journalDir.entryList(QStringList() << QStringLiteral("*-0.journal"), QDir::Files).size(), 1);
+  QVERIFY(journalDir.entryList(QStringList() << QStringLiteral("*.checkpoint"), QDir::Files).isEmpty());
+
+  // opening the file again without saving recovers the changes
+  QVERIFY(doc->openDocument(url));
+  QVERIFY(doc->isModified());
+  coll = doc->collection();
+  QCOMPARE(coll->entryCount(), count + 1);
+  QCOMPARE(coll->entryById(id)->title(), QStringLiteral("Journaled Title"));
+  QCOMPARE(coll->entryById(id)->field(QStringLiteral("journaled")), QStringLiteral("two"));
+  QVERIFY(coll->entryById(newId));
+  QCOMPARE(coll->entryById(newId)->title(), QStringLiteral("New Entry"));
+  Tellico::Data::FieldPtr recoveredField = coll->fieldByName(QStringLiteral("journaled"));
+  QVERIFY(recoveredField);
+  QCOMPARE(recoveredField->type(), Tellico::Data::Field::Choice);
+  QCOMPARE(recoveredField->allowed(), field->allowed());
+  QCOMPARE(recoveredField->flags(), int(Tellico::Data::Field::AllowGrouped));
+
+  Tellico::Command::RemoveEntries removeCmd(coll, Tellico::Data::EntryList() << coll->entryById(newId));
+  removeCmd.redo();
+  Tellico::Command::RenameCollection renameCmd(coll, QStringLiteral("Journaled Collection"));
+  renameCmd.redo();
+
+  // compacting writes a checkpoint in the background and removes the older journal
+  QVERIFY(QMetaObject::invokeMethod(doc->journal(), "slotCompact"));
+  QTRY_COMPARE(journalDir.entryList(QStringList() << QStringLiteral("*-1.checkpoint"), QDir::Files).size(), 1);
+  QTRY_VERIFY(journalDir.entryList(QStringList() << QStringLiteral("*-0.*"), QDir::Files).isEmpty());
+
+  QVERIFY(doc->openDocument(url));
+  QVERIFY(doc->isModified());
+  coll = doc->collection();
+  QCOMPARE(coll->title(), QStringLiteral("Journaled Collection"));
+  QCOMPARE(coll->entryCount(), count);
+  QCOMPARE(coll->entryById(id)->title(), QStringLiteral("Journaled Title"));
+  QVERIFY(!coll->entryById(newId));
+  QCOMPARE(coll->fieldByName(QStringLiteral("journaled"))->type(), Tellico::Data::Field::Choice);
+  QCOMPARE(coll->entryById(id)->field(QStringLiteral("journaled")), QStringLiteral("two"));
+
+  // undoing is journaled too
+  Tellico::Data::EntryPtr undoEntry = coll->entryById(id);
+  oldEntry = Tellico::Data::EntryPtr(new Tellico::Data::Entry(*undoEntry));
+  undoEntry->setField(title, QStringLiteral("Undone Title"));
+  Tellico::Command::ModifyEntries undoCmd(coll, Tellico::Data::EntryList() << oldEntry,
+                                          Tellico::Data::EntryList() << undoEntry, QStringList() << title);
+  undoCmd.redo();
+  undoCmd.undo();
+  QVERIFY(doc->openDocument(url));
+  QCOMPARE(doc->collection()->entryById(id)->title(), QStringLiteral("Journaled Title"));
+
+  // once saved, there's nothing left to recover
+  QVERIFY(doc->saveDocument(url));
+  QVERIFY(journalDir.entryList(QDir::Files).isEmpty());
+  QVERIFY(doc->openDocument(url));
+  QVERIFY(!doc->isModified());
+  QCOMPARE(doc->collection()->entryById(id)->title(), QStringLiteral("Journaled Title"));
+  notifier.removeObserver(doc->journal());
+  Tellico::Config::setChangeJournal(false);
+}
@@ -37,6 +37,7 @@ private Q_SLOTS:
   void testImageLocalDirectory();
   void testSaveTemplate();
   void testView();
+  void testJournal();
 };
 
 #endif
@@ -79,6 +79,10 @@ void EntityTest::testAccents_data() {
   QTest::newRow("svet") << QSL("Tmavomodrý Svět") << QSL("Tmavomodry Svet");
   QTest::newRow("russian") << QSL("Возвращение Супермена") << QSL("Возвращение Супермена");
   QTest::newRow("chinese") << QSL("湖南科学技术出版社") << QSL("湖南科学技术出版社");
+  QTest::newRow("combining") << QSL("Jose\u0301 Guzma\u0301n") << QSL("Jose Guzman");
+  QTest::newRow("latin-b") << QSL("Lǖ Ǻrbol") << QSL("Lu Arbol");
+  QTest::newRow("vietnamese") << QSL("Tiếng Việt") << QSL("Tieng Viet");
+  QTest::newRow("greek") << QSL("Ἀθῆναι") << QSL("Αθηναι");
 }
 
 void EntityTest::testI18nReplace() {
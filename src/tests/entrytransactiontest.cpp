@@ -0,0 +1,154 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "entrytransactiontest.h"
+
+#include "../entrytransaction.h"
+#include "../collection.h"
+#include "../entry.h"
+#include "../entrygroup.h"
+#include "../collections/bookcollection.h"
+
+#include <KLocalizedString>
+
+#include <QTest>
+#include <QStandardPaths>
+
+QTEST_GUILESS_MAIN( EntryTransactionTest )
+
+void EntryTransactionTest::initTestCase() {
+  QStandardPaths::setTestModeEnabled(true);
+  KLocalizedString::setApplicationDomain("tellico");
+}
+
+void EntryTransactionTest::testNesting() {
+  const QString genre(QStringLiteral("genre"));
+  Tellico::Data::CollPtr coll(new Tellico::Data::BookCollection(true));
+  coll->setTrackGroups(true);
+  Tellico::Data::EntryPtr entry(new Tellico::Data::Entry(coll));
+  entry->setField(genre, QStringLiteral("Genre 1"));
+  coll->addEntries(Tellico::Data::EntryList() << entry);
+  Tellico::Data::EntryGroupDict* dict = coll->entryGroupDictByName(genre);
+  QVERIFY(dict);
+
+  Tellico::EntryTransaction transaction;
+  QVERIFY(!transaction.isOpen());
+  // committing without a transaction does nothing
+  QVERIFY(!transaction.commit());
+
+  transaction.begin(coll);
+  transaction.begin(coll);
+  QCOMPARE(transaction.depth(), 2);
+  entry->setField(genre, QStringLiteral("Genre 2"));
+  coll->updateDicts(Tellico::Data::EntryList() << entry, QStringList() << genre);
+  transaction.modifyEntries(Tellico::Data::EntryList() << entry);
+
+  QVERIFY(!transaction.commit());
+  QVERIFY(transaction.isOpen());
+  QVERIFY(dict->contains(QStringLiteral("Genre 1")));
+
+  QVERIFY(transaction.commit());
+  QVERIFY(!transaction.isOpen());
+  // the groups are updated when the outermost transaction is committed
+  QCOMPARE(dict->count(), 1);
+  QVERIFY(dict->contains(QStringLiteral("Genre 2")));
+  QCOMPARE(transaction.takeModified(), Tellico::Data::EntryList() << entry);
+  QVERIFY(transaction.takeModified().isEmpty());
+  QVERIFY(!transaction.commit());
+}
+
+void EntryTransactionTest::testMergeChanges() {
+  Tellico::Data::CollPtr coll(new Tellico::Data::BookCollection(true));
+  Tellico::Data::EntryPtr entry1(new Tellico::Data::Entry(coll));
+  Tellico::Data::EntryPtr entry2(new Tellico::Data::Entry(coll));
+  Tellico::Data::EntryPtr entry3(new Tellico::Data::Entry(coll));
+  Tellico::Data::EntryPtr entry4(new Tellico::Data::Entry(coll));
+  coll->addEntries(Tellico::Data::EntryList() << entry3 << entry4);
+
+  Tellico::EntryTransaction transaction;
+  transaction.begin(coll);
+  // a new entry that gets modified is only added
+  transaction.addEntries(Tellico::Data::EntryList() << entry1);
+  transaction.modifyEntries(Tellico::Data::EntryList() << entry1 << entry1);
+  // a new entry that gets removed is never reported
+  transaction.addEntries(Tellico::Data::EntryList() << entry2);
+  transaction.removeEntries(Tellico::Data::EntryList() << entry2);
+  // a modified entry that gets removed is only removed
+  transaction.modifyEntries(Tellico::Data::EntryList() << entry3);
+  transaction.removeEntries(Tellico::Data::EntryList() << entry3);
+  // a removed entry that gets added back is modified
+  transaction.removeEntries(Tellico::Data::EntryList() << entry4);
+  transaction.addEntries(Tellico::Data::EntryList() << entry4);
+  QVERIFY(transaction.commit());
+
+  QCOMPARE(transaction.takeAdded(), Tellico::Data::EntryList() << entry1);
+  QCOMPARE(transaction.takeModified(), Tellico::Data::EntryList() << entry4);
+  QCOMPARE(transaction.takeRemoved(), Tellico::Data::EntryList() << entry3);
+}
+
+void EntryTransactionTest::testReset() {
+  const QString genre(QStringLiteral("genre"));
+  Tellico::Data::CollPtr coll(new Tellico::Data::BookCollection(true));
+  coll->setTrackGroups(true);
+  Tellico::Data::EntryPtr entry(new Tellico::Data::Entry(coll));
+  entry->setField(genre, QStringLiteral("Genre 1"));
+  coll->addEntries(Tellico::Data::EntryList() << entry);
+  Tellico::Data::EntryGroupDict* dict = coll->entryGroupDictByName(genre);
+  QVERIFY(dict);
+
+  // a client that never commits, like a script that exits early
+  Tellico::EntryTransaction transaction;
+  transaction.begin(coll);
+  transaction.begin(coll);
+  entry->setField(genre, QStringLiteral("Genre 2"));
+  coll->updateDicts(Tellico::Data::EntryList() << entry, QStringList() << genre);
+  transaction.modifyEntries(Tellico::Data::EntryList() << entry);
+  transaction.removeEntries(Tellico::Data::EntryList() << entry);
+
+  transaction.reset();
+  QVERIFY(!transaction.isOpen());
+  // the collection is not left in its transaction
+  QVERIFY(dict->contains(QStringLiteral("Genre 2")));
+  QVERIFY(transaction.takeAdded().isEmpty());
+  QVERIFY(transaction.takeModified().isEmpty());
+  QVERIFY(transaction.takeRemoved().isEmpty());
+  // a late commit from the client is ignored
+  QVERIFY(!transaction.commit());
+
+  // and a new transaction on a new collection starts cleanly
+  Tellico::Data::CollPtr coll2(new Tellico::Data::BookCollection(true));
+  coll2->setTrackGroups(true);
+  Tellico::Data::EntryPtr entry2(new Tellico::Data::Entry(coll2));
+  entry2->setField(genre, QStringLiteral("Genre 3"));
+  transaction.begin(coll2);
+  coll2->addEntries(Tellico::Data::EntryList() << entry2);
+  transaction.addEntries(Tellico::Data::EntryList() << entry2);
+  QVERIFY(transaction.commit());
+  QCOMPARE(transaction.takeAdded(), Tellico::Data::EntryList() << entry2);
+  Tellico::Data::EntryGroupDict* dict2 = coll2->entryGroupDictByName(genre);
+  QVERIFY(dict2);
+  QVERIFY(dict2->contains(QStringLiteral("Genre 3")));
+  // the old collection's groups were not touched
+  QCOMPARE(dict->count(), 1);
+}
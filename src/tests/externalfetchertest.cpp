@@ -34,11 +34,14 @@
 
 #include <KSharedConfig>
 #include <KConfigGroup>
+#include <KProcess>
 
 #include <QTest>
 #include <QStandardPaths>
+#include <QTemporaryDir>
 
-QTEST_GUILESS_MAIN( ExternalFetcherTest )
+// the config widget needs a QApplication
+QTEST_MAIN( ExternalFetcherTest )
 
 ExternalFetcherTest::ExternalFetcherTest() : AbstractFetcherTest() {
 }
@@ -84,3 +87,52 @@ void ExternalFetcherTest::testMods() {
   QCOMPARE(entry->field("isbn"), QStringLiteral("0-8014-8639-4"));
   QCOMPARE(entry->field("lccn"), QStringLiteral("99042030"));
 }
+
+void ExternalFetcherTest::testModsPersistent() {
+  Tellico::Fetch::FetchRequest request(Tellico::Data::Collection::Book, Tellico::Fetch::Title,
+                                       QStringLiteral("sound\tand\nfury"));
+  Tellico::Fetch::Fetcher::Ptr fetcher(new Tellico::Fetch::ExecExternalFetcher(this));
+
+  // add the source from its spec file, the same way the config dialog does
+  KSharedConfig::Ptr spec = KSharedConfig::openConfig(QFINDTESTDATA("data/cat_mods_persistent.spec"), KConfig::SimpleConfig);
+  KConfigGroup specConfig = spec->group(QString());
+  specConfig.writeEntry("ExecPath", QFINDTESTDATA("data/cat_mods_persistent.sh"));
+  specConfig.markAsClean(); // don't edit the file on sync()
+  Tellico::Fetch::ExecExternalFetcher::ConfigWidget widget(nullptr);
+  widget.readConfig(specConfig);
+
+  QTemporaryDir dir;
+  KConfig config(dir.filePath(QStringLiteral("tellicorc")), KConfig::SimpleConfig);
+  KConfigGroup cg = config.group(QStringLiteral("Data Source 0"));
+  widget.saveConfig(cg);
+  QCOMPARE(cg.readEntry("PersistentArgs"), QStringLiteral("--persistent"));
+
+  fetcher->readConfig(cg);
+  auto execFetcher = static_cast<Tellico::Fetch::ExecExternalFetcher*>(fetcher.data());
+  QVERIFY(execFetcher->m_persistent);
+
+  Tellico::Data::EntryList results = DO_FETCH1(fetcher, request, 1);
+  QCOMPARE(results.size(), 1);
+  QCOMPARE(results.at(0)->field("title"), QStringLiteral("Sound and fury"));
+  QVERIFY(execFetcher->m_server);
+  const auto pid = execFetcher->m_server->processId();
+
+  // a stopped search is still waiting on the process when the next one starts
+  fetcher->startSearch(request);
+  fetcher->stop();
+  QCOMPARE(execFetcher->m_serverRequests.size(), 1);
+
+  // the second search goes to the same process, and the response to the stopped one is dropped
+  results = DO_FETCH1(fetcher, request, 1);
+  QCOMPARE(results.size(), 1);
+  QCOMPARE(results.at(0)->field("isbn"), QStringLiteral("0-8014-8639-4"));
+  QVERIFY(execFetcher->m_server);
+  QCOMPARE(execFetcher->m_server->processId(), pid);
+  QVERIFY(execFetcher->m_serverRequests.isEmpty());
+
+  // editing the source again keeps it persistent
+  Tellico::Fetch::ExecExternalFetcher::ConfigWidget editWidget(nullptr, execFetcher);
+  KConfigGroup cg2 = config.group(QStringLiteral("Data Source 1"));
+  editWidget.saveConfig(cg2);
+  QCOMPARE(cg2.readEntry("PersistentArgs"), QStringLiteral("--persistent"));
+}
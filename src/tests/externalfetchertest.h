@@ -36,6 +36,7 @@ private Q_SLOTS:
   void initTestCase();
   void testParsing();
   void testMods();
+  void testModsPersistent();
 };
 
 #endif
@@ -0,0 +1,106 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#undef QT_NO_CAST_FROM_ASCII
+
+#include "fetchresultcachetest.h"
+
+#include "../fetch/fetchresultcache.h"
+#include "../collections/bookcollection.h"
+#include "../collectionfactory.h"
+#include "../entry.h"
+#include "../images/imagefactory.h"
+
+#include <KLocalizedString>
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <QDateTime>
+#include <QFile>
+#include <QStandardPaths>
+
+QTEST_GUILESS_MAIN( FetchResultCacheTest )
+
+void FetchResultCacheTest::initTestCase() {
+  QStandardPaths::setTestModeEnabled(true);
+  KLocalizedString::setApplicationDomain("tellico");
+  Tellico::ImageFactory::init();
+  Tellico::RegisterCollection<Tellico::Data::BookCollection> registerBook(Tellico::Data::Collection::Book, "book");
+}
+
+void FetchResultCacheTest::testCache() {
+  QTemporaryDir dir;
+  Tellico::Fetch::FetchResultCache cache(dir.path());
+  QCOMPARE(cache.size(), 0);
+  QVERIFY(!cache.entry(QStringLiteral("missing")));
+
+  Tellico::Data::CollPtr coll(new Tellico::Data::BookCollection(true));
+  Tellico::Data::EntryPtr entry(new Tellico::Data::Entry(coll));
+  entry->setField(QStringLiteral("title"), QStringLiteral("Sound and fury"));
+  entry->setField(QStringLiteral("isbn"), QStringLiteral("0-8014-8639-4"));
+  coll->addEntries(entry);
+
+  cache.insert(QStringLiteral("key"), entry);
+  QVERIFY(cache.size() > 0);
+
+  // a new cache object reads the same directory
+  Tellico::Fetch::FetchResultCache cache2(dir.path());
+  QCOMPARE(cache2.size(), cache.size());
+  Tellico::Data::EntryPtr cachedEntry = cache2.entry(QStringLiteral("key"));
+  QVERIFY(cachedEntry);
+  QVERIFY(cachedEntry->collection());
+  QCOMPARE(cachedEntry->collection()->type(), Tellico::Data::Collection::Book);
+  QCOMPARE(cachedEntry->title(), QStringLiteral("Sound and fury"));
+  QCOMPARE(cachedEntry->field(QStringLiteral("isbn")), QStringLiteral("0-8014-8639-4"));
+
+  cache2.remove(QStringLiteral("key"));
+  QCOMPARE(cache2.size(), 0);
+  QVERIFY(!cache.entry(QStringLiteral("key")));
+}
+
+void FetchResultCacheTest::testPrune() {
+  QTemporaryDir dir;
+  Tellico::Fetch::FetchResultCache cache(dir.path());
+
+  Tellico::Data::CollPtr coll(new Tellico::Data::BookCollection(true));
+  Tellico::Data::EntryPtr entry(new Tellico::Data::Entry(coll));
+  entry->setField(QStringLiteral("title"), QStringLiteral("Sound and fury"));
+  coll->addEntries(entry);
+
+  cache.insert(QStringLiteral("old"), entry);
+  cache.insert(QStringLiteral("new"), entry);
+
+  // the first one was last used an hour ago
+  QFile file(dir.filePath(QStringLiteral("old.xml")));
+  QVERIFY(file.open(QIODevice::ReadOnly));
+  QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(-3600), QFileDevice::FileModificationTime));
+  file.close();
+
+  // shrinking the cache removes the least recently used entry
+  cache.setMaxSize(cache.size() - 1);
+  QVERIFY(cache.size() <= cache.maxSize());
+  QVERIFY(!cache.entry(QStringLiteral("old")));
+  QVERIFY(cache.entry(QStringLiteral("new")));
+}
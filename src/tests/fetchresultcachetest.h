@@ -1,5 +1,5 @@
 /***************************************************************************
-    Copyright (C) 2010 Robby Stephenson <robby@periapsis.org>
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
  ***************************************************************************/
 
 /***************************************************************************
@@ -22,33 +22,19 @@
  *                                                                         *
  ***************************************************************************/
 
-#include "gcstarthread.h"
 
-#include <KProcess>
+#ifndef FETCHRESULTCACHETEST_H
+#define FETCHRESULTCACHETEST_H
 
-using Tellico::Fetch::GCstarThread;
+#include <QObject>
 
-GCstarThread::GCstarThread(QObject* obj) : QThread(obj) {
-}
+class FetchResultCacheTest : public QObject {
+Q_OBJECT
 
-void GCstarThread::setProgram(const QString& program_, const QStringList& args_) {
-  m_program = program_;
-  m_args = args_;
-}
+private Q_SLOTS:
+  void initTestCase();
+  void testCache();
+  void testPrune();
+};
 
-void GCstarThread::run() {
-  KProcess proc;
-  connect(&proc, &QProcess::readyReadStandardOutput, this, &GCstarThread::slotData);
-  connect(&proc, &QProcess::readyReadStandardError, this, &GCstarThread::slotError);
-  proc.setOutputChannelMode(KProcess::SeparateChannels);
-  proc.setProgram(m_program, m_args);
-  proc.execute();
-}
-
-void GCstarThread::slotData() {
-  Q_EMIT standardOutput(static_cast<KProcess*>(sender())->readAllStandardOutput());
-}
-
-void GCstarThread::slotError() {
-  Q_EMIT standardError(static_cast<KProcess*>(sender())->readAllStandardError());
-}
+#endif
@@ -39,6 +39,7 @@ void FormatTest::initTestCase() {
   KLocalizedString::setApplicationDomain("tellico");
   Tellico::Config::setArticlesString(QStringLiteral("the,l'"));
   Tellico::Config::setNoCapitalizationString(QStringLiteral("the,of,et,de"));
+  Tellico::FieldFormat::updateFormatRules();
 }
 
 void FormatTest::testCapitalization() {
@@ -175,6 +176,7 @@ void FormatTest::testStripArticles() {
   QFETCH(QString, stripped);
 
   Tellico::Config::setArticlesString(articles);
+  Tellico::FieldFormat::updateFormatRules();
   Tellico::FieldFormat::stripArticles(string);
   QCOMPARE(string, stripped);
 }
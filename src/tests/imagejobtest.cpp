@@ -387,3 +387,28 @@ void ImageJobTest::testFactoryRequestNetworkLinkOnly() {
   QCOMPARE(img.format(), QByteArray("png"));
   QCOMPARE(img.linkOnly(), true);
 }
+
+void ImageJobTest::testFactoryRequestDuplicates() {
+  QSignalSpy spy(Tellico::ImageFactory::self(), &Tellico::ImageFactory::imageRequestFinished);
+
+  // more images than the download limit allows at once, each one requested twice
+  QStringList names;
+  names << QStringLiteral("album") << QStringLiteral("bibtex") << QStringLiteral("boardgame")
+        << QStringLiteral("book") << QStringLiteral("card") << QStringLiteral("checkmark")
+        << QStringLiteral("cite") << QStringLiteral("coin") << QStringLiteral("comic")
+        << QStringLiteral("alexandria") << QStringLiteral("amc") << QStringLiteral("datacrow")
+        << QStringLiteral("collectorz") << QStringLiteral("deliciouslibrary");
+  foreach(const QString& name, names) {
+    QUrl u = QUrl::fromLocalFile(QFINDTESTDATA(QStringLiteral("../../icons/%1.png").arg(name)));
+    Tellico::ImageFactory::requestImageById(u.url());
+    Tellico::ImageFactory::requestImageById(u.url());
+  }
+
+  // every image is loaded exactly once
+  QTRY_COMPARE(spy.count(), names.count());
+  QTest::qWait(200);
+  QCOMPARE(spy.count(), names.count());
+  for(int i = 0; i < spy.count(); ++i) {
+    QVERIFY(spy.at(i).at(1).toBool());
+  }
+}
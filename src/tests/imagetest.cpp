@@ -26,11 +26,15 @@
 
 #include "../images/imagefactory.h"
 #include "../images/image.h"
+#include "../images/imagedirectory.h"
 
 #include <KLocalizedString>
 
 #include <QTest>
 #include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
 
 QTEST_GUILESS_MAIN( ImageTest )
 
@@ -76,3 +80,86 @@ void ImageTest::testOrientation() {
   px = img2.pixel(0, 0);
   QVERIFY(qRed(px) > 250 && qGreen(px) < 5 && qBlue(px) < 5);
 }
+
+void ImageTest::testBatch() {
+  const QDir iconDir(QFINDTESTDATA("../../icons/"));
+  const QStringList files = iconDir.entryList(QStringList() << QStringLiteral("*.png"), QDir::Files);
+  QVERIFY(files.size() > 10);
+
+  QList<Tellico::ImageFactory::ImageData> images;
+  for(const auto& fileName : files) {
+    QFile file(iconDir.filePath(fileName));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    images << Tellico::ImageFactory::ImageData{file.readAll(), QStringLiteral("PNG"), QString()};
+  }
+  // the same data twice just gets added once
+  images << images.first();
+
+  const QStringList ids = Tellico::ImageFactory::addImages(images);
+  QCOMPARE(ids.size(), images.size());
+  QCOMPARE(ids.first(), ids.last());
+  for(const auto& id : ids) {
+    QVERIFY(Tellico::ImageFactory::validImage(id));
+  }
+
+  QTemporaryDir tempDir;
+  QVERIFY(tempDir.isValid());
+  Tellico::ImageDirectory imgDir(QUrl::fromLocalFile(tempDir.path() + QLatin1Char('/')));
+  int progress = 0;
+  const QStringList failed = Tellico::ImageFactory::writeCachedImages(ids, &imgDir, [&progress](int count) {
+    progress = count;
+    return true;
+  });
+  QVERIFY(failed.isEmpty());
+  QCOMPARE(progress, ids.size());
+  for(const auto& id : ids) {
+    QVERIFY(QFile::exists(tempDir.filePath(id)));
+  }
+  const QImage img(tempDir.filePath(ids.first()));
+  QVERIFY(!img.isNull());
+
+  // cancelling stops the progress
+  QTemporaryDir tempDir2;
+  Tellico::ImageDirectory imgDir2(QUrl::fromLocalFile(tempDir2.path() + QLatin1Char('/')));
+  progress = 0;
+  Tellico::ImageFactory::writeCachedImages(ids, &imgDir2, [&progress](int count) {
+    progress = count;
+    return count < 2;
+  });
+  QCOMPARE(progress, 2);
+}
+
+void ImageTest::testBackgroundWrite() {
+  const QDir iconDir(QFINDTESTDATA("../../icons/"));
+  QList<Tellico::ImageFactory::ImageData> images;
+  foreach(const QString& fileName, QStringList() << QStringLiteral("tellico.png")
+                                                 << QStringLiteral("nocover_album.png")) {
+    QFile file(iconDir.filePath(fileName));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    images << Tellico::ImageFactory::ImageData{file.readAll(), QStringLiteral("PNG"), QString()};
+  }
+  const QStringList ids = Tellico::ImageFactory::addImages(images);
+  QCOMPARE(ids.size(), 2);
+
+  bool finished = false;
+  int progress = 0;
+  QStringList failed;
+  Tellico::ImageFactory::requestWriteCachedImages(ids, Tellico::ImageFactory::TempDir, [&progress](int count) {
+    progress = count;
+    return true;
+  }, [&finished, &failed](const QStringList& failed_) {
+    finished = true;
+    failed = failed_;
+  });
+  // the writes happen in the background
+  QVERIFY(!finished);
+  QTRY_VERIFY(finished);
+  QVERIFY(failed.isEmpty());
+  QCOMPARE(progress, ids.size());
+  const QString tempDir = Tellico::ImageFactory::tempDir().toLocalFile();
+  foreach(const QString& id, ids) {
+    QVERIFY(QFile::exists(tempDir + id));
+    // the written images moved from the dict to the cache
+    QVERIFY(Tellico::ImageFactory::self()->hasImageInMemory(id));
+  }
+}
@@ -34,6 +34,8 @@ private Q_SLOTS:
   void initTestCase();
   void testLinkOnly();
   void testOrientation();
+  void testBatch();
+  void testBackgroundWrite();
 };
 
 #endif
@@ -27,6 +27,7 @@
 #include "isbntest.h"
 
 #include "../utils/isbnvalidator.h"
+#include "../fieldformat.h"
 
 #include <QTest>
 
@@ -50,6 +51,26 @@ void IsbnTest::testFixup() {
   QCOMPARE(qs, expectedIsbn);
 }
 
+void IsbnTest::testFixupValues() {
+  QStringList values;
+  values << QL1("9780940016750")
+         << QString()
+         << QL1("0-446-60098")
+         << QL1("0446600989; 9791090636071")
+         << QL1("9999999999");
+  Tellico::ISBNValidator::fixupValues(values);
+  QCOMPARE(values.count(), 5);
+  QCOMPARE(values.at(0), QL1("978-0-940016-75-0"));
+  QVERIFY(values.at(1).isEmpty());
+  QCOMPARE(values.at(2), QL1("0-446-60098-9"));
+  QCOMPARE(values.at(3), QL1("0-446-60098-9") + Tellico::FieldFormat::delimiterString() + QL1("979-10-90636-07-1"));
+
+  // each value matches what the single value fixup gives
+  QString isbn = QL1("9999999999");
+  Tellico::ISBNValidator::staticFixup(isbn);
+  QCOMPARE(values.at(4), isbn);
+}
+
 void IsbnTest::testFixup_data() {
   QTest::addColumn<QString>("string");
   QTest::addColumn<QString>("expectedIsbn");
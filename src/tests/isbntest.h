@@ -34,6 +34,7 @@ private Q_SLOTS:
   void initTestCase();
   void testFixup();
   void testFixup_data();
+  void testFixupValues();
   void testIsbn10();
   void testIsbn10_data();
   void testIsbn13();
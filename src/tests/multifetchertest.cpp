@@ -37,6 +37,7 @@
 #include <KConfigGroup>
 
 #include <QTest>
+#include <QUuid>
 
 QTEST_GUILESS_MAIN( MultiFetcherTest )
 
@@ -102,3 +103,50 @@ void MultiFetcherTest::testIsbn() {
   QCOMPARE(entry->field(QStringLiteral("title")), QStringLiteral("Sound and fury"));
   QCOMPARE(entry->field(QStringLiteral("isbn")), QStringLiteral("0-8014-8639-4"));
 }
+
+void MultiFetcherTest::testMultipleSources() {
+  // the second and third sources update the results at the same time
+  KSharedConfig::Ptr catConfig = KSharedConfig::openConfig(QFINDTESTDATA("data/cat_mods.spec"), KConfig::SimpleConfig);
+  KConfigGroup catConfigGroup = catConfig->group(QStringLiteral("<default>"));
+  catConfigGroup.writeEntry("ExecPath", QFINDTESTDATA("data/cat_mods.sh")); // update command path to local script
+  catConfigGroup.markAsClean(); // don't edit the file on sync()
+
+  auto config = KSharedConfig::openConfig(QString(), KConfig::SimpleConfig);
+  auto fetchManager = Tellico::Fetch::Manager::self();
+  QStringList uuids;
+  for(int i = 0; i < 3; ++i) {
+    KConfigGroup group = config->group(QStringLiteral("source%1").arg(i));
+    catConfigGroup.copyTo(&group);
+    group.writeEntry("Uuid", QUuid::createUuid().toString());
+    Tellico::Fetch::Fetcher::Ptr modsFetcher(new Tellico::Fetch::ExecExternalFetcher(this));
+    modsFetcher->readConfig(group);
+    modsFetcher->setMessageHandler(new Tellico::Fetch::MessageLogger);
+    fetchManager->addFetcher(modsFetcher);
+    uuids << modsFetcher->uuid();
+  }
+  QCOMPARE(uuids.count(), 3);
+  QVERIFY(uuids.at(0) != uuids.at(1));
+
+  auto multiConfig = config->group(QStringLiteral("multi"));
+  multiConfig.writeEntry("Sources", uuids);
+  multiConfig.writeEntry("CollectionType", int(Tellico::Data::Collection::Book));
+  multiConfig.writeEntry("Timeout", 60);
+
+  Tellico::Fetch::FetchRequest isbnRequest(Tellico::Data::Collection::Book,
+                                           Tellico::Fetch::ISBN,
+                                           QStringLiteral("0801486394"));
+  Tellico::Fetch::Fetcher::Ptr multiFetcher(new Tellico::Fetch::MultiFetcher(this));
+  multiFetcher->readConfig(multiConfig);
+  multiFetcher->setMessageHandler(new Tellico::Fetch::MessageLogger);
+
+  Tellico::Data::EntryList results = DO_FETCH(multiFetcher, isbnRequest);
+
+  QCOMPARE(results.size(), 1);
+
+  Tellico::Data::EntryPtr entry = results.at(0);
+  QVERIFY(entry);
+
+  QCOMPARE(entry->field(QStringLiteral("title")), QStringLiteral("Sound and fury"));
+  QCOMPARE(entry->field(QStringLiteral("isbn")), QStringLiteral("0-8014-8639-4"));
+  QVERIFY(!multiFetcher->isSearching());
+}
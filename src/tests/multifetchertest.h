@@ -36,6 +36,7 @@ private Q_SLOTS:
   void initTestCase();
   void testEmpty();
   void testIsbn();
+  void testMultipleSources();
 };
 
 #endif
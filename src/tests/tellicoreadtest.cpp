@@ -32,6 +32,9 @@
 #include "../collections/musiccollection.h"
 #include "../collectionfactory.h"
 #include "../translators/tellicoxmlexporter.h"
+#include "../translators/tellicozipexporter.h"
+#include "../translators/tellicoxmlreader.h"
+#include "../translators/collectionsnapshot.h"
 #include "../translators/tellico_xml.h"
 #include "../translators/xslthandler.h"
 #include "../images/imagefactory.h"
@@ -52,6 +55,8 @@
 #include <QStandardPaths>
 #include <QLoggingCategory>
 #include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QThreadPool>
 
 QTEST_GUILESS_MAIN( TellicoReadTest )
 
@@ -862,3 +867,128 @@ void TellicoReadTest::testSmallFile() {
   Tellico::Data::CollPtr coll = importer.collection();
   QVERIFY(!coll);
 }
+
+void TellicoReadTest::testLargeFile() {
+  // large enough to have the entries read in parallel
+  Tellico::Data::CollPtr coll(new Tellico::Data::BookCollection(true));
+  Tellico::Data::EntryList entries;
+  const QString comments = QString(QLatin1Char('x')).repeated(200);
+  for(int i = 0; i < 20000; ++i) {
+    Tellico::Data::EntryPtr entry(new Tellico::Data::Entry(coll));
+    entry->setField(QSL("title"), QSL("Title %1").arg(i));
+    entry->setField(QSL("author"), QSL("Author %1; Author %2").arg(i).arg(i+1));
+    entry->setField(QSL("comments"), comments);
+    if(i % 100 == 0) {
+      // the isbn gets fixed up when read
+      entry->setField(QSL("isbn"), QSL("0446600989"));
+    }
+    entries << entry;
+  }
+  coll->addEntries(entries);
+  // leave a gap in the ids
+  coll->removeEntries(Tellico::Data::EntryList() << entries.at(100));
+
+  Tellico::Export::TellicoXMLExporter exporter(coll, QUrl());
+  exporter.setEntries(coll->entries());
+  const QString text = exporter.text();
+  QVERIFY(text.size() > 4*1024*1024);
+
+  Tellico::Import::TellicoImporter importer(text);
+  Tellico::Data::CollPtr coll2 = importer.collection();
+  QVERIFY(coll2);
+  QCOMPARE(coll2->entryCount(), coll->entryCount());
+  for(int i = 0; i < coll->entryCount(); ++i) {
+    Tellico::Data::EntryPtr entry1 = coll->entries().at(i);
+    Tellico::Data::EntryPtr entry2 = coll2->entries().at(i);
+    QCOMPARE(entry2->id(), entry1->id());
+    QVERIFY(entry2->collection() == coll2);
+    QCOMPARE(entry2->title(), entry1->title());
+    QCOMPARE(entry2->field(QSL("author")), entry1->field(QSL("author")));
+    if(!entry1->field(QSL("isbn")).isEmpty()) {
+      QCOMPARE(entry2->field(QSL("isbn")), QSL("0-446-60098-9"));
+    }
+  }
+}
+
+void TellicoReadTest::testSnapshot() {
+  // snapshots are off by default
+  QVERIFY(!Tellico::CollectionSnapshot::isEnabled());
+  Tellico::Config::setCollectionSnapshots(true);
+
+  Tellico::Data::CollPtr coll(new Tellico::Data::BookCollection(true));
+  Tellico::Data::EntryList entries;
+  for(int i = 0; i < 100; ++i) {
+    Tellico::Data::EntryPtr entry(new Tellico::Data::Entry(coll));
+    entry->setField(QSL("title"), QSL("Title %1").arg(i));
+    entry->setField(QSL("author"), QSL("Author %1; Author %2").arg(i % 10).arg(i+1));
+    entry->setField(QSL("pub_year"), QSL("19%1").arg(i, 2, 10, QLatin1Char('0')));
+    if(i % 10 == 0) {
+      // the isbn gets fixed up just like it does when the XML is read
+      entry->setField(QSL("isbn"), QSL("0446600989"));
+    }
+    entries << entry;
+  }
+  coll->addEntries(entries);
+  // leave a gap in the ids
+  coll->removeEntries(Tellico::Data::EntryList() << entries.at(10));
+
+  QTemporaryDir dir;
+  const QString fileName = dir.filePath(QSL("snapshot.tc"));
+  const QUrl url = QUrl::fromLocalFile(fileName);
+  Tellico::Export::TellicoZipExporter exporter(coll, QUrl());
+  exporter.setEntries(coll->entries());
+  exporter.setURL(url);
+  exporter.setOptions(exporter.options() | Tellico::Export::ExportForce | Tellico::Export::ExportComplete);
+  QVERIFY(exporter.exec());
+  // the snapshot gets written in the background
+  QThreadPool::globalInstance()->waitForDone();
+
+  Tellico::CollectionSnapshot snapshot(fileName);
+  QVERIFY(QFile::exists(snapshot.snapshotFileName()));
+  Tellico::Import::TellicoXmlReader reader((QUrl()));
+  reader.setLoadImages(false);
+  QVERIFY(snapshot.read(reader));
+  QVERIFY(reader.collection());
+  QCOMPARE(reader.collection()->entryCount(), coll->entryCount());
+  QCOMPARE(reader.collection()->entries().at(0)->field(QSL("isbn")), QSL("0-446-60098-9"));
+
+  Tellico::Import::TellicoImporter importer(url, false);
+  Tellico::Data::CollPtr coll2 = importer.collection();
+  QVERIFY(coll2);
+  QCOMPARE(coll2->entryCount(), coll->entryCount());
+  for(int i = 0; i < coll->entryCount(); ++i) {
+    Tellico::Data::EntryPtr entry1 = coll->entries().at(i);
+    Tellico::Data::EntryPtr entry2 = coll2->entries().at(i);
+    QCOMPARE(entry2->id(), entry1->id());
+    QVERIFY(entry2->collection() == coll2);
+    QCOMPARE(entry2->title(), entry1->title());
+    QCOMPARE(entry2->field(QSL("author")), entry1->field(QSL("author")));
+    QCOMPARE(entry2->field(QSL("pub_year")), entry1->field(QSL("pub_year")));
+    if(!entry1->field(QSL("isbn")).isEmpty()) {
+      QCOMPARE(entry2->field(QSL("isbn")), QSL("0-446-60098-9"));
+    }
+  }
+
+  // save the file again without updating the snapshot, which is then out of date
+  Tellico::Config::setCollectionSnapshots(false);
+  exporter.setEntries(coll->entries().mid(0, 50));
+  QVERIFY(exporter.exec());
+  Tellico::Config::setCollectionSnapshots(true);
+
+  Tellico::Import::TellicoXmlReader reader2((QUrl()));
+  QVERIFY(!snapshot.read(reader2));
+  Tellico::Import::TellicoImporter importer2(url, false);
+  Tellico::Data::CollPtr coll3 = importer2.collection();
+  QVERIFY(coll3);
+  QCOMPARE(coll3->entryCount(), 50);
+
+  // writing a snapshot for another file removes the one which is out of date
+  const QString otherFileName = dir.filePath(QSL("other.tc"));
+  exporter.setURL(QUrl::fromLocalFile(otherFileName));
+  QVERIFY(exporter.exec());
+  QThreadPool::globalInstance()->waitForDone();
+  QVERIFY(QFile::exists(Tellico::CollectionSnapshot(otherFileName).snapshotFileName()));
+  QVERIFY(!QFile::exists(snapshot.snapshotFileName()));
+
+  Tellico::Config::setCollectionSnapshots(false);
+}
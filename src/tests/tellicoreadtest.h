@@ -67,6 +67,8 @@ private Q_SLOTS:
   void testRemote();
   void testImageLocation();
   void testSmallFile();
+  void testLargeFile();
+  void testSnapshot();
 
 private:
   QList<Tellico::Data::CollPtr> m_collections;
@@ -0,0 +1,242 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "undohistorytest.h"
+
+#include "../commands/undohistory.h"
+#include "../commands/entrydeltas.h"
+#include "../commands/sizedcommand.h"
+#include "../collections/bookcollection.h"
+#include "../entry.h"
+
+#include <KLocalizedString>
+
+#include <QTest>
+#include <QStandardPaths>
+#include <QUndoStack>
+#include <QDate>
+
+QTEST_GUILESS_MAIN( UndoHistoryTest )
+
+namespace {
+
+// appends its name to a log when run or undone, and reports a fixed size
+class TestCommand : public QUndoCommand, public Tellico::Command::SizedCommand {
+public:
+  TestCommand(const QString& name_, qsizetype size_, QStringList* log_, int* deleted_)
+      : QUndoCommand(name_), m_size(size_), m_log(log_), m_deleted(deleted_) {}
+  ~TestCommand() { ++*m_deleted; }
+
+  virtual void redo() override { m_log->append(text()); }
+  virtual void undo() override { m_log->append(QLatin1Char('-') + text()); }
+  virtual qsizetype sizeInBytes() const override { return m_size; }
+
+private:
+  qsizetype m_size;
+  QStringList* m_log;
+  int* m_deleted;
+};
+
+}
+
+void UndoHistoryTest::initTestCase() {
+  QStandardPaths::setTestModeEnabled(true);
+  KLocalizedString::setApplicationDomain("tellico");
+}
+
+void UndoHistoryTest::testEntryDeltas() {
+  const QString title(QStringLiteral("title"));
+  const QString cdate(QStringLiteral("cdate"));
+  const QString mdate(QStringLiteral("mdate"));
+  const QString weekAgo = QDate::currentDate().addDays(-7).toString(Qt::ISODate);
+  const QString today = QDate::currentDate().toString(Qt::ISODate);
+
+  Tellico::Data::CollPtr coll(new Tellico::Data::BookCollection(true));
+  Tellico::Data::EntryPtr entry1(new Tellico::Data::Entry(coll));
+  entry1->setField(title, QStringLiteral("Title 1"));
+  entry1->setField(cdate, weekAgo);
+  entry1->setField(mdate, weekAgo, false);
+  Tellico::Data::EntryPtr entry2(new Tellico::Data::Entry(coll));
+  entry2->setField(title, QStringLiteral("Title 2"));
+  coll->addEntries(Tellico::Data::EntryList() << entry1 << entry2);
+
+  Tellico::Data::EntryList oldEntries;
+  oldEntries << entry1->copyWithDates() << entry2->copyWithDates();
+  QCOMPARE(oldEntries.at(0)->field(mdate), weekAgo);
+  // modifying the title updates the modified date, too
+  entry1->setField(title, QStringLiteral("New Title"));
+  QCOMPARE(entry1->field(mdate), today);
+
+  Tellico::Command::EntryDeltas deltas;
+  deltas.compute(coll, oldEntries, Tellico::Data::EntryList() << entry1 << entry2);
+  // the title and the modified date of the first entry, and nothing for the second
+  QCOMPARE(deltas.count(), 2);
+  QVERIFY(deltas.sizeInBytes() > 0);
+
+  const Tellico::Data::EntryList entries = Tellico::Data::EntryList() << entry1 << entry2;
+  deltas.apply(coll, entries, true /* old values */);
+  QCOMPARE(entry1->field(title), QStringLiteral("Title 1"));
+  QCOMPARE(entry1->field(mdate), weekAgo);
+  QCOMPARE(entry1->field(cdate), weekAgo);
+  QCOMPARE(entry2->field(title), QStringLiteral("Title 2"));
+
+  deltas.apply(coll, entries, false /* new values */);
+  QCOMPARE(entry1->field(title), QStringLiteral("New Title"));
+  QCOMPARE(entry1->field(mdate), today);
+  QCOMPARE(entry1->field(cdate), weekAgo);
+
+  deltas.apply(coll, entries, true /* old values */);
+  QCOMPARE(entry1->field(title), QStringLiteral("Title 1"));
+  QCOMPARE(entry1->field(mdate), weekAgo);
+}
+
+void UndoHistoryTest::testEntryDeltasWithoutDates() {
+  const QString title(QStringLiteral("title"));
+  const QString mdate(QStringLiteral("mdate"));
+  const QString weekAgo = QDate::currentDate().addDays(-7).toString(Qt::ISODate);
+
+  Tellico::Data::CollPtr coll(new Tellico::Data::BookCollection(true));
+  Tellico::Data::EntryPtr entry(new Tellico::Data::Entry(coll));
+  entry->setField(title, QStringLiteral("Title 1"));
+  entry->setField(mdate, weekAgo, false);
+  coll->addEntries(entry);
+
+  // a plain copy drops the dates, and undoing must not clear them
+  Tellico::Data::EntryPtr oldEntry(new Tellico::Data::Entry(*entry));
+  QVERIFY(oldEntry->field(mdate).isEmpty());
+  entry->setField(title, QStringLiteral("New Title"));
+
+  Tellico::Command::EntryDeltas deltas;
+  deltas.compute(coll, Tellico::Data::EntryList() << oldEntry, Tellico::Data::EntryList() << entry);
+  QCOMPARE(deltas.count(), 1);
+  deltas.apply(coll, Tellico::Data::EntryList() << entry, true /* old values */);
+  QCOMPARE(entry->field(title), QStringLiteral("Title 1"));
+  QVERIFY(!entry->field(mdate).isEmpty());
+}
+
+void UndoHistoryTest::testGroup() {
+  QStringList log;
+  int deleted = 0;
+  {
+    Tellico::Command::UndoHistory history;
+    history.beginGroup(QStringLiteral("Group"));
+    history.push(new TestCommand(QStringLiteral("A"), 10, &log, &deleted));
+    // nested groups are part of the outer one
+    history.beginGroup(QStringLiteral("Inner"));
+    history.push(new TestCommand(QStringLiteral("B"), 10, &log, &deleted));
+    history.endGroup();
+    // the commands run right away
+    QCOMPARE(log, QStringList() << QStringLiteral("A") << QStringLiteral("B"));
+    QCOMPARE(history.stack()->count(), 0);
+    history.endGroup();
+
+    QCOMPARE(history.stack()->count(), 1);
+    QCOMPARE(history.stack()->undoText(), QStringLiteral("Group"));
+    // pushing the group does not run the commands again
+    QCOMPARE(log.count(), 2);
+    QVERIFY(history.memoryUsed() >= 20);
+
+    log.clear();
+    history.stack()->undo();
+    QCOMPARE(log, QStringList() << QStringLiteral("-B") << QStringLiteral("-A"));
+    log.clear();
+    history.stack()->redo();
+    QCOMPARE(log, QStringList() << QStringLiteral("A") << QStringLiteral("B"));
+
+    // an empty group leaves nothing to undo
+    history.beginGroup(QStringLiteral("Empty"));
+    history.endGroup();
+    QCOMPARE(history.stack()->count(), 1);
+    QCOMPARE(deleted, 0);
+  }
+  QCOMPARE(deleted, 2);
+}
+
+void UndoHistoryTest::testMemoryLimit() {
+  QStringList log;
+  int deleted = 0;
+  Tellico::Command::UndoHistory history;
+  history.setMemoryLimit(1000);
+
+  history.push(new TestCommand(QStringLiteral("A"), 400, &log, &deleted));
+  history.push(new TestCommand(QStringLiteral("B"), 400, &log, &deleted));
+  QCOMPARE(history.stack()->count(), 2);
+  QCOMPARE(history.memoryUsed(), qulonglong(800));
+
+  // the new command is counted, and only the oldest one gets dropped
+  history.push(new TestCommand(QStringLiteral("C"), 400, &log, &deleted));
+  QCOMPARE(history.stack()->count(), 2);
+  QCOMPARE(history.memoryUsed(), qulonglong(800));
+  QCOMPARE(deleted, 1);
+  QCOMPARE(history.stack()->undoText(), QStringLiteral("C"));
+  // the commands which are kept are not run again
+  QCOMPARE(log, QStringList() << QStringLiteral("A") << QStringLiteral("B") << QStringLiteral("C"));
+
+  log.clear();
+  history.stack()->undo();
+  history.stack()->undo();
+  QVERIFY(!history.stack()->canUndo());
+  QCOMPARE(log, QStringList() << QStringLiteral("-C") << QStringLiteral("-B"));
+
+  // commands that can only be redone don't count, and get deleted by the next push
+  history.push(new TestCommand(QStringLiteral("D"), 400, &log, &deleted));
+  QCOMPARE(history.stack()->count(), 1);
+  QCOMPARE(deleted, 3);
+
+  // the newest command is always kept, even when it's too big by itself
+  history.push(new TestCommand(QStringLiteral("E"), 2000, &log, &deleted));
+  QCOMPARE(history.stack()->count(), 1);
+  QCOMPARE(history.stack()->undoText(), QStringLiteral("E"));
+  QCOMPARE(deleted, 4);
+}
+
+void UndoHistoryTest::testMemoryLimitCleanState() {
+  QStringList log;
+  int deleted = 0;
+  Tellico::Command::UndoHistory history;
+  history.setMemoryLimit(1000);
+
+  // the document gets saved after the first command
+  history.push(new TestCommand(QStringLiteral("A"), 400, &log, &deleted));
+  history.stack()->setClean();
+  history.push(new TestCommand(QStringLiteral("B"), 400, &log, &deleted));
+  history.push(new TestCommand(QStringLiteral("C"), 400, &log, &deleted));
+  QCOMPARE(history.stack()->count(), 2);
+  QVERIFY(!history.stack()->isClean());
+  // the saved state is still reachable by undoing the remaining commands
+  history.stack()->undo();
+  history.stack()->undo();
+  QVERIFY(history.stack()->isClean());
+  history.stack()->redo();
+  history.stack()->redo();
+
+  // once the saved state itself is dropped, the stack can't get back to it
+  history.push(new TestCommand(QStringLiteral("D"), 400, &log, &deleted));
+  QCOMPARE(history.stack()->cleanIndex(), -1);
+  QVERIFY(!history.stack()->isClean());
+
+  history.clear();
+  QCOMPARE(history.stack()->count(), 0);
+  QVERIFY(history.stack()->isClean());
+}
@@ -0,0 +1,139 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "z3950connectiontest.h"
+
+#include "../fetch/z3950connection.h"
+#include "../fetch/z3950fetcher.h"
+
+#include <QTest>
+#include <QStandardPaths>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+QTEST_GUILESS_MAIN( Z3950ConnectionTest )
+
+void Z3950ConnectionTest::initTestCase() {
+  QStandardPaths::setTestModeEnabled(true);
+  // yaz-ztest is the test server which comes with yaz
+  const QString ztest = QStandardPaths::findExecutable(QStringLiteral("yaz-ztest"));
+  if(ztest.isEmpty()) {
+    QSKIP("This test requires yaz-ztest", SkipAll);
+  }
+
+  // find a free port for the server
+  {
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    m_port = server.serverPort();
+  }
+  m_server.start(ztest, QStringList() << QStringLiteral("tcp:@:%1").arg(m_port));
+  QVERIFY(m_server.waitForStarted());
+
+  bool listening = false;
+  for(int i = 0; i < 50 && !listening; ++i) {
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, m_port);
+    listening = socket.waitForConnected(100);
+    if(!listening) {
+      QTest::qWait(100);
+    }
+  }
+  QVERIFY2(listening, "yaz-ztest did not start listening");
+}
+
+void Z3950ConnectionTest::cleanupTestCase() {
+  // close the pooled connections before stopping the server
+  Tellico::Fetch::Z3950Connection::setPoolLimits(0, -1);
+  if(m_server.state() != QProcess::NotRunning) {
+    m_server.terminate();
+    m_server.waitForFinished();
+  }
+}
+
+void Z3950ConnectionTest::init() {
+  // every test starts with an empty pool and the default limits
+  Tellico::Fetch::Z3950Connection::setPoolLimits(0, -1);
+  Tellico::Fetch::Z3950Connection::setPoolLimits(-1, -1);
+  QCOMPARE(Tellico::Fetch::Z3950Connection::idleConnectionCount(), 0);
+}
+
+// the pool is keyed by host name, so different names for the local host count as different servers
+bool Z3950ConnectionTest::search(const QString& host_) {
+  const QString db = QStringLiteral("Default");
+  const QString syntax = QStringLiteral("usmarc");
+  Tellico::Fetch::Z3950Fetcher fetcher(this, host_, m_port, db, syntax);
+  Tellico::Fetch::Z3950Connection conn(&fetcher, host_, m_port, db, syntax, QStringLiteral("F"));
+  conn.setQuery(QStringLiteral("@attr 1=4 tellico"));
+  conn.start();
+  return conn.wait(10000);
+}
+
+void Z3950ConnectionTest::testReuse() {
+  QVERIFY(search(QStringLiteral("localhost")));
+  // the connection goes back to the pool when the search is done
+  QCOMPARE(Tellico::Fetch::Z3950Connection::idleConnectionCount(), 1);
+
+  // a second search on the same server takes the pooled connection rather than making another
+  QVERIFY(search(QStringLiteral("localhost")));
+  QCOMPARE(Tellico::Fetch::Z3950Connection::idleConnectionCount(), 1);
+
+  QVERIFY(search(QStringLiteral("127.0.0.1")));
+  QCOMPARE(Tellico::Fetch::Z3950Connection::idleConnectionCount(), 2);
+}
+
+void Z3950ConnectionTest::testEviction() {
+  Tellico::Fetch::Z3950Connection::setPoolLimits(2, -1);
+  QVERIFY(search(QStringLiteral("localhost")));
+  QVERIFY(search(QStringLiteral("127.0.0.1")));
+  QCOMPARE(Tellico::Fetch::Z3950Connection::idleConnectionCount(), 2);
+
+  // the connection which has been idle the longest gets closed
+  QVERIFY(search(QStringLiteral("127.0.0.2")));
+  QCOMPARE(Tellico::Fetch::Z3950Connection::idleConnectionCount(), 2);
+  QVERIFY(search(QStringLiteral("127.0.0.1")));
+  QCOMPARE(Tellico::Fetch::Z3950Connection::idleConnectionCount(), 2);
+
+  // lowering the limit closes connections right away
+  Tellico::Fetch::Z3950Connection::setPoolLimits(1, -1);
+  QCOMPARE(Tellico::Fetch::Z3950Connection::idleConnectionCount(), 1);
+}
+
+void Z3950ConnectionTest::testIdleTimeout() {
+  QVERIFY(search(QStringLiteral("localhost")));
+  QVERIFY(search(QStringLiteral("127.0.0.1")));
+  QCOMPARE(Tellico::Fetch::Z3950Connection::idleConnectionCount(), 2);
+
+  QTest::qWait(50);
+  // connections idle for longer than the timeout are closed
+  Tellico::Fetch::Z3950Connection::setPoolLimits(-1, 20);
+  QCOMPARE(Tellico::Fetch::Z3950Connection::idleConnectionCount(), 0);
+
+  QVERIFY(search(QStringLiteral("localhost")));
+  QCOMPARE(Tellico::Fetch::Z3950Connection::idleConnectionCount(), 1);
+  QTest::qWait(50);
+  // and the expired ones are dropped whenever the pool is used
+  QVERIFY(search(QStringLiteral("127.0.0.1")));
+  QCOMPARE(Tellico::Fetch::Z3950Connection::idleConnectionCount(), 1);
+}
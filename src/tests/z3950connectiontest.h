@@ -1,5 +1,5 @@
 /***************************************************************************
-    Copyright (C) 2010 Robby Stephenson <robby@periapsis.org>
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
  ***************************************************************************/
 
 /***************************************************************************
@@ -22,40 +22,28 @@
  *                                                                         *
  ***************************************************************************/
 
-#ifndef TELLICO_GCSTARTHREAD_H
-#define TELLICO_GCSTARTHREAD_H
+#ifndef Z3950CONNECTIONTEST_H
+#define Z3950CONNECTIONTEST_H
 
-#include <QThread>
-#include <QStringList>
+#include <QObject>
+#include <QProcess>
 
-namespace Tellico {
-  namespace Fetch {
-
-class GCstarThread : public QThread {
+class Z3950ConnectionTest : public QObject {
 Q_OBJECT
 
-public:
-  GCstarThread(QObject* obj);
-
-  void setProgram(const QString& program, const QStringList& args);
-
-protected:
-  virtual void run() override;
-
-public Q_SLOTS:
-  void slotData();
-  void slotError();
-
-Q_SIGNALS:
-  void standardOutput(const QByteArray& data);
-  void standardError(const QByteArray& data);
+private Q_SLOTS:
+  void initTestCase();
+  void cleanupTestCase();
+  void init();
+  void testReuse();
+  void testEviction();
+  void testIdleTimeout();
 
 private:
-  QString m_program;
-  QStringList m_args;
-};
+  bool search(const QString& host);
 
-  }
-}
+  QProcess m_server;
+  quint16 m_port = 0;
+};
 
 #endif
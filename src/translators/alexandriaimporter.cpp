@@ -96,6 +96,10 @@ Tellico::Data::CollPtr AlexandriaImporter::collection() {
   static const QRegularExpression begin(QStringLiteral("^\\s*-\\s+"));
   static const QRegularExpression spaces(QStringLiteral("^ +"));
 
+  // the entries are added all at once, after the isbn values are fixed up together
+  Data::EntryList entries;
+  QStringList isbnValues;
+
   QTextStream ts;
   ts.setEncoding(QStringConverter::Utf8);
   uint j = 0;
@@ -106,6 +110,7 @@ Tellico::Data::CollPtr AlexandriaImporter::collection() {
       continue;
     }
     Data::EntryPtr entry(new Data::Entry(m_coll));
+    QString isbnValue;
 
     bool readNextLine = true;
     ts.setDevice(&file);
@@ -164,9 +169,7 @@ Tellico::Data::CollPtr AlexandriaImporter::collection() {
         entry->setField(year, alexValue);
 
       } else if(alexField == QLatin1StringView("isbn")) {
-        const ISBNValidator val;
-        val.fixup(alexValue);
-        entry->setField(isbn, alexValue);
+        isbnValue = alexValue;
 
         // now find cover image
         alexValue.remove(QLatin1Char('-'));
@@ -210,7 +213,8 @@ Tellico::Data::CollPtr AlexandriaImporter::collection() {
         entry->setField(m_coll->fieldByTitle(alexField), alexValue);
       }
     }
-    m_coll->addEntries(entry);
+    entries += entry;
+    isbnValues += isbnValue;
 
     if(showProgress && j%stepSize == 0) {
       Q_EMIT signalProgress(this, j);
@@ -218,6 +222,14 @@ Tellico::Data::CollPtr AlexandriaImporter::collection() {
     }
   }
 
+  ISBNValidator::fixupValues(isbnValues);
+  for(int i = 0; i < entries.count(); ++i) {
+    if(!isbnValues.at(i).isEmpty()) {
+      entries.at(i)->setField(isbn, isbnValues.at(i));
+    }
+  }
+  m_coll->addEntries(entries);
+
   return m_coll;
 }
 
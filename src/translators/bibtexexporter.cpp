@@ -66,20 +66,58 @@ QString BibtexExporter::fileFilter() const {
 }
 
 bool BibtexExporter::exec() {
-  const QString text = this->text();
-  return text.isEmpty() ? false : FileHandler::writeTextURL(url(), text, options() & ExportUTF8, options() & Export::ExportForce);
+  Citations citations;
+  if(!collectCitations(citations)) {
+    return false;
+  }
+
+  // the entries get formatted on worker threads, so the latex maps have to be loaded first
+  BibtexHandler::initTranslationMaps();
+  bool headerWritten = false;
+  auto nextEntries = formatEntries(citations.snapshot, citations.entries, [this, &citations](const Data::ReadOnlyEntry& entry) {
+    return entryText(citations, entry);
+  });
+  auto nextText = [&citations, &headerWritten, &nextEntries]() -> QString {
+    if(!headerWritten) {
+      headerWritten = true;
+      return citations.header;
+    }
+    return nextEntries();
+  };
+  return FileHandler::writeTextURL(url(), nextText, options() & ExportUTF8, options() & Export::ExportForce);
 }
 
 QString BibtexExporter::text() {
+  Citations citations;
+  if(!collectCitations(citations)) {
+    return QString();
+  }
+
+  QString text = citations.header;
+  foreach(Data::EntryPtr entry, citations.entries) {
+    text += entryText(citations, citations.snapshot.entryById(entry->id()));
+  }
+  return text;
+}
+
+QString BibtexExporter::entryText(const Citations& citations_, const Data::ReadOnlyEntry& entry_) const {
+  QString text;
+  writeEntryText(text, citations_, entry_, citations_.snapshot.field(entry_, citations_.typeField),
+                 citations_.keys.value(entry_.id()));
+  return text;
+}
+
+bool BibtexExporter::collectCitations(Citations& citations_) {
   Data::CollPtr c = collection();
   if(!c || c->type() != Data::Collection::Bibtex) {
-    return QString();
+    return false;
   }
   const Data::BibtexCollection* coll = static_cast<const Data::BibtexCollection*>(c.data());
+  citations_.snapshot = coll->snapshot();
 
 // there are some special attributes
 // the entry-type specifies the entry type - book, inproceedings, whatever
-  QString typeField;
+  QString& typeField = citations_.typeField;
 // the key specifies the cite-key
   QString keyField;
 // the crossref bibtex field can reference another entry
@@ -88,8 +126,8 @@ QString BibtexExporter::text() {
 
   const QString bibtex = QStringLiteral("bibtex");
 // keep a list of all the 'ordinary' fields to iterate through later
-  Data::FieldList fields;
-  foreach(Data::FieldPtr it, this->fields()) {
+  Data::FieldList& fields = citations_.fields;
+  foreach(Data::FieldPtr it, this->fields(citations_.snapshot)) {
     QString bibtexField = it->property(bibtex);
     if(bibtexField == QLatin1String("entry-type")) {
       typeField = it->name();
@@ -107,18 +145,20 @@ QString BibtexExporter::text() {
   if(typeField.isEmpty() || keyField.isEmpty()) {
     myWarning() << "the collection must have fields defining "
                    "the entry-type and the key of the entry";
-    return QString();
+    return false;
   }
   if(fields.isEmpty()) {
     myWarning() << "no bibtex field mapping exists in the collection.";
-    return QString();
+    return false;
   }
 
-  QString text = QLatin1String("@comment{Generated by Tellico ")
-               + QLatin1String(TELLICO_VERSION)
-               + QLatin1String("}\n\n");
+  QString& text = citations_.header;
+  text = QLatin1String("@comment{Generated by Tellico ")
+       + QLatin1String(TELLICO_VERSION)
+       + QLatin1String("}\n\n");
 
   const QStringList macros = coll->macroList().keys();
+  citations_.macros = macros;
 
   if(!coll->preamble().isEmpty()) {
     text += QLatin1String("@preamble{")
@@ -184,7 +224,8 @@ QString BibtexExporter::text() {
     key = newKey;
     usedKeys.add(key);
 
-    writeEntryText(text, fields, *entryIt, type, key);
+    citations_.entries.append(entryIt);
+    citations_.keys.insert(entryIt->id(), key);
   }
 
   // now write out crossrefs
@@ -202,9 +243,10 @@ QString BibtexExporter::text() {
     key = newKey;
     usedKeys.add(key);
 
-    writeEntryText(text, fields, *entryIt, entryIt->field(typeField), key);
+    citations_.entries.append(entryIt);
+    citations_.keys.insert(entryIt->id(), key);
   }
-  return text;
+  return true;
 }
 
 QWidget* BibtexExporter::widget(QWidget* parent_) {
@@ -293,10 +335,10 @@ void BibtexExporter::saveOptions(KSharedConfigPtr config_) {
   }
 }
 
-void BibtexExporter::writeEntryText(QString& text_, const Tellico::Data::FieldList& fields_, const Tellico::Data::Entry& entry_,
-                                    const QString& type_, const QString& key_) {
+void BibtexExporter::writeEntryText(QString& text_, const Citations& citations_, const Tellico::Data::ReadOnlyEntry& entry_,
+                                    const QString& type_, const QString& key_) const {
   static const QRegularExpression numberRx(QStringLiteral("^\\d+$"));
-  const QStringList macros = static_cast<const Data::BibtexCollection*>(collection().data())->macroList().keys();
+  const QStringList& macros = citations_.macros;
   const QString bibtex = QStringLiteral("bibtex");
   const QString bibtexSep = QStringLiteral("bibtex-separator");
 
@@ -307,8 +349,8 @@ void BibtexExporter::writeEntryText(QString& text_, const Tellico::Data::FieldLi
                                                 FieldFormat::ForceFormat :
                                                 FieldFormat::AsIsFormat);
   static const QRegularExpression stripHTML(QStringLiteral("<.*?>"));
-  foreach(Data::FieldPtr fIt, fields_) {
-    value = entry_.formattedField(fIt, format);
+  foreach(Data::FieldPtr fIt, citations_.fields) {
+    value = citations_.snapshot.formattedField(entry_, fIt, format);
     if(value.isEmpty()) {
       continue;
     }
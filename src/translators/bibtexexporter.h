@@ -29,6 +29,9 @@ class QCheckBox;
 class KComboBox;
 
 #include "exporter.h"
+#include "../readonlycollection.h"
+
+#include <QHash>
 
 namespace Tellico {
   namespace Export {
@@ -56,8 +59,24 @@ public:
   virtual void saveOptions(KSharedConfigPtr) override;
 
 private:
-  void writeEntryText(QString& text, const Data::FieldList& field, const Data::Entry& entry,
-                      const QString& type, const QString& key);
+  // everything needed to write the entries, gathered before any of them are formatted
+  struct Citations {
+    // the entries are formatted from the snapshot, so any thread can write them
+    Data::ReadOnlyCollection snapshot;
+    QString header;
+    QString typeField;
+    Data::FieldList fields;
+    QStringList macros;
+    // the entries in the order they are written, with any crossref'd entries last
+    Data::EntryList entries;
+    // the unique citation key for each entry
+    QHash<Data::ID, QString> keys;
+  };
+
+  bool collectCitations(Citations& citations);
+  QString entryText(const Citations& citations, const Data::ReadOnlyEntry& entry) const;
+  void writeEntryText(QString& text, const Citations& citations, const Data::ReadOnlyEntry& entry,
+                      const QString& type, const QString& key) const;
 
   bool m_expandMacros;
   bool m_packageURL;
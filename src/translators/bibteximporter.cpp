@@ -43,6 +43,7 @@
 #include <QButtonGroup>
 #include <QFile>
 #include <QApplication>
+#include <QtConcurrent>
 
 using namespace Tellico;
 using Tellico::Import::BibtexImporter;
@@ -50,6 +51,68 @@ using Tellico::Import::BibtexImporter;
 #ifndef ENABLE_BTPARSE
 void bt_cleanup() {}
 void bt_initialize() {}
+#else
+namespace {
+  // the number of entries converted at a time, between progress updates
+  static const int BIBTEX_BATCH_SIZE = 1000;
+
+  // the values of an entry, pointing into the AST nodes
+  struct RawField {
+    const char* name;
+    QList<QPair<bt_nodetype, const char*>> values;
+  };
+
+  struct RawEntry {
+    const char* type;
+    const char* key;
+    QList<RawField> fields;
+  };
+
+  struct ParsedEntry {
+    QString type;
+    QString key;
+    QList<QPair<QString, QString>> fields;
+  };
+
+  // converting the latex text is the slow part of the import, and this is run on worker threads
+  ParsedEntry parseRawEntry(const RawEntry& raw_) {
+    static const QRegularExpression andRx(QStringLiteral("\\sand\\s"));
+    ParsedEntry entry;
+    // text is automatically put into lower-case by btparse
+    entry.type = QString::fromUtf8(raw_.type);
+    entry.key = QString::fromUtf8(raw_.key);
+    foreach(const RawField& field, raw_.fields) {
+      QString str;
+      bool end_macro = false;
+      foreach(const auto& value, field.values) {
+        switch(value.first) {
+          case BTAST_STRING:
+          case BTAST_NUMBER:
+            str += Tellico::BibtexHandler::importText(const_cast<char*>(value.second)).simplified();
+            end_macro = false;
+            break;
+          case BTAST_MACRO:
+            str += QString::fromUtf8(value.second) + QLatin1Char('#');
+            end_macro = true;
+            break;
+          default:
+            break;
+        }
+      }
+      if(end_macro) {
+        // remove last character '#'
+        str.truncate(str.length() - 1);
+      }
+      const QString fieldName = QString::fromUtf8(field.name);
+      if(fieldName == QLatin1StringView("author") ||
+         fieldName == QLatin1StringView("editor")) {
+        str.replace(andRx, Tellico::FieldFormat::delimiterString());
+      }
+      entry.fields << qMakePair(fieldName, str);
+    }
+    return entry;
+  }
+}
 #endif
 
 int BibtexImporter::s_initCount = 0;
@@ -100,8 +163,7 @@ Tellico::Data::CollPtr BibtexImporter::collection() {
   int count = 0;
   // might be importing text only
   if(!text().isEmpty()) {
-    QString text = this->text();
-    Data::CollPtr coll = readCollection(text, count);
+    Data::CollPtr coll = readCollection(text().toUtf8(), count);
     if(!coll || coll->entryCount() == 0) {
       setStatusMessage(i18n("No valid bibtex entries were found"));
     } else {
@@ -116,11 +178,20 @@ Tellico::Data::CollPtr BibtexImporter::collection() {
     if(!url.isValid()) {
       continue;
     }
-    QString text = FileHandler::readTextFile(url, false, useUTF8);
-    if(text.isEmpty()) {
+    // the parser works on utf-8, so when the file is utf-8, skip decoding it entirely
+    QByteArray data;
+    if(useUTF8) {
+      data = FileHandler::readDataFile(url, false);
+      if(data.startsWith("\xEF\xBB\xBF")) {
+        data.remove(0, 3);
+      }
+    } else {
+      data = FileHandler::readTextFile(url, false, useUTF8).toUtf8();
+    }
+    if(data.isEmpty()) {
       continue;
     }
-    Data::CollPtr coll = readCollection(text, count);
+    Data::CollPtr coll = readCollection(data, count);
     if(!coll || coll->entryCount() == 0) {
       setStatusMessage(i18n("No valid bibtex entries were found in file - %1", this->url().fileName()));
       continue;
@@ -135,16 +206,16 @@ Tellico::Data::CollPtr BibtexImporter::collection() {
   return m_coll;
 }
 
-Tellico::Data::CollPtr BibtexImporter::readCollection(const QString& text, int urlCount) {
+Tellico::Data::CollPtr BibtexImporter::readCollection(QByteArray data, int urlCount) {
 #ifdef ENABLE_BTPARSE
-  if(text.isEmpty()) {
+  if(data.isEmpty()) {
     myDebug() << "no text";
     return Data::CollPtr();
   }
   Data::CollPtr ptr(new Data::BibtexCollection(true));
   Data::BibtexCollection* c = static_cast<Data::BibtexCollection*>(ptr.data());
 
-  parseText(text); // populates m_nodes
+  parseText(data); // populates m_nodes
   if(m_cancelled) {
     return Data::CollPtr();
   }
@@ -153,9 +224,7 @@ Tellico::Data::CollPtr BibtexImporter::readCollection(const QString& text, int u
     return Data::CollPtr();
   }
 
-  QString str;
   const uint count = m_nodes.count();
-  const uint stepSize = qMax(s_stepSize, count/100);
   const bool showProgress = options() & ImportProgress;
 
   Data::CollPtr currentColl = currentCollection();
@@ -163,92 +232,82 @@ Tellico::Data::CollPtr BibtexImporter::readCollection(const QString& text, int u
     currentColl = ptr;
   }
 
-  uint j = 0;
-  for(int i = 0; !m_cancelled && i < m_nodes.count(); ++i, ++j) {
-    AST* node = m_nodes[i];
-    // if we're parsing a macro string, comment or preamble, skip it for now
-    if(bt_entry_metatype(node) == BTE_PREAMBLE) {
-      char* preamble = bt_get_text(node);
-      if(preamble) {
-        c->setPreamble(QString::fromUtf8(preamble));
+  // make sure the translation maps are loaded before the worker threads use them
+  BibtexHandler::importText(const_cast<char*>(""));
+
+  int i = 0;
+  while(!m_cancelled && i < m_nodes.count()) {
+    // walk the nodes in order, collecting the values of the next batch of regular entries
+    QList<RawEntry> rawEntries;
+    for( ; i < m_nodes.count() && rawEntries.count() < BIBTEX_BATCH_SIZE; ++i) {
+      AST* node = m_nodes[i];
+      // if we're parsing a macro string, comment or preamble, skip it for now
+      if(bt_entry_metatype(node) == BTE_PREAMBLE) {
+        char* preamble = bt_get_text(node);
+        if(preamble) {
+          c->setPreamble(QString::fromUtf8(preamble));
+        }
+        continue;
       }
-      continue;
-    }
 
-    if(bt_entry_metatype(node) == BTE_MACRODEF) {
-      char* macro;
-      (void) bt_next_field(node, nullptr, &macro);
-      // FIXME: replace macros within macro definitions!
-      // lookup lowercase macro in map
-      c->addMacro(m_macros[QString::fromUtf8(macro)], QString::fromUtf8(bt_macro_text(macro, nullptr, 0)));
-      continue;
-    }
-
-    if(bt_entry_metatype(node) == BTE_COMMENT) {
-      continue;
-    }
-
-    // now we're parsing a regular entry
-    Data::EntryPtr entry(new Data::Entry(ptr));
-
-    str = QString::fromUtf8(bt_entry_type(node));
-//    myDebug() << "entry type: " << str;
-    // text is automatically put into lower-case by btparse
-    Data::BibtexCollection::setFieldValue(entry, QStringLiteral("entry-type"), str, currentColl);
+      if(bt_entry_metatype(node) == BTE_MACRODEF) {
+        char* macro;
+        (void) bt_next_field(node, nullptr, &macro);
+        // FIXME: replace macros within macro definitions!
+        // lookup lowercase macro in map
+        c->addMacro(m_macros[QString::fromUtf8(macro)], QString::fromUtf8(bt_macro_text(macro, nullptr, 0)));
+        continue;
+      }
 
-    str = QString::fromUtf8(bt_entry_key(node));
-//    myDebug() << "entry key: " << str;
-    Data::BibtexCollection::setFieldValue(entry, QStringLiteral("key"), str, currentColl);
+      if(bt_entry_metatype(node) == BTE_COMMENT) {
+        continue;
+      }
 
-    static const QRegularExpression andRx(QStringLiteral("\\sand\\s"));
-    char* name;
-    AST* field = nullptr;
-    while((field = bt_next_field(node, field, &name))) {
-//      myDebug() << "\tfound: " << name;
-//      str = QLatin1String(bt_get_text(field));
-      str.clear();
-      AST* value = nullptr;
-      bt_nodetype type;
-      char* svalue;
-      bool end_macro = false;
-      while((value = bt_next_value(field, value, &type, &svalue))) {
-        switch(type) {
-          case BTAST_STRING:
-          case BTAST_NUMBER:
-            str += BibtexHandler::importText(svalue).simplified();
-            end_macro = false;
-            break;
-          case BTAST_MACRO:
-            str += QString::fromUtf8(svalue) + QLatin1Char('#');
-            end_macro = true;
-            break;
-          default:
-            break;
+      // now we're parsing a regular entry
+      RawEntry raw;
+      raw.type = bt_entry_type(node);
+      raw.key = bt_entry_key(node);
+      char* name;
+      AST* field = nullptr;
+      while((field = bt_next_field(node, field, &name))) {
+        RawField rawField;
+        rawField.name = name;
+        AST* value = nullptr;
+        bt_nodetype type;
+        char* svalue;
+        while((value = bt_next_value(field, value, &type, &svalue))) {
+          rawField.values << qMakePair(type, static_cast<const char*>(svalue));
         }
+        raw.fields << rawField;
       }
-      if(end_macro) {
-        // remove last character '#'
-        str.truncate(str.length() - 1);
-      }
-      QString fieldName = QString::fromUtf8(name);
-      if(fieldName == QLatin1StringView("author") ||
-         fieldName == QLatin1StringView("editor")) {
-        str.replace(andRx,FieldFormat::delimiterString());
-      }
-      // there's a 'key' field different from the citation key
-      // https://nwalsh.com/tex/texhelp/bibtx-37.html
-      // TODO account for this later
-      if(fieldName == QLatin1StringView("key")) {
-        if(!str.isEmpty()) myLog() << "skipping bibtex 'key' field for" << str;
-      } else {
-        Data::BibtexCollection::setFieldValue(entry, fieldName, str, currentColl);
-      }
+      rawEntries << raw;
     }
 
-    ptr->addEntries(entry);
+    const QList<ParsedEntry> parsedEntries = QtConcurrent::blockingMapped<QList<ParsedEntry>>(rawEntries, parseRawEntry);
+
+    // the collection fields may be added while setting values, so create the entries here
+    Data::EntryList entries;
+    entries.reserve(parsedEntries.count());
+    foreach(const ParsedEntry& parsed, parsedEntries) {
+      Data::EntryPtr entry(new Data::Entry(ptr));
+      Data::BibtexCollection::setFieldValue(entry, QStringLiteral("entry-type"), parsed.type, currentColl);
+      Data::BibtexCollection::setFieldValue(entry, QStringLiteral("key"), parsed.key, currentColl);
+      for(const auto& fieldValue : parsed.fields) {
+        // there's a 'key' field different from the citation key
+        // https://nwalsh.com/tex/texhelp/bibtx-37.html
+        // TODO account for this later
+        if(fieldValue.first == QLatin1StringView("key")) {
+          if(!fieldValue.second.isEmpty()) myLog() << "skipping bibtex 'key' field for" << fieldValue.second;
+        } else {
+          Data::BibtexCollection::setFieldValue(entry, fieldValue.first, fieldValue.second, currentColl);
+        }
+      }
+      entries << entry;
+    }
+    ptr->addEntries(entries);
 
-    if(showProgress && j%stepSize == 0) {
-      Q_EMIT signalProgress(this, urlCount*100 + 100*j/count);
+    if(showProgress) {
+      Q_EMIT signalProgress(this, urlCount*100 + 100*i/count);
       qApp->processEvents();
     }
   }
@@ -264,11 +323,13 @@ Tellico::Data::CollPtr BibtexImporter::readCollection(const QString& text, int u
 
   return ptr;
 #else
+  Q_UNUSED(data);
+  Q_UNUSED(urlCount);
   return Data::CollPtr();
 #endif // ENABLE_BTPARSE
 }
 
-void BibtexImporter::parseText(const QString& text) {
+void BibtexImporter::parseText(QByteArray& data) {
 #ifdef ENABLE_BTPARSE
   m_nodes.clear();
   m_macros.clear();
@@ -281,51 +342,68 @@ void BibtexImporter::parseText(const QString& text) {
   bt_set_stringopts(BTE_MACRODEF, 0);
 //  bt_set_stringopts(BTE_PREAMBLE, BTO_CONVERT | BTO_EXPAND);
 
-  QString entry;
-  static const QRegularExpression rx(QStringLiteral("[{}]"));
   static const QRegularExpression macroName(QStringLiteral("@string\\s*\\{\\s*(.*?)="),
                                             QRegularExpression::CaseInsensitiveOption);
 
+  QByteArray filename = QFile::encodeName(url().fileName());
+  // the entries are terminated in place, rather than copying each one
+  char* buffer = data.data();
+  const qsizetype size = data.size();
+
   int line = 1;
+  int newlines = 0;
   bool needsCleanup = false;
   int brace = 0;
-  int startpos = 0;
-  QRegularExpressionMatch m = rx.match(text);
-  int pos = m.capturedStart();
-  while(pos > 0 && !m_cancelled) {
-    if(text[pos] == QLatin1Char('{')) {
+  qsizetype startpos = 0;
+  // a single pass over the bytes, matching braces and counting lines
+  for(qsizetype pos = 0; pos < size && !m_cancelled; ++pos) {
+    const char ch = buffer[pos];
+    if(ch == '{') {
       ++brace;
-    } else if(text[pos] == QLatin1Char('}') && brace > 0) {
-      --brace;
+    } else if(ch == '}') {
+      if(brace > 0) {
+        --brace;
+      }
+    } else {
+      if(ch == '\n') {
+        ++newlines;
+      }
+      continue;
     }
-    if(brace == 0) {
-      entry = text.mid(startpos, pos-startpos+1);
-      // All the downstream text processing on the AST node will assume utf-8
-      QByteArray entryText = entry.toUtf8();
-      QByteArray filename = QFile::encodeName(url().fileName());
-      AST* node = bt_parse_entry_s(entryText.data(),
-                                   filename.data(),
-                                   line, bt_options, &ok);
-      if(ok && node) {
+    if(brace > 0) {
+      continue;
+    }
+    // the byte array is always null-terminated, so pos+1 is valid
+    const char next = buffer[pos+1];
+    buffer[pos+1] = '\0';
+    AST* node = bt_parse_entry_s(buffer + startpos,
+                                 filename.data(),
+                                 line, bt_options, &ok);
+    if(ok && node) {
+      if(bt_entry_metatype(node) == BTE_MACRODEF) {
+        // only need to decode the text of macro definitions, to keep the case of the name
+        const QString entry = QString::fromUtf8(buffer + startpos, pos-startpos+1);
         QRegularExpressionMatch macroMatch = macroName.match(entry);
-        if(bt_entry_metatype(node) == BTE_MACRODEF && macroMatch.hasMatch()) {
+        if(macroMatch.hasMatch()) {
           char* macro;
           (void) bt_next_field(node, nullptr, &macro);
           m_macros.insert(QString::fromUtf8(macro), macroMatch.captured(1).trimmed());
         }
-        m_nodes.append(node);
-        needsCleanup = true;
       }
-      startpos = pos+1;
-      line += entry.count(QLatin1Char('\n'));
+      m_nodes.append(node);
+      needsCleanup = true;
     }
-    m = rx.match(text, pos+1);
-    pos = m.capturedStart();
+    buffer[pos+1] = next;
+    startpos = pos+1;
+    line += newlines;
+    newlines = 0;
   }
   if(needsCleanup) {
     // clean up some structures
     bt_parse_entry_s(nullptr, nullptr, 1, 0, nullptr);
   }
+#else
+  Q_UNUSED(data);
 #endif // ENABLE_BTPARSE
 }
 
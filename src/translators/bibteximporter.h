@@ -53,6 +53,7 @@ class AST;
 
 #include <QList>
 #include <QHash>
+#include <QByteArray>
 
 class QRadioButton;
 
@@ -99,8 +100,9 @@ public Q_SLOTS:
 
 private:
   void init();
-  Data::CollPtr readCollection(const QString& text, int n);
-  void parseText(const QString& text);
+  // the data must be utf-8
+  Data::CollPtr readCollection(QByteArray data, int n);
+  void parseText(QByteArray& data);
   void appendCollection(Data::CollPtr newColl);
 
   QList<AST*> m_nodes;
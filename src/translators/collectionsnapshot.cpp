@@ -0,0 +1,296 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "collectionsnapshot.h"
+#include "tellicoxmlreader.h"
+#include "tellico_xml.h"
+#include "../collection.h"
+#include "../entry.h"
+#include "../config/tellico_config.h"
+#include "../tellico_debug.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QCryptographicHash>
+#include <QStandardPaths>
+#include <QHash>
+#include <QUrl>
+
+namespace {
+  static const quint32 SNAPSHOT_MAGIC = 0x54435353; // "TCSS"
+  // increment whenever the layout changes, older snapshots just get ignored
+  static const quint32 SNAPSHOT_VERSION = 2;
+  static const QDataStream::Version SNAPSHOT_STREAM_VERSION = QDataStream::Qt_6_0;
+}
+
+using Tellico::CollectionSnapshot;
+
+CollectionSnapshot::CollectionSnapshot(const QString& fileName_) : m_fileName(fileName_) {
+  const QByteArray key = QFileInfo(fileName_).absoluteFilePath().toUtf8();
+  m_snapshotFileName = QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+                     + QLatin1String("/snapshots/")
+                     + QString::fromLatin1(QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex())
+                     + QLatin1String(".snapshot");
+}
+
+bool CollectionSnapshot::isEnabled() {
+  return Config::collectionSnapshots();
+}
+
+void CollectionSnapshot::remove() const {
+  QFile::remove(m_snapshotFileName);
+}
+
+// The snapshot file is a small header followed by the payload:
+//   magic, version, file path, file size, file modification time, file hash, payload hash
+// The payload holds the XML before the first entry and after the last entry, the field names,
+// a table of the distinct values, and then for each entry its id and the (field, value) index pairs.
+bool CollectionSnapshot::write(const QByteArray& fileData_, const QByteArray& xml_) const {
+  qsizetype begin, end;
+  if(!XML::findEntryRange(xml_, begin, end)) {
+    remove();
+    return false;
+  }
+
+  // read the entries just as the importer does, so the values are exactly the same
+  Import::TellicoXmlReader reader((QUrl()));
+  reader.setLoadImages(false);
+  if(!reader.readNext(QByteArray::fromRawData(xml_.constData(), begin)) ||
+     !reader.readNext(QByteArray::fromRawData(xml_.constData() + begin, end - begin)) ||
+     !reader.collection()) {
+    myDebug() << "Unable to read the entries for the snapshot";
+    remove();
+    return false;
+  }
+  // the collection element is never closed, so the ISBN values need to be fixed up here
+  reader.fixupISBNValues();
+
+  Data::FieldList fields;
+  QStringList fieldNames;
+  foreach(Data::FieldPtr field, reader.collection()->fields()) {
+    // derived values are never stored in the entry
+    if(!field->hasFlag(Data::Field::Derived)) {
+      fields << field;
+      fieldNames << field->name();
+    }
+  }
+
+  // entry values repeat a lot, each distinct value is only stored once
+  QStringList values;
+  QHash<QString, quint32> valueIndex;
+  QByteArray entryData;
+  QDataStream entryStream(&entryData, QIODevice::WriteOnly);
+  entryStream.setVersion(SNAPSHOT_STREAM_VERSION);
+  const Data::EntryList entries = reader.entries();
+  foreach(Data::EntryPtr entry, entries) {
+    QList<QPair<quint32, quint32>> pairs;
+    for(int i = 0; i < fields.size(); ++i) {
+      const QString value = entry->field(fields.at(i));
+      if(value.isEmpty()) {
+        continue;
+      }
+      auto it = valueIndex.constFind(value);
+      if(it == valueIndex.constEnd()) {
+        it = valueIndex.insert(value, values.size());
+        values << value;
+      }
+      pairs << qMakePair(quint32(i), it.value());
+    }
+    entryStream << qint32(entry->id()) << quint32(pairs.size());
+    for(const auto& pair : std::as_const(pairs)) {
+      entryStream << pair.first << pair.second;
+    }
+  }
+
+  QByteArray payload;
+  QDataStream payloadStream(&payload, QIODevice::WriteOnly);
+  payloadStream.setVersion(SNAPSHOT_STREAM_VERSION);
+  payloadStream << QByteArray::fromRawData(xml_.constData(), begin)
+                << QByteArray::fromRawData(xml_.constData() + end, xml_.size() - end)
+                << fieldNames << values << quint32(entries.size());
+  payloadStream.writeRawData(entryData.constData(), entryData.size());
+
+  // the file may have been saved again already
+  const QFileInfo info(m_fileName);
+  if(info.size() != fileData_.size()) {
+    return false;
+  }
+
+  if(!QDir().mkpath(QFileInfo(m_snapshotFileName).absolutePath())) {
+    myDebug() << "Unable to create the snapshot directory";
+    return false;
+  }
+  removeStaleSnapshots();
+  QSaveFile file(m_snapshotFileName);
+  if(!file.open(QIODevice::WriteOnly)) {
+    myDebug() << "Unable to write" << m_snapshotFileName;
+    return false;
+  }
+  QDataStream stream(&file);
+  stream.setVersion(SNAPSHOT_STREAM_VERSION);
+  stream << SNAPSHOT_MAGIC << SNAPSHOT_VERSION << info.absoluteFilePath()
+         << qint64(info.size()) << qint64(info.lastModified().toMSecsSinceEpoch())
+         << QCryptographicHash::hash(fileData_, QCryptographicHash::Sha1)
+         << QCryptographicHash::hash(payload, QCryptographicHash::Sha1);
+  stream.writeRawData(payload.constData(), payload.size());
+  return stream.status() == QDataStream::Ok && file.commit();
+}
+
+bool CollectionSnapshot::read(Import::TellicoXmlReader& reader_) const {
+  const QFileInfo info(m_fileName);
+  QFile file(m_snapshotFileName);
+  if(!info.exists() || !file.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+  // the snapshot is mapped rather than read, only the values get copied out of it
+  QByteArray bytes;
+  const uchar* map = file.map(0, file.size());
+  if(map) {
+    bytes = QByteArray::fromRawData(reinterpret_cast<const char*>(map), file.size());
+  } else {
+    bytes = file.readAll();
+  }
+
+  QDataStream stream(bytes);
+  stream.setVersion(SNAPSHOT_STREAM_VERSION);
+  quint32 magic, version;
+  QString path;
+  qint64 size, mtime;
+  QByteArray fileHash, payloadHash;
+  stream >> magic >> version;
+  if(stream.status() != QDataStream::Ok || magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION) {
+    return false;
+  }
+  stream >> path >> size >> mtime >> fileHash >> payloadHash;
+  // cheap checks first
+  if(stream.status() != QDataStream::Ok || path != info.absoluteFilePath() ||
+     size != info.size() || mtime != info.lastModified().toMSecsSinceEpoch()) {
+    myLog() << "Snapshot is out of date for" << m_fileName;
+    return false;
+  }
+  const qsizetype offset = stream.device()->pos();
+  const QByteArray payload = QByteArray::fromRawData(bytes.constData() + offset, bytes.size() - offset);
+  if(QCryptographicHash::hash(payload, QCryptographicHash::Sha1) != payloadHash) {
+    myDebug() << "Snapshot is corrupted:" << m_snapshotFileName;
+    return false;
+  }
+  // the modification time might not have changed if the file was rewritten quickly
+  QFile source(m_fileName);
+  QCryptographicHash sourceHash(QCryptographicHash::Sha1);
+  if(!source.open(QIODevice::ReadOnly) || !sourceHash.addData(&source) || sourceHash.result() != fileHash) {
+    myLog() << "Snapshot does not match" << m_fileName;
+    return false;
+  }
+
+  QDataStream payloadStream(payload);
+  payloadStream.setVersion(SNAPSHOT_STREAM_VERSION);
+  QByteArray head, tail;
+  QStringList fieldNames, values;
+  quint32 entryCount;
+  payloadStream >> head >> tail >> fieldNames >> values >> entryCount;
+  if(payloadStream.status() != QDataStream::Ok) {
+    return false;
+  }
+
+  // the header creates the collection and its fields
+  if(!reader_.readNext(head) || !reader_.collection()) {
+    return false;
+  }
+  Data::CollPtr coll = reader_.collection();
+  Data::FieldList fields;
+  foreach(const QString& fieldName, fieldNames) {
+    Data::FieldPtr field = coll->fieldByName(fieldName);
+    if(!field) {
+      return false;
+    }
+    fields << field;
+  }
+
+  Data::EntryList entries;
+  entries.reserve(entryCount);
+  for(quint32 i = 0; i < entryCount; ++i) {
+    qint32 id;
+    quint32 valueCount;
+    payloadStream >> id >> valueCount;
+    if(payloadStream.status() != QDataStream::Ok) {
+      return false;
+    }
+    Data::EntryPtr entry(new Data::Entry(coll, id));
+    for(quint32 j = 0; j < valueCount; ++j) {
+      quint32 fieldPos, valuePos;
+      payloadStream >> fieldPos >> valuePos;
+      if(fieldPos >= quint32(fields.size()) || valuePos >= quint32(values.size())) {
+        return false;
+      }
+      // the values were read by the importer when the snapshot was written, so they
+      // don't need to be checked again, and the entry isn't in the collection yet
+      entry->setCheckedField(fields.at(fieldPos), values.at(valuePos));
+    }
+    entries << entry;
+  }
+  if(payloadStream.status() != QDataStream::Ok) {
+    return false;
+  }
+
+  reader_.addEntries(entries);
+  // the rest of the document includes the image info and closes the collection
+  return reader_.readNext(tail);
+}
+
+// a snapshot is stale once its file is gone or has been saved again without a new snapshot
+void CollectionSnapshot::removeStaleSnapshots() const {
+  const QDir dir(QFileInfo(m_snapshotFileName).absolutePath());
+  const QStringList snapshots = dir.entryList(QStringList() << QStringLiteral("*.snapshot"), QDir::Files);
+  foreach(const QString& snapshotName, snapshots) {
+    const QString snapshotFileName = dir.absoluteFilePath(snapshotName);
+    if(snapshotFileName == m_snapshotFileName) {
+      continue;
+    }
+    QFile file(snapshotFileName);
+    if(!file.open(QIODevice::ReadOnly)) {
+      continue;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(SNAPSHOT_STREAM_VERSION);
+    quint32 magic = 0, version = 0;
+    QString path;
+    qint64 size = -1, mtime = -1;
+    stream >> magic >> version;
+    if(stream.status() == QDataStream::Ok && magic == SNAPSHOT_MAGIC && version == SNAPSHOT_VERSION) {
+      stream >> path >> size >> mtime;
+    }
+    file.close();
+    const QFileInfo info(path);
+    if(path.isEmpty() || !info.exists() ||
+       size != info.size() || mtime != info.lastModified().toMSecsSinceEpoch()) {
+      myLog() << "Removing stale snapshot" << snapshotName;
+      QFile::remove(snapshotFileName);
+    }
+  }
+}
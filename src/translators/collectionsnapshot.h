@@ -0,0 +1,84 @@
+/***************************************************************************
+    Copyright (C) 2026 Robby Stephenson <robby@periapsis.org>
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation; either version 2 of        *
+ *   the License or (at your option) version 3 or any later version        *
+ *   accepted by the membership of KDE e.V. (or its successor approved     *
+ *   by the membership of KDE e.V.), which shall act as a proxy            *
+ *   defined in Section 14 of version 3 of the license.                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef TELLICO_COLLECTIONSNAPSHOT_H
+#define TELLICO_COLLECTIONSNAPSHOT_H
+
+#include <QString>
+
+namespace Tellico {
+  namespace Import {
+    class TellicoXmlReader;
+  }
+
+/**
+ * A binary copy of the entries in a Tellico zip file, kept in the cache directory.
+ *
+ * Reading the entry elements is most of the time spent opening a large file. The snapshot
+ * holds the entry values in a compact form, along with the rest of the XML document as-is,
+ * so the file can be opened again without parsing the entries. The snapshot is only used
+ * when the size, modification time, and hash of the file all match. Snapshots are off
+ * unless the hidden "Collection Snapshots" option is set.
+ *
+ * @author Robby Stephenson
+ */
+class CollectionSnapshot {
+public:
+  /**
+   * @param fileName The local Tellico file
+   */
+  explicit CollectionSnapshot(const QString& fileName);
+
+  /**
+   * Writes the snapshot for the file. The entries are read from the XML just as the
+   * importer would read them, so the snapshot holds the same values.
+   *
+   * @param fileData The data which was written to the file
+   * @param xml The XML document inside the file
+   * @return Whether the snapshot was written
+   */
+  bool write(const QByteArray& fileData, const QByteArray& xml) const;
+  /**
+   * Feeds the snapshot to an XML reader, which has not read anything yet. If the reader
+   * was not able to read the whole snapshot, it should be discarded.
+   *
+   * @return Whether the snapshot matched the file and was read completely
+   */
+  bool read(Import::TellicoXmlReader& reader) const;
+  void remove() const;
+
+  const QString& snapshotFileName() const { return m_snapshotFileName; }
+
+  static bool isEnabled();
+
+private:
+  void removeStaleSnapshots() const;
+
+  QString m_fileName;
+  QString m_snapshotFileName;
+};
+
+} // end namespace
+#endif
@@ -24,6 +24,7 @@
 
 #include "csvexporter.h"
 #include "../collection.h"
+#include "../readonlycollection.h"
 #include "../core/filehandler.h"
 
 #include <KLocalizedString>
@@ -84,26 +85,55 @@ bool CSVExporter::exec() {
     return false;
   }
 
-  return FileHandler::writeTextURL(url(), text(), options() & ExportUTF8, options() & Export::ExportForce);
+  // the header is written first, then the entries as they get formatted
+  bool headerWritten = !m_includeTitles;
+  const Data::ReadOnlyCollection snapshot = collection()->snapshot();
+  const Data::FieldList fields = this->fields(snapshot);
+  auto nextEntries = formatEntries(snapshot, entries(), [this, snapshot, fields](const Data::ReadOnlyEntry& entry) {
+    return entryText(snapshot, fields, entry);
+  });
+  auto nextText = [this, &headerWritten, &nextEntries]() -> QString {
+    if(!headerWritten) {
+      headerWritten = true;
+      return headerText();
+    }
+    return nextEntries();
+  };
+  return FileHandler::writeTextURL(url(), nextText, options() & ExportUTF8, options() & Export::ExportForce);
 }
 
 QString CSVExporter::text() const {
+  QString text = headerText();
+  const Data::ReadOnlyCollection snapshot = collection()->snapshot();
+  const Data::FieldList fields = this->fields(snapshot);
+  foreach(Data::EntryPtr entryIt, entries()) {
+    text += entryText(snapshot, fields, snapshot.entryById(entryIt->id()));
+  }
+  return text;
+}
+
+QString CSVExporter::headerText() const {
   QString text;
+  if(!m_includeTitles) {
+    return text;
+  }
 
-  if(m_includeTitles) {
-    foreach(Data::FieldPtr fIt, fields()) {
-      QString title = fIt->title();
-      // because of Microsoft Excel bug, https://support.microsoft.com/kb/323626
-      if(text.isEmpty() && title == QLatin1String("ID")) {
-        title = QStringLiteral("Id");
-      }
-      text += escapeText(title) + m_delimiter;
+  foreach(Data::FieldPtr fIt, fields()) {
+    QString title = fIt->title();
+    // because of Microsoft Excel bug, https://support.microsoft.com/kb/323626
+    if(text.isEmpty() && title == QLatin1String("ID")) {
+      title = QStringLiteral("Id");
     }
-    // remove last delimiter
-    text.truncate(text.length() - m_delimiter.length());
-    text += QLatin1Char('\n');
+    text += escapeText(title) + m_delimiter;
   }
+  // remove last delimiter
+  text.truncate(text.length() - m_delimiter.length());
+  text += QLatin1Char('\n');
+  return text;
+}
 
+QString CSVExporter::entryText(const Data::ReadOnlyCollection& snapshot_, const Data::FieldList& fields_,
+                               const Data::ReadOnlyEntry& entry_) const {
   FieldFormat::Request format = (options() & Export::ExportFormatted ?
                                                 FieldFormat::ForceFormat :
                                                 FieldFormat::AsIsFormat);
@@ -111,21 +141,18 @@ QString CSVExporter::text() const {
   const bool replaceColDelimiter = (m_colDelimiter != FieldFormat::columnDelimiterString());
   const bool replaceRowDelimiter = (m_rowDelimiter != FieldFormat::rowDelimiterString());
 
-  foreach(Data::EntryPtr entryIt, entries()) {
-    QStringList values;
-    foreach(Data::FieldPtr fIt, fields()) {
-      QString value = entryIt->formattedField(fIt, format);
-      if(replaceColDelimiter) {
-        value.replace(FieldFormat::columnDelimiterString(), m_colDelimiter);
-      }
-      if(replaceRowDelimiter) {
-        value.replace(FieldFormat::rowDelimiterString(), m_rowDelimiter);
-      }
-      values += escapeText(value);
+  QStringList values;
+  foreach(Data::FieldPtr fIt, fields_) {
+    QString value = snapshot_.formattedField(entry_, fIt, format);
+    if(replaceColDelimiter) {
+      value.replace(FieldFormat::columnDelimiterString(), m_colDelimiter);
+    }
+    if(replaceRowDelimiter) {
+      value.replace(FieldFormat::rowDelimiterString(), m_rowDelimiter);
     }
-    text += values.join(m_delimiter) + QLatin1Char('\n');
+    values += escapeText(value);
   }
-  return text;
+  return values.join(m_delimiter) + QLatin1Char('\n');
 }
 
 QWidget* CSVExporter::widget(QWidget* parent_) {
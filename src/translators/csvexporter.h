@@ -54,6 +54,9 @@ public:
   virtual void saveOptions(KSharedConfigPtr config) override;
 
 private:
+  QString headerText() const;
+  QString entryText(const Data::ReadOnlyCollection& snapshot, const Data::FieldList& fields,
+                    const Data::ReadOnlyEntry& entry) const;
   QString& escapeText(QString& text) const;
 
   bool m_includeTitles;
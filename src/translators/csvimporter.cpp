@@ -31,6 +31,7 @@
 #include "../collectionfactory.h"
 #include "../gui/collectiontypecombo.h"
 #include "../utils/stringset.h"
+#include "../utils/string_utils.h"
 #include "../images/imagefactory.h"
 
 #include <KComboBox>
@@ -54,10 +55,41 @@
 #include <QHBoxLayout>
 #include <QButtonGroup>
 #include <QApplication>
+#include <QTextStream>
+
+namespace {
+  // entries are added to the collection in batches rather than one at a time
+  static const int CSV_IMPORT_BATCH_SIZE = 500;
+
+  // how each imported column is handled, resolved once rather than for every value
+  struct ColumnPlan {
+    int column;
+    Tellico::Data::FieldPtr field;
+    bool isTable;
+    bool isImage;
+    bool isDate;
+    bool isChoice;
+    // LibraryThing special cases
+    bool stripBrackets;
+    bool splitCommas;
+    bool dateOnly;
+  };
+
+  // legal control codes in XML 1.0 are U+0009, U+000A, U+000D
+  bool hasControlCodes(const QString& value_) {
+    for(const QChar c : value_) {
+      const ushort u = c.unicode();
+      if(u < 0x20 && u != 0x9 && u != 0xA && u != 0xD) {
+        return true;
+      }
+    }
+    return false;
+  }
+}
 
 using Tellico::Import::CSVImporter;
 
-CSVImporter::CSVImporter(const QUrl& url_) : Tellico::Import::TextImporter(url_),
+CSVImporter::CSVImporter(const QUrl& url_) : Tellico::Import::TextImporter(url_, false /* useUTF8 */, false /* readText */),
     m_collType(-1),
     m_existingCollection(nullptr),
     m_firstRowHeader(false),
@@ -80,13 +112,17 @@ CSVImporter::CSVImporter(const QUrl& url_) : Tellico::Import::TextImporter(url_)
     m_hasAssignedFields(false),
     m_isLibraryThing(false),
     m_imageLinksOnly(false),
-    m_parser(new CSVParser(text())) {
+    m_parser(new CSVParser(QString())),
+    m_fileRef(nullptr),
+    m_dataOffset(0) {
   m_parser->setDelimiter(m_delimiter);
 }
 
 CSVImporter::~CSVImporter() {
   delete m_parser;
   m_parser = nullptr;
+  delete m_fileRef;
+  m_fileRef = nullptr;
 }
 
 Tellico::Data::CollPtr CSVImporter::collection() {
@@ -115,59 +151,77 @@ Tellico::Data::CollPtr CSVImporter::collection() {
     return Data::CollPtr();
   }
 
-  m_parser->reset(text());
+  resetParser();
 
   // if the first row are headers, skip it
   if(m_firstRowHeader) {
     m_parser->skipLine();
   }
 
-  const uint numChars = text().size();
-  const uint stepSize = qMax(s_stepSize, numChars/100);
+  const qint64 numBytes = qMax(qint64(1), m_parser->size());
   const bool showProgress = options() & ImportProgress;
 
   // do we need to replace column or row delimiters
   const bool replaceColDelimiter = (!m_colDelimiter.isEmpty() && m_colDelimiter != FieldFormat::columnDelimiterString());
   const bool replaceRowDelimiter = (!m_rowDelimiter.isEmpty() && m_rowDelimiter != FieldFormat::rowDelimiterString());
+  // text read from a file has already had the control codes removed
+  const bool checkControlCodes = text().isEmpty();
+
+  QList<ColumnPlan> plans;
+  plans.reserve(m_fieldsToImport.size());
+  for(int i = 0; i < m_fieldsToImport.size(); ++i) {
+    const QString& fieldName = m_fieldsToImport.at(i);
+    Data::FieldPtr field = m_coll->fieldByName(fieldName);
+    if(!field) {
+      myDebug() << "No field in collection named" << fieldName;
+      continue;
+    }
+    ColumnPlan plan;
+    plan.column = m_columnsToImport.at(i);
+    plan.field = field;
+    // only replace delimiters for tables
+    // see https://forum.kde.org/viewtopic.php?f=200&t=142712
+    plan.isTable = field->type() == Data::Field::Table;
+    plan.isImage = field->type() == Data::Field::Image;
+    plan.isDate = field->type() == Data::Field::Date || field->formatType() == FieldFormat::FormatDate;
+    plan.isChoice = field->type() == Data::Field::Choice;
+    // ISBN values are enclosed by brackets
+    plan.stripBrackets = m_isLibraryThing && fieldName == QLatin1String("isbn");
+    // LT values are comma-separated
+    plan.splitCommas = m_isLibraryThing && fieldName == QLatin1String("keyword");
+    // only want date, not time. 10 characters since it's zero-padded
+    plan.dateOnly = m_isLibraryThing && fieldName == QLatin1String("cdate");
+    plans += plan;
+  }
 
-  uint j = 0;
+  Data::EntryList batch;
+  batch.reserve(CSV_IMPORT_BATCH_SIZE);
   while(!m_cancelled && m_parser->hasNext()) {
     bool empty = true;
     Data::EntryPtr entry(new Data::Entry(m_coll));
-    QStringList values = m_parser->nextTokens();
-    for(int i = 0; i < m_fieldsToImport.size(); ++i) {
-      if(m_columnsToImport.at(i) >= values.size()) {
+    const QStringList values = m_parser->nextTokens();
+    foreach(const ColumnPlan& plan, plans) {
+      if(plan.column >= values.size()) {
         break;
       }
-      const QString currentFieldName = m_fieldsToImport.at(i);
-      if(!m_coll->hasField(currentFieldName)) {
-        myDebug() << "No field in collection named" << currentFieldName;
-        continue;
+      QString value = values.at(plan.column).trimmed();
+      if(checkControlCodes && hasControlCodes(value)) {
+        value = Tellico::removeControlCodes(value);
       }
-      QString value = values[m_columnsToImport.at(i)].trimmed();
-      const auto fieldType = m_coll->fieldByName(currentFieldName)->type();
-      // only replace delimiters for tables
-      // see https://forum.kde.org/viewtopic.php?f=200&t=142712
-      if(replaceColDelimiter && fieldType == Data::Field::Table) {
+      if(replaceColDelimiter && plan.isTable) {
         value.replace(m_colDelimiter, FieldFormat::columnDelimiterString());
       }
-      if(replaceRowDelimiter && fieldType == Data::Field::Table) {
+      if(replaceRowDelimiter && plan.isTable) {
         value.replace(m_rowDelimiter, FieldFormat::rowDelimiterString());
       }
-      if(m_isLibraryThing) {
-        // special cases for LibraryThing import
-        if(currentFieldName == QLatin1String("isbn")) {
-          // ISBN values are enclosed by brackets
-          value.remove(QLatin1Char('[')).remove(QLatin1Char(']'));
-        } else if(currentFieldName == QLatin1String("keyword")) {
-          // LT values are comma-separated
-          value.replace(QLatin1String(","), FieldFormat::delimiterString());
-        } else if(currentFieldName == QLatin1String("cdate")) {
-          // only want date, not time. 10 characters since it's zero-padded
-          value.truncate(10);
-        }
+      if(plan.stripBrackets) {
+        value.remove(QLatin1Char('[')).remove(QLatin1Char(']'));
+      } else if(plan.splitCommas) {
+        value.replace(QLatin1String(","), FieldFormat::delimiterString());
+      } else if(plan.dateOnly) {
+        value.truncate(10);
       }
-      if(fieldType == Data::Field::Image) {
+      if(plan.isImage) {
         // try to import as a absolute or relative link
         // follow same logic as in CollectionHandler::end(..)
         QUrl u(value);
@@ -186,37 +240,41 @@ Tellico::Data::CollPtr CSVImporter::collection() {
                                          QUrl() /* referrer */,
                                          m_imageLinksOnly);
         }
-      } else if(fieldType == Data::Field::Date ||
-                m_coll->fieldByName(currentFieldName)->formatType() == FieldFormat::FormatDate) {
+      } else if(plan.isDate) {
         // allow for '/' in addition to '-' for ISO date format
         value.replace(QLatin1Char('/'), QLatin1Char('-'));
       }
-      bool success = entry->setField(currentFieldName, value);
+      bool success = entry->setField(plan.field, value);
       // we might need to add a new allowed value
       // assume that if the user is importing the value, it should be allowed
-      if(!success && fieldType == Data::Field::Choice) {
-        Data::FieldPtr f = m_coll->fieldByName(currentFieldName);
+      if(!success && plan.isChoice) {
         StringSet allow;
-        allow.add(f->allowed());
+        allow.add(plan.field->allowed());
         allow.add(value);
-        f->setAllowed(allow.values());
-        m_coll->modifyField(f);
-        success = entry->setField(currentFieldName, value);
+        plan.field->setAllowed(allow.values());
+        m_coll->modifyField(plan.field);
+        success = entry->setField(plan.field, value);
       }
       if(empty && success) {
         empty = false;
       }
-      j += value.size();
     }
     if(!empty) {
-      m_coll->addEntries(entry);
+      batch += entry;
     }
 
-    if(showProgress && j%stepSize == 0) {
-      Q_EMIT signalProgress(this, 100*j/numChars);
-      qApp->processEvents();
+    if(batch.size() >= CSV_IMPORT_BATCH_SIZE) {
+      m_coll->addEntries(batch);
+      batch.clear();
+      if(showProgress) {
+        Q_EMIT signalProgress(this, 100*m_parser->position()/numBytes);
+        qApp->processEvents();
+      }
     }
   }
+  if(!batch.isEmpty()) {
+    m_coll->addEntries(batch);
+  }
 
   {
     KConfigGroup config(KSharedConfig::openConfig(), QStringLiteral("ImportOptions - CSV"));
@@ -459,12 +517,42 @@ void CSVImporter::setRowDelimiter(const QString& delimiter_) {
   m_rowDelimiter = delimiter_;
 }
 
+void CSVImporter::openFile() {
+  m_fileRef = FileHandler::fileRef(url());
+  if(!m_fileRef->open()) {
+    return;
+  }
+  QIODevice* device = m_fileRef->file();
+  const QByteArray head = device->peek(3);
+  if(head.startsWith("\xEF\xBB\xBF")) {
+    // skip the UTF-8 byte order mark
+    m_dataOffset = 3;
+  } else if(head.startsWith("\xFF\xFE") || head.startsWith("\xFE\xFF")) {
+    // libcsv only handles 8-bit text, so UTF-16 files are decoded up front
+    QTextStream stream(device);
+    setText(Tellico::removeControlCodes(stream.readAll()));
+  }
+}
+
+void CSVImporter::resetParser() {
+  if(!m_fileRef && text().isEmpty() && !url().isEmpty()) {
+    openFile();
+  }
+  if(text().isEmpty() && m_fileRef && m_fileRef->isValid()) {
+    QIODevice* device = m_fileRef->file();
+    device->seek(m_dataOffset);
+    m_parser->reset(device);
+  } else {
+    m_parser->reset(text());
+  }
+}
+
 void CSVImporter::fillTable() {
   if(!m_table) {
     return;
   }
 
-  m_parser->reset(text());
+  resetParser();
   // not skipping first row since the updateHeader() call depends on it
 
   int maxCols = 0;
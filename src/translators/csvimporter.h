@@ -27,6 +27,7 @@
 
 #include "textimporter.h"
 #include "../datavectors.h"
+#include "../core/filehandler.h"
 
 class CSVImporterWidget;
 
@@ -96,6 +97,8 @@ private Q_SLOTS:
   void slotSetColumnTitle();
 
 private:
+  void openFile();
+  void resetParser();
   void fillTable();
   void updateHeader();
   void createCollection();
@@ -132,6 +135,9 @@ private:
   bool m_imageLinksOnly;
 
   CSVParser* m_parser;
+  // the file is parsed straight from disk, rather than being read into a string first
+  FileHandler::FileRef* m_fileRef;
+  qint64 m_dataOffset;
 };
 
   } // end namespace
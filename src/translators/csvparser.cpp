@@ -24,7 +24,7 @@
 
 #include "csvparser.h"
 
-#include <QTextStream>
+#include <QIODevice>
 #include <QStringList>
 
 #include <config.h>
@@ -45,29 +45,72 @@ static int isSpace(unsigned char c);
 static int isSpaceOrTab(unsigned char c);
 static int isTab(unsigned char c);
 
+namespace {
+  static const qint64 CSV_CHUNK_SIZE = 64 * 1024;
+}
+
 using Tellico::CSVParser;
 
 class CSVParser::Private {
 public:
-  Private() : stream(nullptr), done(false) {
+  Private() : device(nullptr), pos(0), finished(true) {
     csv_init(&parser, 0);
   }
   ~Private() {
     csv_free(&parser);
-    delete stream;
   }
 
+  void restart();
+  void fill(CSVParser* p);
+
   struct csv_parser parser;
-  QString str;
-  QTextStream* stream;
+  // text sources are converted to UTF-8 once, device sources are read a chunk at a time
+  QByteArray data;
+  QIODevice* device;
+  qint64 pos;
   QStringList tokens;
-  bool done;
+  QList<QStringList> rows;
+  bool finished;
 };
 
+void CSVParser::Private::restart() {
+  // discard any partially parsed row from a previous source
+  csv_fini(&parser, nullptr, nullptr, nullptr);
+  tokens.clear();
+  rows.clear();
+  pos = 0;
+  finished = false;
+}
+
+// parse from the source until at least one complete row is available or there is nothing left
+void CSVParser::Private::fill(CSVParser* p) {
+  while(rows.isEmpty() && !finished) {
+    QByteArray chunk;
+    if(device) {
+      chunk = device->read(CSV_CHUNK_SIZE);
+    } else if(pos < data.size()) {
+      const qint64 len = qMin(CSV_CHUNK_SIZE, qint64(data.size()) - pos);
+      chunk = QByteArray::fromRawData(data.constData() + pos, len);
+    }
+    if(chunk.isEmpty()) {
+      // flushes the last row, even without a trailing newline
+      csv_fini(&parser, &writeToken, &writeRow, p);
+      finished = true;
+      break;
+    }
+    pos += chunk.size();
+    csv_parse(&parser, chunk.constData(), chunk.size(), &writeToken, &writeRow, p);
+  }
+}
+
 CSVParser::CSVParser(QString str) : d(new Private()) {
   reset(str);
 }
 
+CSVParser::CSVParser(QIODevice* device) : d(new Private()) {
+  reset(device);
+}
+
 CSVParser::~CSVParser() {
   delete d;
 }
@@ -81,17 +124,46 @@ void CSVParser::setDelimiter(const QString& s) {
 }
 
 void CSVParser::reset(QString str) {
-  delete d->stream;
-  d->str = str;
-  d->stream = new QTextStream(&d->str);
+  d->restart();
+  d->device = nullptr;
+  d->data = str.toUtf8();
+}
+
+void CSVParser::reset(QIODevice* device) {
+  d->restart();
+  d->device = device;
+  d->data.clear();
+  if(!device || !device->isReadable()) {
+    d->device = nullptr;
+    d->finished = true;
+  }
 }
 
 bool CSVParser::hasNext() const {
-  return !d->stream->atEnd();
+  d->fill(const_cast<CSVParser*>(this));
+  return !d->rows.isEmpty();
 }
 
 void CSVParser::skipLine() {
-  d->stream->readLine();
+  // only meaningful before any row has been parsed, which is how the header row gets skipped
+  if(!d->rows.isEmpty()) {
+    d->rows.removeFirst();
+    return;
+  }
+  if(d->device) {
+    d->pos += d->device->readLine().size();
+  } else {
+    const qint64 idx = d->data.indexOf('\n', d->pos);
+    d->pos = idx < 0 ? d->data.size() : idx + 1;
+  }
+}
+
+qint64 CSVParser::position() const {
+  return d->pos;
+}
+
+qint64 CSVParser::size() const {
+  return d->device ? d->device->size() : d->data.size();
 }
 
 void CSVParser::addToken(const QString& t) {
@@ -99,18 +171,18 @@ void CSVParser::addToken(const QString& t) {
 }
 
 void CSVParser::setRowDone(bool b) {
-  d->done = b;
+  if(b) {
+    d->rows.append(std::move(d->tokens));
+    d->tokens.clear();
+  }
 }
 
 QStringList CSVParser::nextTokens() {
-  d->tokens.clear();
-  d->done = false;
-  while(hasNext() && !d->done) {
-    QByteArray line = d->stream->readLine().toUtf8() + '\n'; // need the eol char
-    csv_parse(&d->parser, line.constData(), line.length(), &writeToken, &writeRow, this);
+  d->fill(this);
+  if(d->rows.isEmpty()) {
+    return QStringList();
   }
-  csv_fini(&d->parser, &writeToken, &writeRow, this);
-  return d->tokens;
+  return d->rows.takeFirst();
 }
 
 static void writeToken(void* buffer, size_t len, void* data) {
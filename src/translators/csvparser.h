@@ -27,17 +27,37 @@
 
 #include <QString>
 
+class QIODevice;
+
 namespace Tellico {
 
+/**
+ * The CSVParser class feeds text to libcsv in chunks and returns the parsed rows one at a time.
+ * When reading from a device, only a single chunk of the file is held in memory.
+ */
 class CSVParser {
 public:
   CSVParser(QString str);
+  CSVParser(QIODevice* device);
   ~CSVParser();
 
   void setDelimiter(const QString& s);
   void reset(QString str);
+  /**
+   * Starts reading from the current position of the device. The device must remain open
+   * for as long as rows are being read, and the parser does not take ownership of it.
+   */
+  void reset(QIODevice* device);
   bool hasNext() const;
   void skipLine();
+  /**
+   * @return The number of bytes of the source which have been read so far
+   */
+  qint64 position() const;
+  /**
+   * @return The total number of bytes in the source, or -1 if unknown
+   */
+  qint64 size() const;
 
   void addToken(const QString& t);
   void setRowDone(bool b);
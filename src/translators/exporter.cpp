@@ -24,8 +24,21 @@
 
 #include "exporter.h"
 #include "../collection.h"
+#include "../readonlycollection.h"
 #include "../tellico_debug.h"
 
+#include <QtConcurrentRun>
+#include <QThreadPool>
+#include <QFuture>
+#include <QQueue>
+
+#include <memory>
+
+namespace {
+  // the number of entries formatted by each worker task
+  static const int EXPORT_CHUNK_SIZE = 500;
+}
+
 using Tellico::Export::Exporter;
 
 Exporter::Exporter(Tellico::Data::CollPtr coll_, const QUrl& baseUrl_)
@@ -52,3 +65,70 @@ Tellico::Data::CollPtr Exporter::collection() const {
 const Tellico::Data::FieldList& Exporter::fields() const {
   return m_fields.isEmpty() ? collection()->fields() : m_fields;
 }
+
+Tellico::Data::FieldList Exporter::fields(const Tellico::Data::ReadOnlyCollection& snapshot_) const {
+  Data::FieldList fields;
+  foreach(Data::FieldPtr field, this->fields()) {
+    Data::FieldPtr snapshotField = snapshot_.fieldByName(field->name());
+    if(snapshotField) {
+      fields << snapshotField;
+    }
+  }
+  return fields;
+}
+
+std::function<QString()> Exporter::formatEntries(const Tellico::Data::ReadOnlyCollection& snapshot_,
+                                                 const Tellico::Data::EntryList& entries_,
+                                                 const std::function<QString(const Tellico::Data::ReadOnlyEntry&)>& formatEntry_) {
+  struct ChunkQueue {
+    QList<Data::ReadOnlyEntry> entries;
+    std::function<QString(const Data::ReadOnlyEntry&)> formatEntry;
+    qsizetype next = 0;
+    QQueue<QFuture<QString>> running;
+
+    ~ChunkQueue() {
+      // the writer might have stopped early, but the tasks still reference the format function
+      for(auto& future : running) {
+        future.waitForFinished();
+      }
+    }
+
+    void startChunk() {
+      const QList<Data::ReadOnlyEntry> chunk = entries.mid(next, EXPORT_CHUNK_SIZE);
+      next += chunk.size();
+      running.enqueue(QtConcurrent::run([](const QList<Data::ReadOnlyEntry>& chunk_,
+                                           const std::function<QString(const Data::ReadOnlyEntry&)>& format_) {
+        QString text;
+        for(const auto& entry : chunk_) {
+          text += format_(entry);
+        }
+        return text;
+      }, chunk, formatEntry));
+    }
+  };
+
+  auto queue = std::make_shared<ChunkQueue>();
+  queue->entries.reserve(entries_.count());
+  foreach(Data::EntryPtr entry, entries_) {
+    queue->entries << snapshot_.entryById(entry->id());
+  }
+  queue->formatEntry = formatEntry_;
+  // keep every thread busy while the main thread writes, without formatting too far ahead
+  const int maxRunning = 2 * qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+
+  return [queue, maxRunning]() -> QString {
+    Q_FOREVER {
+      while(queue->running.size() < maxRunning && queue->next < queue->entries.size()) {
+        queue->startChunk();
+      }
+      if(queue->running.isEmpty()) {
+        return QString();
+      }
+      // a null string ends the text, so skip any chunk where nothing was formatted
+      const QString text = queue->running.dequeue().result();
+      if(!text.isEmpty()) {
+        return text;
+      }
+    }
+  };
+}
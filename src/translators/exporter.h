@@ -34,12 +34,18 @@
 
 #include <QUrl>
 
+#include <functional>
+
 class KConfig;
 
 class QWidget;
 class QString;
 
 namespace Tellico {
+  namespace Data {
+    class ReadOnlyCollection;
+    class ReadOnlyEntry;
+  }
   namespace Export {
     enum Options {
       ExportFormatted     = 1 << 0,   // format entries when exported
@@ -94,6 +100,30 @@ public:
   virtual void readOptions(KSharedConfigPtr) {}
   virtual void saveOptions(KSharedConfigPtr) {}
 
+protected:
+  /**
+   * Formats the entries on worker threads, a chunk of entries at a time, and returns a function
+   * which yields the formatted chunks in the same order as the entries, followed by a null string.
+   * Only a few chunks are queued at once, so the result can be streamed out with
+   * FileHandler::writeTextURL without the whole text ever being in memory.
+   *
+   * The workers only read a snapshot of the collection, since formatting an @ref Entry
+   * caches the formatted values in it.
+   *
+   * @param snapshot A snapshot of the collection holding the entries
+   * @param entries The entries to format
+   * @param formatEntry The function formatting a single entry from the snapshot, which must be
+   *                    safe to call from any thread
+   */
+  /**
+   * Returns the fields to export, the same as @ref fields, but taken from a snapshot of the
+   * collection so they may be read from any thread.
+   */
+  Data::FieldList fields(const Data::ReadOnlyCollection& snapshot) const;
+  static std::function<QString()> formatEntries(const Data::ReadOnlyCollection& snapshot,
+                                                const Data::EntryList& entries,
+                                                const std::function<QString(const Data::ReadOnlyEntry&)>& formatEntry);
+
 private:
   long m_options;
   Data::CollPtr m_coll;
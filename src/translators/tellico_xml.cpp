@@ -189,3 +189,38 @@ QByteArray Tellico::XML::recoverFromBadXMLName(const QByteArray& data_) {
   }
   return newData;
 }
+
+bool Tellico::XML::findEntryRange(const QByteArray& data_, qsizetype& begin_, qsizetype& end_) {
+  static const QByteArray entryStart("<entry");
+  static const QByteArray entryEnd("</entry>");
+
+  // only the current syntax is handled, where the entries follow the <fields> element
+  const qsizetype fieldsEnd = data_.indexOf("</fields>");
+  if(fieldsEnd < 0) {
+    return false;
+  }
+  // a field named "entry" would have elements nested within the entry elements
+  // and CDATA sections could hide element markup, neither is written by Tellico itself
+  if(data_.lastIndexOf("name=\"entry\"", fieldsEnd) > -1 || data_.contains("<![CDATA[")) {
+    return false;
+  }
+  qsizetype begin = fieldsEnd;
+  while(true) {
+    begin = data_.indexOf(entryStart, begin);
+    if(begin < 0 || begin + entryStart.size() >= data_.size()) {
+      return false;
+    }
+    const char c = data_.at(begin + entryStart.size());
+    if(c == ' ' || c == '>') {
+      break;
+    }
+    begin += entryStart.size();
+  }
+  const qsizetype end = data_.lastIndexOf(entryEnd);
+  if(end < begin) {
+    return false;
+  }
+  begin_ = begin;
+  end_ = end + entryEnd.size();
+  return true;
+}
@@ -50,6 +50,11 @@ namespace Tellico {
     bool validXMLElementName(const QString& name);
     QString elementName(const QString& name);
     QByteArray recoverFromBadXMLName(const QByteArray& data);
+    /**
+     * Finds the run of <entry> elements in a Tellico document, from the start of the first
+     * entry to the end of the last one. Returns false if the document can't be split that way.
+     */
+    bool findEntryRange(const QByteArray& data, qsizetype& begin, qsizetype& end);
   }
 }
 
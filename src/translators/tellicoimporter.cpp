@@ -25,6 +25,7 @@
 #include "tellicoimporter.h"
 #include "tellicoxmlreader.h"
 #include "tellico_xml.h"
+#include "collectionsnapshot.h"
 #include "../images/imagefactory.h"
 #include "../core/tellico_strings.h"
 #include "../utils/guiproxy.h"
@@ -37,11 +38,37 @@
 #include <QBuffer>
 #include <QFile>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QApplication>
 #include <QPointer>
+#include <QThread>
+#include <QEventLoop>
+#include <QFutureWatcher>
+#include <QtConcurrentRun>
 
 namespace {
   static const int MIN_BLOCK_SIZE = 100*1024; // minimum read size of 100 kB
+  static const int PARALLEL_MIN_SIZE = 4*1024*1024; // smaller documents are read serially
+
+  struct EntryChunk {
+    Tellico::Data::EntryList entries;
+    bool success = false;
+  };
+
+  // reads the document header, followed by a run of complete entry elements. The collection
+  // element is never closed, so the entries don't get added to the reader's own collection
+  EntryChunk readEntryChunk(const QByteArray& data_, qsizetype headSize_, qsizetype begin_, qsizetype end_, const QUrl& baseUrl_) {
+    Tellico::Import::TellicoXmlReader reader(baseUrl_);
+    reader.setLoadImages(false);
+    EntryChunk chunk;
+    chunk.success = reader.readNext(QByteArray::fromRawData(data_.constData(), headSize_)) &&
+                    reader.readNext(QByteArray::fromRawData(data_.constData() + begin_, end_ - begin_));
+    if(chunk.success) {
+      reader.fixupISBNValues();
+      chunk.entries = reader.entries();
+    }
+    return chunk;
+  }
 }
 
 using Tellico::Import::TellicoImporter;
@@ -91,26 +118,43 @@ Tellico::Data::CollPtr TellicoImporter::collection() {
   return thisPtr ? m_coll : Data::CollPtr();
 }
 
+std::unique_ptr<Tellico::Import::TellicoXmlReader> TellicoImporter::newReader(bool loadImages_) const {
+  auto reader = std::make_unique<TellicoXmlReader>(m_baseUrl);
+  reader->setLoadImages(loadImages_);
+  reader->setShowImageLoadErrors(options() & ImportShowImageErrors);
+  reader->setImagePathsAsLinks(options() & ImportImagesAsLinks);
+  return reader;
+}
+
 void TellicoImporter::loadXMLData(const QByteArray& data_, bool loadImages_) {
   const bool showProgress = options() & ImportProgress;
 
-  TellicoXmlReader reader(m_baseUrl);
-  reader.setLoadImages(loadImages_);
-  reader.setShowImageLoadErrors(options() & ImportShowImageErrors);
-  reader.setImagePathsAsLinks(options() & ImportImagesAsLinks);
+  std::unique_ptr<TellicoXmlReader> reader = newReader(loadImages_);
   bool success = true;
 
   const int blockSize = qMax(data_.size()/100 + 1, MIN_BLOCK_SIZE);
-  int pos = 0;
+  qsizetype pos = 0;
   Q_EMIT signalTotalSteps(this, data_.size());
 
   // hack to allow processEvents
   QPointer<TellicoImporter> thisPtr(this);
+  if(data_.size() > PARALLEL_MIN_SIZE && QThread::idealThreadCount() > 1) {
+    pos = readEntriesInParallel(*reader, data_);
+    if(!thisPtr) {
+      return;
+    }
+    if(pos < 0) {
+      // something failed after the reader was already fed some data, start over
+      myDebug() << "Parallel reading failed. Reading the XML data serially.";
+      reader = newReader(loadImages_);
+      pos = 0;
+    }
+  }
   while(thisPtr && success && !m_cancelled && pos < data_.size()) {
-    const uint size = qMin(blockSize, data_.size() - pos);
+    const uint size = qMin(qsizetype(blockSize), data_.size() - pos);
     const QByteArray block = QByteArray::fromRawData(data_.data() + pos, size);
-    success = reader.readNext(block);
-    if(!success && reader.isNotWellFormed()) {
+    success = reader->readNext(block);
+    if(!success && reader->isNotWellFormed()) {
       // could be bug 418067 where version of Tellico < 3.3 could use invalid XML names
       // try to recover. If it's not a bad field name, this should be a pretty quick check
       myDebug() << "XML parsing failed. Attempting to recover.";
@@ -142,7 +186,7 @@ void TellicoImporter::loadXMLData(const QByteArray& data_, bool loadImages_) {
     if(!url().isEmpty()) {
       error = TC_I18N2(errorLoad, url().fileName());
     }
-    const QString errorString = reader.errorString();
+    const QString errorString = reader->errorString();
     if(!errorString.isEmpty()) {
       error += QStringLiteral("\n") + errorString;
     }
@@ -152,11 +196,82 @@ void TellicoImporter::loadXMLData(const QByteArray& data_, bool loadImages_) {
   }
 
   if(!m_cancelled) {
-    m_hasImages = reader.hasImages();
-    m_coll = reader.collection();
+    m_hasImages = reader->hasImages();
+    m_coll = reader->collection();
   }
 }
 
+// Large documents are mostly entry elements, and creating the entries is where the time goes.
+// The <entry> elements are split into ranges which are read on worker threads, each range behind
+// its own copy of the document header so the fields are known. The entries are then added to
+// the main reader in document order and the rest of the document is read as usual.
+// Returns the position where serial reading should continue, zero if the document could not be
+// split, or -1 if the reader has been fed data but reading failed.
+qsizetype TellicoImporter::readEntriesInParallel(TellicoXmlReader& reader_, const QByteArray& data_) {
+  static const QByteArray entryEnd("</entry>");
+
+  qsizetype headSize, tailStart;
+  if(!XML::findEntryRange(data_, headSize, tailStart)) {
+    return 0;
+  }
+
+  // several chunks per thread keeps all the threads busy when entry sizes vary
+  const qsizetype chunkSize = qMax(qsizetype(MIN_BLOCK_SIZE),
+                                   (tailStart - headSize) / (4*QThread::idealThreadCount()));
+  QList<qsizetype> bounds;
+  bounds << headSize;
+  while(true) {
+    qsizetype next = data_.indexOf(entryEnd, bounds.last() + chunkSize);
+    if(next < 0) {
+      break;
+    }
+    next += entryEnd.size();
+    if(next >= tailStart) {
+      break;
+    }
+    bounds << next;
+  }
+  bounds << tailStart;
+
+  // the header creates the collection in the main reader
+  if(!reader_.readNext(QByteArray::fromRawData(data_.constData(), headSize)) || !reader_.collection()) {
+    return -1;
+  }
+
+  QList<QFuture<EntryChunk>> futures;
+  for(int i = 1; i < bounds.size(); ++i) {
+    futures << QtConcurrent::run(readEntryChunk, data_, headSize, bounds.at(i-1), bounds.at(i), m_baseUrl);
+  }
+
+  const bool showProgress = options() & ImportProgress;
+  QFutureWatcher<EntryChunk> watcher;
+  QEventLoop loop;
+  connect(&watcher, &QFutureWatcherBase::finished, &loop, &QEventLoop::quit);
+
+  // hack to allow processEvents
+  QPointer<TellicoImporter> thisPtr(this);
+  for(int i = 0; i < futures.size(); ++i) {
+    // keep the UI responsive while waiting on the next chunk in order
+    if(showProgress && !futures.at(i).isFinished()) {
+      watcher.setFuture(futures.at(i));
+      loop.exec();
+    }
+    if(!thisPtr || m_cancelled) {
+      // any remaining chunks just get discarded when done
+      return data_.size();
+    }
+    const EntryChunk chunk = futures.at(i).result();
+    if(!chunk.success) {
+      return -1;
+    }
+    reader_.addEntries(chunk.entries);
+    if(showProgress) {
+      Q_EMIT signalProgress(this, bounds.at(i+1));
+    }
+  }
+  return tailStart;
+}
+
 void TellicoImporter::loadZipData() {
   std::unique_ptr<KZip> zip;
   std::unique_ptr<QBuffer> buffer;
@@ -195,10 +310,13 @@ void TellicoImporter::loadZipData() {
     return;
   }
 
-  const QByteArray xmlData = static_cast<const KArchiveFile*>(entry)->data();
   // hack to account for processEvents and deletion
   QPointer<TellicoImporter> thisPtr(this);
-  loadXMLData(xmlData, false);
+  // a snapshot from when the file was saved avoids reading all the entry elements
+  if(!loadSnapshot()) {
+    const QByteArray xmlData = static_cast<const KArchiveFile*>(entry)->data();
+    loadXMLData(xmlData, false);
+  }
   if(!thisPtr) {
     return;
   }
@@ -231,18 +349,25 @@ void TellicoImporter::loadZipData() {
     return;
   }
 
+  // the zip archive can only be read from this thread, but the images get decoded in parallel,
+  // a batch at a time so only so much of the compressed data is held in memory
   const QStringList images = m_imgDir->entries();
-  const uint stepSize = qMax(s_stepSize, static_cast<uint>(images.count())/100);
+  const int batchSize = qMax(static_cast<int>(s_stepSize), 4*QThread::idealThreadCount());
 
-  uint j = 0;
-  for(QStringList::ConstIterator it = images.begin(); !m_cancelled && it != images.end(); ++it, ++j) {
+  QList<ImageFactory::ImageData> batch;
+  for(QStringList::ConstIterator it = images.begin(); !m_cancelled && it != images.end(); ++it) {
     const KArchiveEntry* file = m_imgDir->entry(*it);
     if(file && file->isFile()) {
-      ImageFactory::addImage(static_cast<const KArchiveFile*>(file)->data(),
-                             (*it).section(QLatin1Char('.'), -1).toUpper(), (*it));
+      batch << ImageFactory::ImageData{static_cast<const KArchiveFile*>(file)->data(),
+                                       (*it).section(QLatin1Char('.'), -1).toUpper(), (*it)};
       m_images.remove(*it);
     }
-    if(j%stepSize == 0) {
+    if(batch.size() >= batchSize || std::next(it) == images.end()) {
+      ImageFactory::addImages(batch);
+      batch.clear();
+      if(!thisPtr) {
+        return;
+      }
       qApp->processEvents();
     }
   }
@@ -253,6 +378,23 @@ void TellicoImporter::loadZipData() {
   }
 }
 
+bool TellicoImporter::loadSnapshot() {
+  if(!url().isLocalFile() || !CollectionSnapshot::isEnabled()) {
+    return false;
+  }
+  QElapsedTimer timer;
+  timer.start();
+  CollectionSnapshot snapshot(url().toLocalFile());
+  std::unique_ptr<TellicoXmlReader> reader = newReader(false);
+  if(!snapshot.read(*reader) || !reader->collection()) {
+    return false;
+  }
+  myLog() << "Read snapshot for" << url().fileName() << "in" << timer.elapsed() << "ms";
+  m_hasImages = reader->hasImages();
+  m_coll = reader->collection();
+  return true;
+}
+
 bool TellicoImporter::hasImages() const {
   return m_hasImages;
 }
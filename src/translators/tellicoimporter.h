@@ -39,6 +39,7 @@ class KArchiveDirectory;
 
 namespace Tellico {
   namespace Import {
+    class TellicoXmlReader;
 
 /**
  * @author Robby Stephenson
@@ -89,8 +90,11 @@ public Q_SLOTS:
   void slotCancel() override;
 
 private:
+  std::unique_ptr<TellicoXmlReader> newReader(bool loadImages) const;
   void loadXMLData(const QByteArray& data, bool loadImages);
+  qsizetype readEntriesInParallel(TellicoXmlReader& reader, const QByteArray& data);
   void loadZipData();
+  bool loadSnapshot();
 
   Data::CollPtr m_coll;
   bool m_loadAllImages;
@@ -99,6 +99,25 @@ bool TellicoXmlReader::hasImages() const {
   return m_data->hasImages;
 }
 
+Tellico::Data::EntryList TellicoXmlReader::entries() const {
+  return m_data->entries;
+}
+
+void TellicoXmlReader::addEntries(const Data::EntryList& entries_) {
+  Q_ASSERT(m_data->coll);
+  foreach(Data::EntryPtr entry, entries_) {
+    // changing the collection resets the id
+    const Data::ID id = entry->id();
+    entry->setCollection(m_data->coll);
+    entry->setId(id);
+    m_data->entries.append(entry);
+  }
+}
+
+void TellicoXmlReader::fixupISBNValues() {
+  m_data->fixupISBNValues();
+}
+
 void TellicoXmlReader::setLoadImages(bool loadImages_) {
   m_data->loadImages = loadImages_;
 }
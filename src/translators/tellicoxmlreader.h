@@ -45,6 +45,22 @@ public:
   Data::CollPtr collection() const;
   bool hasImages() const;
 
+  /**
+   * Returns the entries read so far, which are only added to the collection
+   * once the end of the collection element is reached.
+   */
+  Data::EntryList entries() const;
+  /**
+   * Adopts entries read by a different reader, keeping their ids. Used when
+   * the entry elements are split out and read separately.
+   */
+  void addEntries(const Data::EntryList& entries);
+  /**
+   * Fixes up the ISBN values of the entries read so far. That normally happens at the end
+   * of the collection element, which a reader of split out entries never reaches.
+   */
+  void fixupISBNValues();
+
   void setLoadImages(bool loadImages);
   void setShowImageLoadErrors(bool showImageErrors);
   void setImagePathsAsLinks(bool imagePathsAsLinks);
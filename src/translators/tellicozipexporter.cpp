@@ -24,6 +24,7 @@
 
 #include "tellicozipexporter.h"
 #include "tellicoxmlexporter.h"
+#include "collectionsnapshot.h"
 #include "../collection.h"
 #include "../images/imagefactory.h"
 #include "../images/image.h"
@@ -38,6 +39,7 @@
 #include <QDomDocument>
 #include <QBuffer>
 #include <QApplication>
+#include <QThreadPool>
 
 using namespace Tellico;
 using Tellico::Export::TellicoZipExporter;
@@ -145,7 +147,15 @@ bool TellicoZipExporter::exec() {
     return true;
   }
 
-  return FileHandler::writeDataURL(url(), data, options() & Export::ExportForce);
+  const bool success = FileHandler::writeDataURL(url(), data, options() & Export::ExportForce);
+  if(success && url().isLocalFile() && CollectionSnapshot::isEnabled()) {
+    // reading the entries for the snapshot takes a while, so don't hold up the save
+    const QString fileName = url().toLocalFile();
+    QThreadPool::globalInstance()->start([fileName, data, xml]() {
+      CollectionSnapshot(fileName).write(data, xml);
+    });
+  }
+  return success;
 }
 
 void TellicoZipExporter::slotCancel() {
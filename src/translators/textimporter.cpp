@@ -29,8 +29,12 @@
 using Tellico::Import::TextImporter;
 
 TextImporter::TextImporter(const QUrl& url_, bool useUTF8_)
+    : TextImporter(url_, useUTF8_, true) {
+}
+
+TextImporter::TextImporter(const QUrl& url_, bool useUTF8_, bool readText_)
     : Import::Importer(url_) {
-  if(url_.isValid()) {
+  if(readText_ && url_.isValid()) {
     // remove C0 Control Characters, since we assume we're importing a file
     // with contents that will be represented in XML later...
     setText(Tellico::removeControlCodes(FileHandler::readTextFile(url_, false, useUTF8_)));
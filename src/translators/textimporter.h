@@ -46,6 +46,17 @@ public:
    */
   explicit TextImporter(const QUrl& url, bool useUTF8_=false);
   explicit TextImporter(const QString& text);
+
+protected:
+  /**
+   * Importers which read the file contents themselves, a chunk at a time, can skip
+   * reading the whole file in the constructor.
+   *
+   * @param url The file to be imported
+   * @param useUTF8_ Whether the file is read as UTF-8
+   * @param readText Whether the contents of the file are read
+   */
+  TextImporter(const QUrl& url, bool useUTF8_, bool readText);
 };
 
   } // end namespace
@@ -62,6 +62,7 @@ QString realFieldName(int syntaxVersion, QStringView localName) {
 
 }
 
+using Tellico::Import::SAX::StateData;
 using Tellico::Import::SAX::StateHandler;
 using Tellico::Import::SAX::NullHandler;
 using Tellico::Import::SAX::RootHandler;
@@ -174,11 +175,30 @@ bool CollectionHandler::start(QStringView, QStringView, const QXmlStreamAttribut
   return true;
 }
 
+void StateData::fixupISBNValues() {
+  if(isbnFixups.isEmpty()) {
+    return;
+  }
+  QStringList values;
+  values.reserve(isbnFixups.count());
+  for(const auto& fixup : std::as_const(isbnFixups)) {
+    values += fixup.first->field(fixup.second);
+  }
+  ISBNValidator::fixupValues(values);
+  for(int i = 0; i < values.count(); ++i) {
+    const auto& fixup = isbnFixups.at(i);
+    // no need to update the modified date when setting the entry's field value
+    fixup.first->setField(fixup.second, values.at(i), false /* no modified date update */);
+  }
+  isbnFixups.clear();
+}
+
 bool CollectionHandler::end(QStringView, QStringView) {
   if(!d->coll) {
     myWarning() << "no collection created";
     return false;
   }
+  d->fixupISBNValues();
   d->coll->addEntries(d->entries);
 
   // a little hidden capability was to just have a local path as an image file name
@@ -643,8 +663,11 @@ bool FieldValueHandler::end(QStringView, QStringView localName_) {
   }
   // special case for isbn fields, go ahead and validate
   if(m_validateISBN) {
-    ISBNValidator val(nullptr);
-    val.fixup(fieldValue);
+    // a field with multiple values only needs to be listed once
+    const auto fixup = qMakePair(entry, fieldName);
+    if(d->isbnFixups.isEmpty() || d->isbnFixups.last() != fixup) {
+      d->isbnFixups.append(fixup);
+    }
   }
   if(f->type() == Data::Field::Table) {
     QString oldValue = entry->field(fieldName);
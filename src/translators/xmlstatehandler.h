@@ -57,7 +57,11 @@ public:
   bool hasImages;
   bool showImageLoadErrors;
   bool imagePathsAsLinks;
+  // the isbn values are fixed up all at once, before the entries are added to the collection
+  QList<QPair<Data::EntryPtr, QString>> isbnFixups;
   QUrl baseUrl;
+
+  void fixupISBNValues();
 };
 
 class StateHandler {
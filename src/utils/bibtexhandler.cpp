@@ -122,6 +122,12 @@ QString BibtexHandler::bibtexKey(const QString& author_, const QString& title_,
   return key.remove(s_badKeyChars);
 }
 
+void BibtexHandler::initTranslationMaps() {
+  if(s_utf8LatexMap.isEmpty()) {
+    loadTranslationMaps();
+  }
+}
+
 void BibtexHandler::loadTranslationMaps() {
   QString mapfile = DataFileRegistry::self()->locate(QStringLiteral("bibtex-translation.xml"));
   if(mapfile.isEmpty()) {
@@ -154,9 +160,7 @@ void BibtexHandler::loadTranslationMaps() {
 QString BibtexHandler::importText(char* text_) {
   QString str = QString::fromUtf8(text_);
 
-  if(s_utf8LatexMap.isEmpty()) {
-    loadTranslationMaps();
-  }
+  initTranslationMaps();
 
   for(StringListHash::ConstIterator it = s_utf8LatexMap.constBegin(); it != s_utf8LatexMap.constEnd(); ++it) {
     foreach(const QString& word, it.value()) {
@@ -176,9 +180,7 @@ QString BibtexHandler::importText(char* text_) {
 }
 
 QString BibtexHandler::exportText(const QString& text_, const QStringList& macros_) {
-  if(s_utf8LatexMap.isEmpty()) {
-    loadTranslationMaps();
-  }
+  initTranslationMaps();
 
   QChar lquote, rquote;
   switch(s_quoteStyle) {
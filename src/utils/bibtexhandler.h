@@ -50,6 +50,11 @@ public:
    * @return A reference to the text
    */
   static QString& cleanText(QString& text);
+  /**
+   * Loads the LaTeX translation maps, unless they are already loaded. Since the maps are
+   * otherwise loaded on first use, call this before exporting text from other threads.
+   */
+  static void initTranslationMaps();
 
   static QuoteStyle s_quoteStyle;
 
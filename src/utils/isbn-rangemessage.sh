@@ -14,8 +14,6 @@ echo "// Date:          $(grep -m1 '<MessageDate>' "${fFileInp}"|sed -r 's/^[^>]
 echo "// Generated by:  Alex Oio"
 echo "//--------------------------------------:--------------------------------------:"
 echo
-echo "ISBNValidator::isbn_band* ISBNValidator::bands;"
-echo
 
 # read -p 'continua ...' xxxx
 
@@ -29,6 +29,19 @@
 #include <QStringList>
 #include <QRegularExpression>
 
+#include <algorithm>
+
+namespace {
+  // the fixup functions get called for every value in an import, so avoid regular expressions
+  inline bool isDigit(QChar c) {
+    return c.unicode() >= '0' && c.unicode() <= '9';
+  }
+
+  qsizetype countDigits(const QString& input_) {
+    return std::count_if(input_.cbegin(), input_.cend(), isDigit);
+  }
+}
+
 using Tellico::ISBNValidator;
 
 //static
@@ -95,8 +108,9 @@ QStringList ISBNValidator::listDifference(const QStringList& list1_, const QStri
 }
 
 QString ISBNValidator::cleanValue(QString isbn) {
-  static const QRegularExpression badChars(QStringLiteral("[^xX0123456789]"));
-  isbn.remove(badChars);
+  isbn.removeIf([](QChar c) {
+    return !isDigit(c) && c != QLatin1Char('x') && c != QLatin1Char('X');
+  });
   return isbn;
 }
 
@@ -192,16 +206,33 @@ void ISBNValidator::fixup(QString& input_) const {
 }
 
 void ISBNValidator::staticFixup(QString& input_) {
-  static const QRegularExpression digits(QStringLiteral("\\d"));
   if((input_.startsWith(QLatin1StringView("978"))
        || input_.startsWith(QLatin1StringView("979")))
-     && input_.count(digits) > 10) {
+     && countDigits(input_) > 10) {
     fixup13(input_);
   } else {
     fixup10(input_);
   }
 }
 
+void ISBNValidator::fixupValues(QStringList& values_) {
+  const QString delimiter = FieldFormat::delimiterString();
+  for(QString& value : values_) {
+    if(value.isEmpty()) {
+      continue;
+    }
+    if(!value.contains(delimiter)) {
+      staticFixup(value);
+      continue;
+    }
+    QStringList isbns = FieldFormat::splitValue(value);
+    for(QString& isbn : isbns) {
+      staticFixup(isbn);
+    }
+    value = isbns.join(delimiter);
+  }
+}
+
 QValidator::State ISBNValidator::validate10(QString& input_, int& pos_) const {
   int len = input_.length();
 
@@ -224,8 +255,7 @@ QValidator::State ISBNValidator::validate10(QString& input_, int& pos_) const {
 
   // fix the case where the user attempts to delete the checksum; the
   // solution is to delete the last digit as well
-  static const QRegularExpression digit(QStringLiteral("\\d"));
-  if(atEnd && input_.count(digit) == 9 && input_[len-1] == QLatin1Char('-')) {
+  if(atEnd && countDigits(input_) == 9 && input_[len-1] == QLatin1Char('-')) {
     input_.truncate(len-2);
     pos_ -= 2;
   }
@@ -291,8 +321,7 @@ QValidator::State ISBNValidator::validate13(QString& input_, int& pos_) const {
 
   // fix the case where the user attempts to delete the checksum; the
   // solution is to delete the last digit as well
-  static const QRegularExpression digit(QStringLiteral("\\d"));
-  const uint countN = input_.count(digit);
+  const uint countN = countDigits(input_);
   if(atEnd && (countN == 12 || countN == 9) && input_[len-1] == QLatin1Char('-')) {
     input_.truncate(len-2);
     pos_ -= 2;
@@ -346,8 +375,7 @@ void ISBNValidator::fixup10(QString& input_) {
   input_.replace(QLatin1Char('x'), QLatin1Char('X'));
 
   // remove invalid chars
-  static const QRegularExpression badChars(QStringLiteral("[^\\d\\-X]"));
-  input_.remove(badChars);
+  input_.removeIf([](QChar c) { return !isDigit(c) && c != QLatin1Char('-') && c != QLatin1Char('X'); });
 
   // hyphen placement for some languages publishers is well-defined
   // remove all hyphens, and insert them ourselves
@@ -391,21 +419,16 @@ void ISBNValidator::fixup10(QString& input_) {
   ulong range = input_.leftJustified(9, QLatin1Char('0'), true).toULong();
 
   // range for ISBN begins by 978
-  bands = bands978;
-  // now find which band the range falls in
-  int band = 0;
-  while(range >= bands[band].MaxValue) {
-    ++band;
-  }
+  const isbn_band& band = findBand(false, range);
 
   // if we have space to put the first hyphen, do it
-  if(input_.length() > bands[band].First && bands[band].First > 0) {
-    input_.insert(bands[band].First, QLatin1Char('-'));
+  if(input_.length() > band.First && band.First > 0) {
+    input_.insert(band.First, QLatin1Char('-'));
   }
 
   //add 1 since one "-" character has already been inserted
-  if(bands[band].Mid != 0) {
-    hyphen2_position = bands[band].Mid;
+  if(band.Mid != 0) {
+    hyphen2_position = band.Mid;
     if(static_cast<int>(input_.length()) > (hyphen2_position + 1)) {
       input_.insert(hyphen2_position + 1, QLatin1Char('-'));
     }
@@ -415,8 +438,8 @@ void ISBNValidator::fixup10(QString& input_) {
   }
 
   // add a "-" before the checkdigit and another one if the middle "-" exists
-  const int trueLast = bands[band].Last +
-                       (bands[band].First > 0 ? 1 : 0) +
+  const int trueLast = band.Last +
+                       (band.First > 0 ? 1 : 0) +
                        (hyphen2_position > 0 ? 1 : 0);
   if(input_.length() > trueLast) {
     input_.insert(trueLast, QLatin1Char('-'));
@@ -431,8 +454,7 @@ void ISBNValidator::fixup13(QString& input_) {
   }
 
   // remove invalid chars
-  static const QRegularExpression badChars(QStringLiteral("[^\\d-]"));
-  input_.remove(badChars);
+  input_.removeIf([](QChar c) { return !isDigit(c) && c != QLatin1Char('-'); });
 
   // hyphen placement for some languages publishers is well-defined
   // remove all hyphens, and insert them ourselves
@@ -469,25 +491,16 @@ void ISBNValidator::fixup13(QString& input_) {
   ulong range = after.leftJustified(9, QLatin1Char('0'), true).toULong();
 
   // range for ISBN 13 beginning with 979 is different than those for 978
-  if(input_.startsWith(QLatin1StringView("979"))) {
-    bands = bands979;
-  } else {
-    bands = bands978;
-  }
-  // now find which band the range falls in
-  int band = 0;
-  while(range >= bands[band].MaxValue) {
-    ++band;
-  }
+  const isbn_band& band = findBand(input_.startsWith(QLatin1StringView("979")), range);
 
   // if we have space to put the first hyphen, do it
-  if(after.length() > bands[band].First && bands[band].First > 0) {
-    after.insert(bands[band].First, QLatin1Char('-'));
+  if(after.length() > band.First && band.First > 0) {
+    after.insert(band.First, QLatin1Char('-'));
   }
 
   //add 1 since one "-" has already been inserted
-  if(bands[band].Mid != 0) {
-    hyphen2_position = bands[band].Mid;
+  if(band.Mid != 0) {
+    hyphen2_position = band.Mid;
     if(static_cast<int>(after.length()) > (hyphen2_position + 1)) {
       after.insert(hyphen2_position + 1, QLatin1Char('-'));
     }
@@ -497,8 +510,8 @@ void ISBNValidator::fixup13(QString& input_) {
   }
 
   // add a "-" before the checkdigit and another one if the middle "-" exists
-  int trueLast = bands[band].Last +
-                 (bands[band].First > 0 ? 1 : 0) +
+  int trueLast = band.Last +
+                 (band.First > 0 ? 1 : 0) +
                  (hyphen2_position > 0 ? 1 : 0);
   if(after.length() > trueLast) {
     after.insert(trueLast, QLatin1Char('-'));
@@ -523,7 +536,7 @@ QChar ISBNValidator::checkSum10(const QString& input_) {
   } else if(sum == 11) {
     c = QLatin1Char('0');
   } else {
-    c = QString::number(sum)[0];
+    c = QLatin1Char(static_cast<char>('0' + sum));
   }
   return c;
 }
@@ -544,7 +557,7 @@ QChar ISBNValidator::checkSum13(const QString& input_) {
   if(sum == 10) {
     c = QLatin1Char('0');
   } else {
-    c = QString::number(sum)[0];
+    c = QLatin1Char(static_cast<char>('0' + sum));
   }
   return c;
 }
@@ -582,6 +595,16 @@ QChar ISBNValidator::checkSum13(const QString& input_) {
 
 #include "isbnvalidator_range.h"
 
+// the bands are sorted by their maximum value, so the band for a range is the first one
+// with a greater maximum. Anything beyond the end of the table uses the last band
+const ISBNValidator::isbn_band& ISBNValidator::findBand(bool is979_, ulong range_) {
+  const isbn_band* first = is979_ ? std::begin(bands979) : std::begin(bands978);
+  const isbn_band* last = is979_ ? std::end(bands979) : std::end(bands978);
+  const isbn_band* band = std::upper_bound(first, last, range_,
+                                           [](ulong range, const isbn_band& b) { return range < b.MaxValue; });
+  return band == last ? *(last - 1) : *band;
+}
+
 bool Tellico::ISBNComparison::operator()(const QString& value1_, const QString& value2_) const {
   QString value1 = ISBNValidator::cleanValue(value1_).toUpper();
   QString value2 = ISBNValidator::cleanValue(value2_).toUpper();
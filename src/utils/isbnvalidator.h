@@ -134,6 +134,13 @@ public:
   static void staticFixup(QString& input);
   static void fixup10(QString& input);
   static void fixup13(QString& input);
+  /**
+   * Fixes up a whole list of values at once, such as every ISBN in a large import.
+   * Each value may hold several ISBN values, separated by the usual delimiter.
+   *
+   * @param values The raw strings, which are replaced by the fixed values
+   */
+  static void fixupValues(QStringList& values);
 
   static QString isbn10(QString isbn13);
   static QString isbn13(QString isbn10);
@@ -150,7 +157,7 @@ private:
   };
   static isbn_band bands978[];
   static isbn_band bands979[];
-  static isbn_band* bands; // switches between 978 and 979
+  static const isbn_band& findBand(bool is979, ulong range);
 
   QValidator::State validateSingle(QString& input, int& pos) const;
   QValidator::State validate10(QString& input, int& pos) const;
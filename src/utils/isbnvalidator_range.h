@@ -8,8 +8,6 @@
 // Generated by:  Alex Oio
 //--------------------------------------:--------------------------------------:
 
-ISBNValidator::isbn_band* ISBNValidator::bands;
-
 //--------------------------------------:--------------------------------------:
 ISBNValidator::isbn_band ISBNValidator::bands978[] = {
 //--------------------------------------: English language (978-0)
@@ -33,8 +33,11 @@
 #include <QStringConverter>
 #include <QVariant>
 #include <QCache>
+#include <QMutex>
 #include <QRandomGenerator>
 
+#include <array>
+
 namespace {
   static const int STRING_STORE_SIZE = 4999; // too big, too small?
 
@@ -145,7 +148,8 @@ int Tellico::stringHash(const QString& str) {
 }
 
 QString Tellico::shareString(const QString& str) {
-  static QString stringStore[STRING_STORE_SIZE];
+  // each thread keeps its own store, since entries may be created on worker threads
+  thread_local static QString stringStore[STRING_STORE_SIZE];
 
   const int hash = stringHash(str) % STRING_STORE_SIZE;
   if(stringStore[hash] != str) {
@@ -166,26 +170,93 @@ QString Tellico::fromHtmlData(const QByteArray& data_, const char* codecName) {
   return decoder.decode(data_);
 }
 
+namespace {
+  // the combining diacritical marks are removed from the decomposed strings
+  inline bool isCombiningMark(char16_t c) {
+    return c >= 0x0300 && c <= 0x036F;
+  }
+
+  // Latin characters, through Latin Extended-B, only decompose into an ASCII or Latin base
+  // character followed by combining diacritical marks, so they can be folded one at a time
+  static const char16_t FOLD_TABLE_END = 0x0250;
+
+  const QString* foldTable() {
+    static const auto table = [] {
+      std::array<QString, FOLD_TABLE_END> t;
+      for(char16_t c = 0; c < FOLD_TABLE_END; ++c) {
+        QString folded = QString(QChar(c)).normalized(QString::NormalizationForm_D);
+        folded.removeIf([](QChar ch) { return isCombiningMark(ch.unicode()); });
+        t[c] = folded;
+      }
+      return t;
+    }();
+    return table.data();
+  }
+
+  // everything else gets decomposed as a whole, and since that's comparatively slow, the results
+  // are cached. The cache is split into shards, each with its own lock, so the worker threads
+  // reading or filtering entries rarely wait on each other
+  static const int ACCENT_CACHE_SHARDS = 16;
+
+  class AccentCache {
+  public:
+    AccentCache() {
+      for(auto& shard : m_shards) {
+        shard.cache.setMaxCost(STRING_STORE_SIZE / ACCENT_CACHE_SHARDS);
+      }
+    }
+    QString fold(const QString& value) {
+      Shard& shard = m_shards[qHash(value) % ACCENT_CACHE_SHARDS];
+      {
+        QMutexLocker locker(&shard.mutex);
+        const QString* cached = shard.cache.object(value);
+        if(cached) {
+          return *cached;
+        }
+      }
+      // remove accents from table "Combining Diacritical Marks"
+      QString folded = value.normalized(QString::NormalizationForm_D);
+      folded.removeIf([](QChar ch) { return isCombiningMark(ch.unicode()); });
+      QMutexLocker locker(&shard.mutex);
+      shard.cache.insert(value, new QString(folded));
+      return folded;
+    }
+
+  private:
+    struct Shard {
+      QMutex mutex;
+      QCache<QString, QString> cache;
+    };
+    Shard m_shards[ACCENT_CACHE_SHARDS];
+  };
+}
+
 QString Tellico::removeAccents(const QString& value_) {
-  static QCache<QString, QString> stringCache(STRING_STORE_SIZE);
-  if(stringCache.contains(value_)) {
-    return *stringCache.object(value_);
-  }
-  static QRegularExpression rx;
-  if(rx.pattern().isEmpty()) {
-    QString pattern(QStringLiteral("(?:"));
-    for(int i = 0x0300; i <= 0x036F; ++i) {
-      pattern += QChar(i) + QLatin1Char('|');
+  // most values are plain ASCII, which never changes
+  const char16_t* data = reinterpret_cast<const char16_t*>(value_.constData());
+  const qsizetype length = value_.length();
+  qsizetype pos = 0;
+  while(pos < length && data[pos] < 0x80) {
+    ++pos;
+  }
+  if(pos == length) {
+    return value_;
+  }
+
+  const QString* table = foldTable();
+  QString folded;
+  folded.reserve(length);
+  folded.append(QStringView(data, pos));
+  for( ; pos < length; ++pos) {
+    const char16_t c = data[pos];
+    if(c < FOLD_TABLE_END) {
+      folded.append(table[c]);
+    } else if(!isCombiningMark(c)) {
+      static AccentCache cache;
+      return cache.fold(value_);
     }
-    pattern.chop(1);
-    pattern += QLatin1Char(')');
-    rx.setPattern(pattern);
-    rx.optimize();
-  }
-  // remove accents from table "Combining Diacritical Marks"
-  const QString value2 = value_.normalized(QString::NormalizationForm_D).remove(rx);
-  stringCache.insert(value_, new QString(value2));
-  return value2;
+  }
+  return folded;
 }
 
 QByteArray Tellico::obfuscate(const QString& string) {